@@ -0,0 +1,87 @@
+#include "../WndDesign/WndDesign.h"
+#include "../WndDesign/wnd/FlowLayout.h"
+#include "../WndDesign/message/timer.h"
+
+#include <vector>
+#include <chrono>
+
+
+using namespace WndDesign;
+
+
+// Lays out 100k tag chips while sweeping the width of the window every frame,
+//   and shows the time spent in reflow and redraw queues on the title.
+
+class Chip : public WndObject {
+private:
+	Size size;
+	Color color;
+public:
+	Chip(uint number) : size(30 + number * 7 % 50, 20), color(number % 2 ? ColorSet::DarkGreen : ColorSet::Goldenrod) {}
+private:
+	virtual const Rect UpdateRegionOnParent(Size parent_size) override { return Rect(point_zero, size); }
+	virtual void OnPaint(FigureQueue& figure_queue, Rect accessible_region, Rect invalid_region) const override {
+		figure_queue.Append(point_zero, new Rectangle(accessible_region.size, color, 0.0f, color_transparent));
+	}
+};
+
+
+class MainWnd : public FlowLayout {
+private:
+	struct Style : FlowLayout::Style {
+		Style() {
+			width.normal(800px);
+			height.normal(600px);
+			position.setHorizontalCenter().setVerticalCenter();
+			border.width(5).color(ColorSet::DarkGreen);
+			background.setColor(ColorSet::LightGray);
+			spacing.item(4).line(4);
+		}
+	};
+private:
+	static constexpr uint chip_number = 100000, min_width = 400, max_width = 1200, width_step = 10;
+private:
+	std::vector<std::unique_ptr<Chip>> chips;
+	uint width = 800; int step = width_step;
+	Timer timer = Timer([&]() { OnFrame(); });
+	wstring title;
+public:
+	MainWnd() : FlowLayout(make_style<Style>()) {
+		chips.reserve(chip_number);
+		std::vector<ref_ptr<WndObject>> children; children.reserve(chip_number);
+		for (uint i = 0; i < chip_number; ++i) {
+			chips.push_back(std::make_unique<Chip>(i));
+			children.push_back(chips.back().get());
+		}
+		AppendChildren(children);
+		timer.Set(16);
+	}
+	~MainWnd() {}
+private:
+	virtual const wstring GetTitle() const override { return title; }
+private:
+	void OnFrame() {
+		if (width + step > max_width || width + step < min_width) { step = -step; }
+		width += step;
+		ModifyStyle().width.normal(px(width));
+		RegionOnParentChanged();
+		auto begin = std::chrono::steady_clock::now();
+		desktop.CommitReflowQueue();
+		auto reflowed = std::chrono::steady_clock::now();
+		desktop.CommitRedrawQueue();
+		auto redrawn = std::chrono::steady_clock::now();
+		using std::chrono::microseconds, std::chrono::duration_cast;
+		title = L"Width: " + std::to_wstring(width) + L", " +
+			L"Reflow: " + std::to_wstring(duration_cast<microseconds>(reflowed - begin).count()) + L"us, " +
+			L"Redraw: " + std::to_wstring(duration_cast<microseconds>(redrawn - reflowed).count()) + L"us";
+		TitleChanged();
+	}
+};
+
+
+int main() {
+	MainWnd main_wnd;
+	desktop.AddChild(main_wnd);
+	desktop.MessageLoop();
+	return 0;
+}
\ No newline at end of file
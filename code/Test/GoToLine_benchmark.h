@@ -0,0 +1,76 @@
+#include "../WndDesign/WndDesign.h"
+#include "../WndDesign/wnd/EditBox.h"
+#include "../WndDesign/message/timer.h"
+
+#include <random>
+#include <chrono>
+
+
+using namespace WndDesign;
+
+
+// Goes to a random line of a log with 1M lines every frame, and shows the time to find the lines of random text 
+//   positions and the time to go to the line and scroll it into view on the title.
+
+class MainWnd : public EditBox {
+private:
+	struct Style : EditBox::Style {
+		Style() {
+			width.normal(800px);
+			height.normal(600px);
+			position.setHorizontalCenter().setVerticalCenter();
+			border.width(5).color(ColorSet::DarkGreen);
+			background.setColor(ColorSet::White);
+			padding.setAll(10px);
+			font.family(L"Consolas").size(16);
+			paragraph.word_wrap(WordWrap::NoWrap);
+		}
+	};
+private:
+	static constexpr uint line_number = 1000000, queries_per_frame = 1000;
+private:
+	std::mt19937 random = std::mt19937(0);
+	Timer timer = Timer([&]() { OnFrame(); });
+	wstring title;
+private:
+	static wstring GetLog() {
+		wstring text;
+		for (uint line = 0; line < line_number; ++line) {
+			text += L"[" + std::to_wstring(line) + L"] INFO request handled, status 200\n";
+		}
+		return text;
+	}
+public:
+	MainWnd() : EditBox(make_style<Style>(), GetLog()) {
+		SetVirtualLayout(true);
+		SetMonospaceLayout(true);
+		timer.Set(16);
+	}
+	~MainWnd() {}
+private:
+	virtual const wstring GetTitle() const override { return title; }
+private:
+	void OnFrame() {
+		const TextBlock& text_block = GetTextBlock();
+		std::uniform_int_distribution<uint> position(0, GetText().GetLength()), line(0, line_number - 1);
+		using std::chrono::steady_clock, std::chrono::nanoseconds, std::chrono::microseconds, std::chrono::duration_cast;
+		auto begin = steady_clock::now();
+		for (uint i = 0; i < queries_per_frame; ++i) { text_block.GetParagraphIndex(position(random)); }
+		auto queried = steady_clock::now();
+		GoToParagraph(line(random));
+		desktop.CommitReflowQueue();
+		desktop.CommitRedrawQueue();
+		auto gone = steady_clock::now();
+		title = L"Line of position: " + std::to_wstring(duration_cast<nanoseconds>(queried - begin).count() / queries_per_frame) + L"ns, " +
+			L"Go to line: " + std::to_wstring(duration_cast<microseconds>(gone - queried).count()) + L"us";
+		TitleChanged();
+	}
+};
+
+
+int main() {
+	MainWnd main_wnd;
+	desktop.AddChild(main_wnd);
+	desktop.MessageLoop();
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,87 @@
+#include "../WndDesign/WndDesign.h"
+#include "../WndDesign/wnd/ListLayout.h"
+#include "../WndDesign/wnd/TextBox.h"
+#include "../WndDesign/figure/text_layout_cache.h"
+
+#include <vector>
+#include <chrono>
+
+
+using namespace WndDesign;
+
+
+// Constructs a list of 10k labels with 10 distinct texts and lays them out, either sharing the shaped layouts
+//   of the same texts or shaping each label separately, and shows the time on the title.
+
+class Label : public TextBox {
+public:
+	struct Style : TextBox::Style {
+		Style() {
+			width.max(100pct);
+			border.width(1).color(ColorSet::DarkGreen);
+			padding.set(5px, 2px, 5px, 2px);
+			background.setColor(ColorSet::Honeydew);
+			font.size(16);
+		}
+	};
+public:
+	Label(uint number) : TextBox(GetSharedStyle<Style>(), L"Item " + std::to_wstring(number % 10)) {}
+};
+
+
+class MainWnd : public ListLayout {
+private:
+	struct Style : ListLayout::Style {
+		Style() {
+			width.max(70pct);
+			height.max(80pct);
+			position.setHorizontalCenter().setVerticalCenter();
+			border.width(5).color(ColorSet::DarkGreen);
+			background.setColor(ColorSet::LightGray);
+			gridline.width(1);
+		}
+	};
+private:
+	static constexpr uint label_number = 10000;
+	static constexpr bool share_layout = true;
+private:
+	std::vector<std::unique_ptr<Label>> labels;
+	std::chrono::steady_clock::duration construct_time;
+	wstring title;
+public:
+	MainWnd() : ListLayout(make_style<Style>()) {
+		if (!share_layout) { SetTextLayoutCacheCapacity(0); }
+		auto begin = std::chrono::steady_clock::now();
+		std::vector<ref_ptr<WndObject>> children; children.reserve(label_number);
+		labels.reserve(label_number);
+		for (uint i = 0; i < label_number; ++i) {
+			labels.push_back(std::make_unique<Label>(i));
+			children.push_back(labels.back().get());
+		}
+		AppendChildren(children);
+		construct_time = std::chrono::steady_clock::now() - begin;
+	}
+	~MainWnd() {}
+private:
+	virtual const wstring GetTitle() const override { return title; }
+public:
+	void Show() {
+		desktop.AddChild(*this);
+		auto begin = std::chrono::steady_clock::now();
+		desktop.CommitReflowQueue();
+		auto reflowed = std::chrono::steady_clock::now();
+		using std::chrono::milliseconds, std::chrono::duration_cast;
+		title = wstring(share_layout ? L"Shared" : L"Unique") + L" layouts, " +
+			L"Construct: " + std::to_wstring(duration_cast<milliseconds>(construct_time).count()) + L"ms, " +
+			L"Reflow: " + std::to_wstring(duration_cast<milliseconds>(reflowed - begin).count()) + L"ms";
+		TitleChanged();
+	}
+};
+
+
+int main() {
+	MainWnd main_wnd;
+	main_wnd.Show();
+	desktop.MessageLoop();
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,63 @@
+#include "../WndDesign/WndDesign.h"
+#include "../WndDesign/wnd/EditBox.h"
+
+#include <chrono>
+
+
+using namespace WndDesign;
+
+
+// Shows a 50 MB log in a read-only edit box with virtual layout, and the time to first paint on the title,
+//   which doesn't grow with the size of the log because only the paragraphs in the cached region are laid out.
+
+class MainWnd : public EditBox {
+private:
+	struct Style : EditBox::Style {
+		Style() {
+			width.normal(800px);
+			height.normal(600px);
+			position.setHorizontalCenter().setVerticalCenter();
+			border.width(5).color(ColorSet::DarkGreen);
+			background.setColor(ColorSet::White);
+			padding.setAll(10px);
+			font.size(16);
+			edit.disable_edit();
+		}
+	};
+private:
+	static constexpr uint log_size = 50 * 1024 * 1024;
+private:
+	wstring title;
+public:
+	static wstring GetLog() {
+		wstring text; text.reserve(log_size / sizeof(wchar));
+		for (uint line = 0; text.length() < log_size / sizeof(wchar); ++line) {
+			text += L"[" + std::to_wstring(line) + L"] INFO request handled, status 200, ";
+			text += wstring(line % 7 * 20, L'.');  // some lines are long enough to wrap
+			text += L'\n';
+		}
+		return text;
+	}
+public:
+	MainWnd(wstring text) : EditBox(make_style<Style>(), std::move(text)) { SetVirtualLayout(true); }
+	~MainWnd() {}
+public:
+	void SetTitle(wstring title) { this->title = std::move(title); TitleChanged(); }
+private:
+	virtual const wstring GetTitle() const override { return title; }
+};
+
+
+int main() {
+	using std::chrono::steady_clock, std::chrono::milliseconds, std::chrono::duration_cast;
+	wstring text = MainWnd::GetLog();
+	auto begin = steady_clock::now();
+	MainWnd main_wnd(std::move(text));
+	desktop.AddChild(main_wnd);
+	desktop.CommitReflowQueue();
+	desktop.CommitRedrawQueue();
+	auto painted = steady_clock::now();
+	main_wnd.SetTitle(L"Time to first paint: " + std::to_wstring(duration_cast<milliseconds>(painted - begin).count()) + L"ms");
+	desktop.MessageLoop();
+	return 0;
+}
\ No newline at end of file
@@ -19,7 +19,7 @@ private:
 		}
 	};
 public:
-	MainWnd() : ListLayout(std::make_unique<Style>()) { 
+	MainWnd() : ListLayout(make_style<Style>()) { 
 		//AllocateLayer(); 
 	}
 };
@@ -38,7 +38,7 @@ private:
 		}
 	};
 public:
-	TextArea(): EditBox(std::make_unique<Style>(), L"Type something here...") {
+	TextArea(): EditBox(make_style<Style>(), L"Type something here...") {
 		//AllocateLayer();
 	}
 };
@@ -0,0 +1,91 @@
+#include "../WndDesign/WndDesign.h"
+#include "../WndDesign/wnd/ListLayout.h"
+#include "../WndDesign/message/timer.h"
+
+#include <vector>
+#include <deque>
+#include <chrono>
+
+
+using namespace WndDesign;
+
+
+// Prepends rows to a list of 100k rows every frame like a streaming log, erases rows at the end,
+//   and shows the time spent in row operations and in reflow and redraw queues on the title.
+
+class Cell : public WndObject {
+public:
+	static constexpr uint height = 20;
+private:
+	Color color;
+public:
+	Cell(uint number) : color(number % 2 ? ColorSet::DarkGreen : ColorSet::Goldenrod) {}
+private:
+	virtual const Rect UpdateRegionOnParent(Size parent_size) override { return Rect(0, 0, parent_size.width, height); }
+	virtual void OnPaint(FigureQueue& figure_queue, Rect accessible_region, Rect invalid_region) const override {
+		figure_queue.Append(point_zero, new Rectangle(accessible_region.size, color, 0.0f, color_transparent));
+	}
+};
+
+
+class MainWnd : public ListLayout {
+private:
+	struct Style : ListLayout::Style {
+		Style() {
+			width.max(70pct);
+			height.max(80pct);
+			position.setHorizontalCenter().setVerticalCenter();
+			border.width(5).color(ColorSet::DarkGreen);
+			background.setColor(ColorSet::LightGray);
+			gridline.width(1);
+		}
+	};
+private:
+	static constexpr uint row_number = 100000, rows_per_frame = 10;
+private:
+	std::deque<std::unique_ptr<Cell>> cells;
+	uint cell_number = 0;
+	Timer timer = Timer([&]() { OnFrame(); });
+	wstring title;
+public:
+	MainWnd() : ListLayout(make_style<Style>()) {
+		std::vector<ref_ptr<WndObject>> children; children.reserve(row_number);
+		for (uint i = 0; i < row_number; ++i) {
+			cells.push_back(std::make_unique<Cell>(cell_number++));
+			children.push_back(cells.back().get());
+		}
+		AppendChildren(children);
+		timer.Set(16);
+	}
+	~MainWnd() {}
+private:
+	virtual const wstring GetTitle() const override { return title; }
+private:
+	void OnFrame() {
+		auto begin = std::chrono::steady_clock::now();
+		std::vector<ref_ptr<WndObject>> children;
+		for (uint i = 0; i < rows_per_frame; ++i) {
+			cells.push_front(std::make_unique<Cell>(cell_number++));
+			children.insert(children.begin(), cells.front().get());
+		}
+		InsertChildren(children, 0);
+		EraseRow(row_number, rows_per_frame);
+		cells.resize(row_number);
+		auto changed = std::chrono::steady_clock::now();
+		desktop.CommitReflowQueue();
+		desktop.CommitRedrawQueue();
+		auto committed = std::chrono::steady_clock::now();
+		using std::chrono::microseconds, std::chrono::duration_cast;
+		title = L"Prepend: " + std::to_wstring(duration_cast<microseconds>(changed - begin).count()) + L"us, " +
+			L"Commit: " + std::to_wstring(duration_cast<microseconds>(committed - changed).count()) + L"us";
+		TitleChanged();
+	}
+};
+
+
+int main() {
+	MainWnd main_wnd;
+	desktop.AddChild(main_wnd);
+	desktop.MessageLoop();
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,75 @@
+#include "../WndDesign/WndDesign.h"
+#include "../WndDesign/wnd/EditBox.h"
+#include "../WndDesign/message/timer.h"
+
+#include <random>
+#include <chrono>
+
+
+using namespace WndDesign;
+
+
+// Hit tests random points and text positions of a code file with 100k lines in a monospace font every frame, as for 
+//   caret moves and drag selection, either with the cell metrics or with the text layouts, and shows the time per 
+//   hit test on the title.
+
+class MainWnd : public EditBox {
+private:
+	struct Style : EditBox::Style {
+		Style() {
+			width.normal(800px);
+			height.normal(600px);
+			position.setHorizontalCenter().setVerticalCenter();
+			border.width(5).color(ColorSet::DarkGreen);
+			background.setColor(ColorSet::White);
+			padding.setAll(10px);
+			font.family(L"Consolas").size(16);
+			paragraph.word_wrap(WordWrap::NoWrap);
+		}
+	};
+private:
+	static constexpr uint line_number = 100000, hit_tests_per_frame = 1000;
+	static constexpr bool monospace = true;
+private:
+	std::mt19937 random = std::mt19937(0);
+	Timer timer = Timer([&]() { OnFrame(); });
+	wstring title;
+private:
+	static wstring GetCode() {
+		wstring text;
+		for (uint line = 0; line < line_number; ++line) {
+			text += wstring(line % 4, L'\t') + L"int value_" + std::to_wstring(line) + L" = compute(" + std::to_wstring(line % 97) + L");\n";
+		}
+		return text;
+	}
+public:
+	MainWnd() : EditBox(make_style<Style>(), GetCode()) { SetMonospaceLayout(monospace); timer.Set(16); }
+	~MainWnd() {}
+private:
+	virtual const wstring GetTitle() const override { return title; }
+private:
+	void OnFrame() {
+		const TextBlock& text_block = GetTextBlock();
+		Size size = text_block.GetSize();
+		std::uniform_int_distribution<int> x(0, (int)size.width), y(0, (int)size.height);
+		std::uniform_int_distribution<uint> position(0, GetText().GetLength());
+		using std::chrono::steady_clock, std::chrono::nanoseconds, std::chrono::duration_cast;
+		auto begin = steady_clock::now();
+		for (uint i = 0; i < hit_tests_per_frame; ++i) { text_block.HitTestPoint(Point(x(random), y(random))); }
+		auto point_tested = steady_clock::now();
+		for (uint i = 0; i < hit_tests_per_frame; ++i) { text_block.HitTestTextPosition(position(random)); }
+		auto position_tested = steady_clock::now();
+		title = wstring(monospace ? L"Monospace" : L"Text") + L" layout, " +
+			L"Point: " + std::to_wstring(duration_cast<nanoseconds>(point_tested - begin).count() / hit_tests_per_frame) + L"ns, " +
+			L"Position: " + std::to_wstring(duration_cast<nanoseconds>(position_tested - point_tested).count() / hit_tests_per_frame) + L"ns";
+		TitleChanged();
+	}
+};
+
+
+int main() {
+	MainWnd main_wnd;
+	desktop.AddChild(main_wnd);
+	desktop.MessageLoop();
+	return 0;
+}
\ No newline at end of file
@@ -19,7 +19,7 @@ private:
 		}
 	};
 public:
-	MainWnd() : OverlapLayout(std::make_unique<Style>()) {
+	MainWnd() : OverlapLayout(make_style<Style>()) {
 		//AllocateLayer();
 	}
 	~MainWnd() {}
@@ -43,7 +43,7 @@ private:
 		}
 	};
 public:
-	MyTextBox() : TextBox(std::make_unique<Style>(), wstring(text)) { 
+	MyTextBox() : TextBox(make_style<Style>(), wstring(text)) { 
 		//AllocateLayer();
 	}
 	~MyTextBox() {}
@@ -0,0 +1,93 @@
+#include "../WndDesign/WndDesign.h"
+#include "../WndDesign/wnd/OverlapLayout.h"
+#include "../WndDesign/message/timer.h"
+
+#include <vector>
+#include <random>
+#include <chrono>
+
+
+using namespace WndDesign;
+
+
+// Moves some of 10k overlapping cards every frame and hit tests random points,
+//   and shows the time spent in hit testing and in reflow and redraw queues on the title.
+
+class Card : public WndObject {
+private:
+	Rect region;
+	Color color;
+	CompositeEffect composite;
+public:
+	Card(Rect region, Color color, bool mouse_penetrate) : region(region), color(color) { composite._mouse_penetrate = mouse_penetrate; }
+private:
+	virtual const Rect UpdateRegionOnParent(Size parent_size) override { return region; }
+	virtual const CompositeEffect GetCompositeEffect() const override { return composite; }
+	virtual void OnPaint(FigureQueue& figure_queue, Rect accessible_region, Rect invalid_region) const override {
+		figure_queue.Append(point_zero, new Rectangle(accessible_region.size, color, 1.0f, ColorSet::Black));
+	}
+public:
+	void Move(Vector offset) { region.point = region.point + offset; WndObject::UpdateRegionOnParent(); }
+};
+
+
+class MainWnd : public OverlapLayout {
+private:
+	struct Style : OverlapLayout::Style {
+		Style() {
+			width.normal(1000px);
+			height.normal(700px);
+			position.setHorizontalCenter().setVerticalCenter();
+			border.width(5).color(ColorSet::DarkGreen);
+			background.setColor(ColorSet::LightGray);
+		}
+	};
+private:
+	static constexpr uint card_number = 10000, moving_card_number = 100, hit_test_number = 10000;
+private:
+	std::vector<std::unique_ptr<Card>> cards;
+	std::mt19937 random = std::mt19937(0);
+	Timer timer = Timer([&]() { OnFrame(); });
+	wstring title;
+public:
+	MainWnd() : OverlapLayout(make_style<Style>()) {
+		std::uniform_int_distribution<int> position(0, 960), size(10, 40);
+		for (uint i = 0; i < card_number; ++i) {
+			Rect region(position(random), position(random) * 2 / 3, size(random), size(random));
+			cards.push_back(std::make_unique<Card>(region, i % 2 ? ColorSet::DarkGreen : ColorSet::Goldenrod, i % 7 == 0));
+			AddChild(*cards.back());
+		}
+		timer.Set(16);
+	}
+	~MainWnd() {}
+private:
+	virtual const wstring GetTitle() const override { return title; }
+private:
+	void OnFrame() {
+		std::uniform_int_distribution<uint> card(0, card_number - 1);
+		std::uniform_int_distribution<int> offset(-3, 3), x(0, 999), y(0, 699);
+		auto begin = std::chrono::steady_clock::now();
+		uint hit_number = 0;
+		for (uint i = 0; i < hit_test_number; ++i) {
+			if (ClientHitTest(GetClientSize(), Point(x(random), y(random))).child != nullptr) { hit_number++; }
+		}
+		auto hit_tested = std::chrono::steady_clock::now();
+		for (uint i = 0; i < moving_card_number; ++i) { cards[card(random)]->Move(Vector(offset(random), offset(random))); }
+		desktop.CommitReflowQueue();
+		desktop.CommitRedrawQueue();
+		auto committed = std::chrono::steady_clock::now();
+		using std::chrono::microseconds, std::chrono::duration_cast;
+		title = L"Hit test: " + std::to_wstring(duration_cast<microseconds>(hit_tested - begin).count()) + L"us " +
+			L"(" + std::to_wstring(hit_number) + L" hits), " +
+			L"Commit: " + std::to_wstring(duration_cast<microseconds>(committed - hit_tested).count()) + L"us";
+		TitleChanged();
+	}
+};
+
+
+int main() {
+	MainWnd main_wnd;
+	desktop.AddChild(main_wnd);
+	desktop.MessageLoop();
+	return 0;
+}
\ No newline at end of file
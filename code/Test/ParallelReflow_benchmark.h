@@ -0,0 +1,106 @@
+#include "../WndDesign/WndDesign.h"
+#include "../WndDesign/wnd/ListLayout.h"
+#include "../WndDesign/wnd/TextBox.h"
+#include "../WndDesign/message/timer.h"
+
+#include <vector>
+#include <chrono>
+
+
+using namespace WndDesign;
+
+
+// Resets the text of 1k text boxes every second, and shows the time spent in reflow queue on the title.
+// Right click to switch between serial and parallel reflow.
+
+class MainWnd : public ListLayout {
+private:
+	struct Style : ListLayout::Style {
+		Style() {
+			width.max(70pct);
+			height.max(80pct);
+			position.setHorizontalCenter().setVerticalCenter();
+			border.width(5).color(ColorSet::DarkGreen);
+			background.setColor(ColorSet::LightGray);
+			grid_height.min(20px).max(300px);
+			gridline.width(1);
+		}
+	};
+public:
+	MainWnd() : ListLayout(make_style<Style>()) {}
+
+private:
+	bool parallel = false;
+	wstring title = L"Parallel Reflow Benchmark";
+public:
+	virtual const wstring GetTitle() const override { return title; }
+	void SetTitle(wstring&& title) { this->title = std::move(title); TitleChanged(); }
+	bool IsParallel() const { return parallel; }
+private:
+	virtual void Handler(Msg msg, Para para) override {
+		ListLayout::Handler(msg, para);
+		if (msg == Msg::RightDown) { parallel = !parallel; desktop.EnableParallelReflow(parallel); }
+	}
+};
+
+
+class Cell : public TextBox {
+private:
+	struct Style : TextBox::Style {
+		Style() {
+			width.max(100pct);
+			padding.setAll(5px);
+			font.size(16);
+		}
+	};
+public:
+	Cell() : TextBox(make_style<Style>(), L"") {}
+};
+
+
+extern const wchar paragraph[];
+
+class Benchmark {
+private:
+	static constexpr uint cell_number = 1000;
+private:
+	MainWnd& main_wnd;
+	std::vector<std::unique_ptr<Cell>> cells;
+	uint round = 0;
+	Timer timer = Timer([&]() { Refresh(); });
+public:
+	Benchmark(MainWnd& main_wnd) : main_wnd(main_wnd) {
+		for (uint i = 0; i < cell_number; ++i) {
+			cells.push_back(std::make_unique<Cell>());
+			main_wnd.AppendChild(*cells.back());
+		}
+		timer.Set(1000);
+	}
+	~Benchmark() {}
+private:
+	void Refresh() {
+		round++;
+		for (uint i = 0; i < cell_number; ++i) {
+			cells[i]->SetText(std::to_wstring(round) + L"-" + std::to_wstring(i) + L": " + paragraph);
+		}
+		auto begin = std::chrono::steady_clock::now();
+		desktop.CommitReflowQueue();
+		auto end = std::chrono::steady_clock::now();
+		auto time = std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count();
+		main_wnd.SetTitle(wstring(main_wnd.IsParallel() ? L"Parallel" : L"Serial") + L" Reflow: " + std::to_wstring(time) + L"us");
+	}
+};
+
+
+int main() {
+	MainWnd main_wnd;
+	Benchmark benchmark(main_wnd);
+	desktop.AddChild(main_wnd);
+	desktop.MessageLoop();
+	return 0;
+}
+
+
+const wchar paragraph[] = L"\
+Text layout dominates the cost of reflow when many text boxes are refreshed at the same time, \
+and text boxes in different rows are independent of each other, so their layout can be calculated concurrently.";
\ No newline at end of file
@@ -0,0 +1,85 @@
+#include "../WndDesign/WndDesign.h"
+#include "../WndDesign/message/timer.h"
+
+#include <vector>
+#include <chrono>
+
+
+using namespace WndDesign;
+
+
+// Invalidates 100k windows every frame, and shows the time spent in reflow and redraw queues on the title.
+
+class Cell : public WndObject {
+public:
+	static constexpr uint size = 2;
+private:
+	Point point;
+	Color color = ColorSet::DarkGreen;
+public:
+	Cell(Point point) : point(point) {}
+private:
+	virtual const Rect UpdateRegionOnParent(Size parent_size) override { return Rect(point, Size(size, size)); }
+	virtual void OnPaint(FigureQueue& figure_queue, Rect accessible_region, Rect invalid_region) const override {
+		figure_queue.Append(point_zero, new Rectangle(accessible_region.size, color, 0.0f, color_transparent));
+	}
+public:
+	void Flip() {
+		color = color == Color(ColorSet::DarkGreen) ? ColorSet::Goldenrod : ColorSet::DarkGreen;
+		Invalidate(region_infinite);
+	}
+};
+
+
+class MainWnd : public WndObject {
+private:
+	static constexpr uint column_count = 400, row_count = 250;
+	static constexpr Rect region = Rect(100, 100, column_count * Cell::size, row_count * Cell::size);
+private:
+	std::vector<std::unique_ptr<Cell>> cells;
+	Timer timer = Timer([&]() { OnFrame(); });
+	wstring title;
+public:
+	MainWnd() {
+		cells.reserve(column_count * row_count);
+		for (uint row = 0; row < row_count; ++row) {
+			for (uint column = 0; column < column_count; ++column) {
+				cells.push_back(std::make_unique<Cell>(Point(column * Cell::size, row * Cell::size)));
+				RegisterChild(*cells.back());
+			}
+		}
+		timer.Set(16);
+	}
+	~MainWnd() {}
+private:
+	virtual const Rect UpdateRegionOnParent(Size parent_size) override { return region; }
+	virtual const pair<Size, Size> CalculateMinMaxSize(Size parent_size) override { return { region.size, region.size }; }
+	virtual const wstring GetTitle() const override { return title; }
+	virtual void OnChildRegionUpdate(WndObject& child) override { SetChildRegion(child, UpdateChildRegion(child, region.size)); }
+	virtual void OnPaint(FigureQueue& figure_queue, Rect accessible_region, Rect invalid_region) const override {
+		for (auto& cell : cells) {
+			if (!GetChildRegion(*cell).Intersect(invalid_region).IsEmpty()) { CompositeChild(*cell, figure_queue, invalid_region); }
+		}
+	}
+private:
+	void OnFrame() {
+		auto begin = std::chrono::steady_clock::now();
+		for (auto& cell : cells) { cell->Flip(); }
+		auto invalidated = std::chrono::steady_clock::now();
+		desktop.CommitReflowQueue();
+		desktop.CommitRedrawQueue();
+		auto committed = std::chrono::steady_clock::now();
+		using std::chrono::microseconds, std::chrono::duration_cast;
+		title = L"Invalidate: " + std::to_wstring(duration_cast<microseconds>(invalidated - begin).count()) + L"us, " +
+			L"Commit: " + std::to_wstring(duration_cast<microseconds>(committed - invalidated).count()) + L"us";
+		TitleChanged();
+	}
+};
+
+
+int main() {
+	MainWnd main_wnd;
+	desktop.AddChild(main_wnd);
+	desktop.MessageLoop();
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,110 @@
+#include "../WndDesign/WndDesign.h"
+#include "../WndDesign/message/timer.h"
+
+#include <vector>
+#include <chrono>
+
+
+using namespace WndDesign;
+
+
+// Scrolls a window with 500 groups of 100 cells (50k descendants) every frame,
+//   and shows the time spent in scrolling and in reflow and redraw queues on the title.
+
+class Cell : public WndObject {
+public:
+	static constexpr uint size = 8;
+private:
+	Point point;
+	Color color;
+public:
+	Cell(Point point, Color color) : point(point), color(color) {}
+private:
+	virtual const Rect UpdateRegionOnParent(Size parent_size) override { return Rect(point, Size(size, size)); }
+	virtual void OnPaint(FigureQueue& figure_queue, Rect accessible_region, Rect invalid_region) const override {
+		figure_queue.Append(point_zero, new Rectangle(accessible_region.size, color, 0.0f, color_transparent));
+	}
+};
+
+
+class Group : public WndObject {
+public:
+	static constexpr uint column_count = 50, row_count = 2;
+	static constexpr Size size = Size(column_count * Cell::size * 2, row_count * Cell::size * 2);
+private:
+	Point point;
+	std::vector<std::unique_ptr<Cell>> cells;
+public:
+	Group(Point point, Color color) : point(point) {
+		for (uint row = 0; row < row_count; ++row) {
+			for (uint column = 0; column < column_count; ++column) {
+				cells.push_back(std::make_unique<Cell>(Point(column * Cell::size * 2, row * Cell::size * 2), color));
+				RegisterChild(*cells.back());
+			}
+		}
+	}
+private:
+	virtual const Rect UpdateRegionOnParent(Size parent_size) override { return Rect(point, size); }
+	virtual void OnChildRegionUpdate(WndObject& child) override { SetChildRegion(child, UpdateChildRegion(child, size)); }
+	virtual void OnPaint(FigureQueue& figure_queue, Rect accessible_region, Rect invalid_region) const override {
+		for (auto& cell : cells) {
+			if (!GetChildRegion(*cell).Intersect(invalid_region).IsEmpty()) { CompositeChild(*cell, figure_queue, invalid_region); }
+		}
+	}
+};
+
+
+class MainWnd : public WndObject {
+private:
+	static constexpr uint group_count = 500;
+	static constexpr Rect region = Rect(100, 100, Group::size.width, 600);
+	static constexpr Size content_size = Size(Group::size.width, group_count * Group::size.height);
+private:
+	std::vector<std::unique_ptr<Group>> groups;
+	int step = 8;
+	Timer timer = Timer([&]() { OnFrame(); });
+	wstring title;
+public:
+	MainWnd() {
+		for (uint i = 0; i < group_count; ++i) {
+			groups.push_back(std::make_unique<Group>(Point(0, i * Group::size.height), i % 2 ? ColorSet::DarkGreen : ColorSet::Goldenrod));
+			RegisterChild(*groups.back());
+		}
+		SetAccessibleRegion(Rect(point_zero, content_size));
+		timer.Set(16);
+	}
+	~MainWnd() {}
+private:
+	virtual const Rect UpdateRegionOnParent(Size parent_size) override { return region; }
+	virtual const pair<Size, Size> CalculateMinMaxSize(Size parent_size) override { return { region.size, region.size }; }
+	virtual const wstring GetTitle() const override { return title; }
+	virtual void OnChildRegionUpdate(WndObject& child) override { SetChildRegion(child, UpdateChildRegion(child, content_size)); }
+	virtual void OnPaint(FigureQueue& figure_queue, Rect accessible_region, Rect invalid_region) const override {
+		for (auto& group : groups) {
+			if (!GetChildRegion(*group).Intersect(invalid_region).IsEmpty()) { CompositeChild(*group, figure_queue, invalid_region); }
+		}
+	}
+private:
+	void OnFrame() {
+		int y = GetDisplayOffset().y + step;
+		if (y < 0 || y + (int)region.size.height > (int)content_size.height) { step = -step; y += 2 * step; }
+		auto begin = std::chrono::steady_clock::now();
+		SetDisplayOffset(Vector(0, y));
+		auto scrolled = std::chrono::steady_clock::now();
+		desktop.CommitReflowQueue();
+		desktop.CommitRedrawQueue();
+		auto committed = std::chrono::steady_clock::now();
+		using std::chrono::microseconds, std::chrono::duration_cast;
+		title = L"Scroll: " + std::to_wstring(duration_cast<microseconds>(scrolled - begin).count()) + L"us, " +
+			L"Commit: " + std::to_wstring(duration_cast<microseconds>(committed - scrolled).count()) + L"us";
+		TitleChanged();
+	}
+};
+
+
+int main() {
+	MainWnd main_wnd;
+	desktop.AddChild(main_wnd);
+	desktop.MessageLoop();
+	return 0;
+}
\ No newline at end of file
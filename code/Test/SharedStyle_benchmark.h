@@ -0,0 +1,89 @@
+#include "../WndDesign/WndDesign.h"
+#include "../WndDesign/wnd/ListLayout.h"
+#include "../WndDesign/wnd/TextBox.h"
+
+#include <vector>
+#include <chrono>
+
+#define NOMINMAX
+#include <Windows.h>
+#include <psapi.h>
+
+
+using namespace WndDesign;
+
+
+// Constructs a list of 10k text boxes with the same style, either created by value and interned to one shared
+//   style object or each owning a copy, and shows the time and the private bytes used per row on the title.
+
+class Row : public TextBox {
+public:
+	struct Style : TextBox::Style {
+		Style() {
+			width.max(100pct);
+			border.width(1).color(ColorSet::DarkGreen);
+			padding.set(5px, 2px, 5px, 2px);
+			background.setColor(ColorSet::Honeydew);
+			font.size(16);
+		}
+	};
+public:
+	Row(style_ptr<Style> style, uint number) : TextBox(std::move(style), L"Row " + std::to_wstring(number)) {}
+};
+
+
+class MainWnd : public ListLayout {
+private:
+	struct Style : ListLayout::Style {
+		Style() {
+			width.max(70pct);
+			height.max(80pct);
+			position.setHorizontalCenter().setVerticalCenter();
+			border.width(5).color(ColorSet::DarkGreen);
+			background.setColor(ColorSet::LightGray);
+			gridline.width(1);
+		}
+	};
+private:
+	static constexpr uint row_number = 10000;
+	static constexpr bool share_style = true;
+private:
+	std::vector<std::unique_ptr<Row>> rows;
+	wstring title;
+private:
+	static size_t GetPrivateBytes() {
+		PROCESS_MEMORY_COUNTERS_EX counters = {};
+		GetProcessMemoryInfo(GetCurrentProcess(), (PROCESS_MEMORY_COUNTERS*)&counters, sizeof(counters));
+		return counters.PrivateUsage;
+	}
+public:
+	MainWnd() : ListLayout(make_style<Style>()) {
+		size_t bytes = GetPrivateBytes();
+		auto begin = std::chrono::steady_clock::now();
+		std::vector<ref_ptr<WndObject>> children; children.reserve(row_number);
+		rows.reserve(row_number);
+		for (uint i = 0; i < row_number; ++i) {
+			style_ptr<Row::Style> style = share_style ? make_style<Row::Style>() : std::make_unique<Row::Style>();
+			rows.push_back(std::make_unique<Row>(std::move(style), i));
+			children.push_back(rows.back().get());
+		}
+		AppendChildren(children);
+		auto constructed = std::chrono::steady_clock::now();
+		bytes = GetPrivateBytes() - bytes;
+		using std::chrono::milliseconds, std::chrono::duration_cast;
+		title = wstring(share_style ? L"Shared" : L"Unique") + L" style, " +
+			L"Construct: " + std::to_wstring(duration_cast<milliseconds>(constructed - begin).count()) + L"ms, " +
+			L"Bytes per row: " + std::to_wstring(bytes / row_number);
+	}
+	~MainWnd() {}
+private:
+	virtual const wstring GetTitle() const override { return title; }
+};
+
+
+int main() {
+	MainWnd main_wnd;
+	desktop.AddChild(main_wnd);
+	desktop.MessageLoop();
+	return 0;
+}
\ No newline at end of file
@@ -21,7 +21,7 @@ private:
 		}
 	};
 public:
-	MainWnd() : SplitLayout(std::make_unique<Style>()) {
+	MainWnd() : SplitLayout(make_style<Style>()) {
 		//AllocateLayer(); 
 	}
 };
@@ -40,7 +40,7 @@ private:
 		}
 	};
 public:
-	TextArea() : EditBox(std::make_unique<Style>(), L"Type something here...") {
+	TextArea() : EditBox(make_style<Style>(), L"Type something here...") {
 		//AllocateLayer();
 	}
 };
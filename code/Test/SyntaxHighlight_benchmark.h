@@ -0,0 +1,105 @@
+#include "../WndDesign/WndDesign.h"
+#include "../WndDesign/wnd/EditBox.h"
+#include "../WndDesign/message/timer.h"
+
+#include <random>
+#include <chrono>
+#include <cwctype>
+
+
+using namespace WndDesign;
+
+
+// Types a character into a 5k-line source file every frame and highlights the whole file again, and shows the time 
+//   spent in tokenization, in setting the styles in bulk, and in relayout on the title.
+
+class MainWnd : public EditBox {
+private:
+	struct Style : EditBox::Style {
+		Style() {
+			width.normal(800px);
+			height.normal(600px);
+			position.setHorizontalCenter().setVerticalCenter();
+			border.width(5).color(ColorSet::DarkGreen);
+			background.setColor(ColorSet::White);
+			padding.setAll(10px);
+			font.family(L"Consolas").size(16);
+		}
+	};
+private:
+	static constexpr uint line_number = 5000;
+private:
+	const TextStyleColor keyword_style = TextStyleColor(ColorSet::Blue);
+	const TextStyleColor number_style = TextStyleColor(ColorSet::DarkRed);
+	const TextStyleBold bold_style = TextStyleBold(true);
+	std::mt19937 random = std::mt19937(0);
+	Timer timer = Timer([&]() { OnFrame(); });
+	wstring title;
+private:
+	static wstring GetDocument() {
+		wstring text;
+		for (uint line = 0; line < line_number; ++line) {
+			text += L"\tif (count > " + std::to_wstring(line) + L") { return sum * " + std::to_wstring(line % 97) + L"; }\n";
+		}
+		return text;
+	}
+	static bool IsKeyword(const wstring& text, uint begin, uint end) {
+		static const wstring keywords[] = { L"if", L"else", L"for", L"while", L"return" };
+		for (auto& keyword : keywords) {
+			if (keyword.length() == end - begin && text.compare(begin, end - begin, keyword) == 0) { return true; }
+		}
+		return false;
+	}
+	vector<TextStyleRun> Tokenize(const wstring& text) const {
+		vector<TextStyleRun> runs;
+		for (uint pos = 0; pos < text.length();) {
+			uint begin = pos;
+			if (iswalpha(text[pos])) {
+				while (pos < text.length() && iswalnum(text[pos])) { pos++; }
+				if (IsKeyword(text, begin, pos)) {
+					runs.push_back(TextStyleRun{ TextRange{ begin, pos - begin }, &keyword_style });
+					runs.push_back(TextStyleRun{ TextRange{ begin, pos - begin }, &bold_style });
+				}
+			} else if (iswdigit(text[pos])) {
+				while (pos < text.length() && iswdigit(text[pos])) { pos++; }
+				runs.push_back(TextStyleRun{ TextRange{ begin, pos - begin }, &number_style });
+			} else {
+				pos++;
+			}
+		}
+		return runs;
+	}
+public:
+	MainWnd() : EditBox(make_style<Style>(), GetDocument()) {
+		SetTextStyles(0, GetText().GetLength(), Tokenize(GetText().GetString()));
+		timer.Set(16);
+	}
+	~MainWnd() {}
+private:
+	virtual const wstring GetTitle() const override { return title; }
+private:
+	void OnFrame() {
+		std::uniform_int_distribution<uint> position(0, GetText().GetLength());
+		InsertText(position(random), L'1');
+		using std::chrono::steady_clock, std::chrono::microseconds, std::chrono::duration_cast;
+		auto begin = steady_clock::now();
+		vector<TextStyleRun> runs = Tokenize(GetText().GetString());
+		auto tokenized = steady_clock::now();
+		SetTextStyles(0, GetText().GetLength(), runs);
+		auto styled = steady_clock::now();
+		desktop.CommitReflowQueue();
+		auto reflowed = steady_clock::now();
+		title = std::to_wstring(runs.size()) + L" runs, Tokenize: " + std::to_wstring(duration_cast<microseconds>(tokenized - begin).count()) + L"us, " +
+			L"Set styles: " + std::to_wstring(duration_cast<microseconds>(styled - tokenized).count()) + L"us, " +
+			L"Relayout: " + std::to_wstring(duration_cast<microseconds>(reflowed - styled).count()) + L"us";
+		TitleChanged();
+	}
+};
+
+
+int main() {
+	MainWnd main_wnd;
+	desktop.AddChild(main_wnd);
+	desktop.MessageLoop();
+	return 0;
+}
\ No newline at end of file
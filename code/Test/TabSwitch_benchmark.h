@@ -0,0 +1,103 @@
+#include "../WndDesign/WndDesign.h"
+#include "../WndDesign/message/timer.h"
+
+#include <vector>
+#include <chrono>
+
+
+using namespace WndDesign;
+
+
+// Switches between two tab pages of 10k cells every frame by detaching one page and attaching the other,
+//   and shows the time spent in switching and in reflow and redraw queues on the title.
+
+class Cell : public WndObject {
+public:
+	static constexpr uint size = 6;
+private:
+	Point point;
+	Color color;
+public:
+	Cell(Point point, Color color) : point(point), color(color) {}
+private:
+	virtual const Rect UpdateRegionOnParent(Size parent_size) override { return Rect(point, Size(size, size)); }
+	virtual void OnPaint(FigureQueue& figure_queue, Rect accessible_region, Rect invalid_region) const override {
+		figure_queue.Append(point_zero, new Rectangle(accessible_region.size, color, 0.0f, color_transparent));
+	}
+};
+
+
+class Page : public WndObject {
+public:
+	static constexpr uint column_count = 100, row_count = 100;
+	static constexpr Size size = Size(column_count * Cell::size, row_count * Cell::size);
+private:
+	std::vector<std::unique_ptr<Cell>> cells;
+public:
+	Page(Color color) {
+		cells.reserve(column_count * row_count);
+		for (uint row = 0; row < row_count; ++row) {
+			for (uint column = 0; column < column_count; ++column) {
+				Color cell_color = (row + column) % 2 ? color : ColorSet::White;
+				cells.push_back(std::make_unique<Cell>(Point(column * Cell::size, row * Cell::size), cell_color));
+				RegisterChild(*cells.back());
+			}
+		}
+	}
+private:
+	virtual const Rect UpdateRegionOnParent(Size parent_size) override { return Rect(point_zero, size); }
+	virtual void OnChildRegionUpdate(WndObject& child) override { SetChildRegion(child, UpdateChildRegion(child, size)); }
+	virtual void OnPaint(FigureQueue& figure_queue, Rect accessible_region, Rect invalid_region) const override {
+		for (auto& cell : cells) {
+			if (!GetChildRegion(*cell).Intersect(invalid_region).IsEmpty()) { CompositeChild(*cell, figure_queue, invalid_region); }
+		}
+	}
+};
+
+
+class MainWnd : public WndObject {
+private:
+	static constexpr Rect region = Rect(100, 100, Page::size.width, Page::size.height);
+private:
+	Page pages[2] = { Page(ColorSet::DarkGreen), Page(ColorSet::Goldenrod) };
+	uint current = 0;
+	Timer timer = Timer([&]() { OnFrame(); });
+	wstring title;
+public:
+	MainWnd() {
+		RegisterChild(pages[current]);
+		timer.Set(16);
+	}
+	~MainWnd() {}
+private:
+	virtual const Rect UpdateRegionOnParent(Size parent_size) override { return region; }
+	virtual const pair<Size, Size> CalculateMinMaxSize(Size parent_size) override { return { region.size, region.size }; }
+	virtual const wstring GetTitle() const override { return title; }
+	virtual void OnChildRegionUpdate(WndObject& child) override { SetChildRegion(child, UpdateChildRegion(child, region.size)); }
+	virtual void OnPaint(FigureQueue& figure_queue, Rect accessible_region, Rect invalid_region) const override {
+		CompositeChild(pages[current], figure_queue, invalid_region);
+	}
+private:
+	void OnFrame() {
+		auto begin = std::chrono::steady_clock::now();
+		RemoveChild(pages[current]);
+		current = 1 - current;
+		RegisterChild(pages[current]);
+		auto switched = std::chrono::steady_clock::now();
+		desktop.CommitReflowQueue();
+		desktop.CommitRedrawQueue();
+		auto committed = std::chrono::steady_clock::now();
+		using std::chrono::microseconds, std::chrono::duration_cast;
+		title = L"Switch: " + std::to_wstring(duration_cast<microseconds>(switched - begin).count()) + L"us, " +
+			L"Commit: " + std::to_wstring(duration_cast<microseconds>(committed - switched).count()) + L"us";
+		TitleChanged();
+	}
+};
+
+
+int main() {
+	MainWnd main_wnd;
+	desktop.AddChild(main_wnd);
+	desktop.MessageLoop();
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,96 @@
+#include "../WndDesign/WndDesign.h"
+#include "../WndDesign/common/text_buffer.h"
+#include "../WndDesign/message/timer.h"
+
+#include <vector>
+#include <random>
+#include <chrono>
+
+
+using namespace WndDesign;
+
+
+// Types and deletes characters at random positions of 1 MB, 10 MB and 100 MB documents every frame,
+//   and shows the time per keystroke of the piece table and of a flat wstring on the title. Then only deletes
+//   characters at random positions, which splits pieces without inserting new ones, and shows the time per
+//   deletion of the piece table.
+
+class Document {
+public:
+	static constexpr uint keys_per_frame = 20;
+private:
+	uint size_in_mb;
+	TextBuffer buffer;
+	wstring flat_text;
+public:
+	Document(uint size_in_mb) : size_in_mb(size_in_mb) {
+		wstring text;
+		text.reserve(size_in_mb * 1024 * 1024 / sizeof(wchar));
+		while (text.length() < text.capacity()) { text.append(L"The quick brown fox jumps over the lazy dog.\n"); }
+		text.resize(size_in_mb * 1024 * 1024 / sizeof(wchar));
+		flat_text = text;
+		buffer.Assign(std::move(text));
+	}
+public:
+	wstring Type(std::mt19937& random) {
+		std::uniform_int_distribution<uint> position(0, buffer.GetLength() - 1);
+		std::vector<uint> positions(keys_per_frame);
+		for (auto& pos : positions) { pos = position(random); }
+		using std::chrono::steady_clock, std::chrono::nanoseconds, std::chrono::duration_cast;
+		auto begin = steady_clock::now();
+		for (uint i = 0; i < keys_per_frame; ++i) {
+			if (i % 2 == 0) { buffer.Insert(positions[i], L'x'); } else { buffer.Erase(positions[i], 1); }
+		}
+		auto typed = steady_clock::now();
+		TextBuffer snapshot = buffer;
+		auto snapshotted = steady_clock::now();
+		for (uint i = 0; i < keys_per_frame; ++i) {
+			if (i % 2 == 0) { flat_text.insert(positions[i], 1, L'x'); } else { flat_text.erase(positions[i], 1); }
+		}
+		auto flat_typed = steady_clock::now();
+		for (auto& pos : positions) { pos = position(random) % (buffer.GetLength() - keys_per_frame); }
+		auto erase_begin = steady_clock::now();
+		for (uint i = 0; i < keys_per_frame; ++i) { buffer.Erase(positions[i], 1); }
+		auto erased = steady_clock::now();
+		return std::to_wstring(size_in_mb) + L"MB: " +
+			std::to_wstring(duration_cast<nanoseconds>(typed - begin).count() / keys_per_frame) + L"ns/" +
+			std::to_wstring(duration_cast<nanoseconds>(flat_typed - snapshotted).count() / keys_per_frame) + L"ns " +
+			L"(snapshot " + std::to_wstring(duration_cast<nanoseconds>(snapshotted - typed).count()) + L"ns, " +
+			L"delete only " + std::to_wstring(duration_cast<nanoseconds>(erased - erase_begin).count() / keys_per_frame) + L"ns)";
+	}
+};
+
+
+class MainWnd : public WndObject {
+private:
+	static constexpr Rect region = Rect(100, 100, 800, 100);
+private:
+	Document documents[3] = { Document(1), Document(10), Document(100) };
+	std::mt19937 random = std::mt19937(0);
+	Timer timer = Timer([&]() { OnFrame(); });
+	wstring title;
+public:
+	MainWnd() { timer.Set(16); }
+	~MainWnd() {}
+private:
+	virtual const Rect UpdateRegionOnParent(Size parent_size) override { return region; }
+	virtual const pair<Size, Size> CalculateMinMaxSize(Size parent_size) override { return { region.size, region.size }; }
+	virtual const wstring GetTitle() const override { return title; }
+	virtual void OnPaint(FigureQueue& figure_queue, Rect accessible_region, Rect invalid_region) const override {
+		figure_queue.Append(point_zero, new Rectangle(accessible_region.size, ColorSet::White));
+	}
+private:
+	void OnFrame() {
+		title = L"Piece table/wstring per key, ";
+		for (auto& document : documents) { title += document.Type(random) + L"  "; }
+		TitleChanged();
+	}
+};
+
+
+int main() {
+	MainWnd main_wnd;
+	desktop.AddChild(main_wnd);
+	desktop.MessageLoop();
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,63 @@
+#include "../WndDesign/WndDesign.h"
+#include "../WndDesign/wnd/EditBox.h"
+#include "../WndDesign/message/timer.h"
+
+#include <chrono>
+
+
+using namespace WndDesign;
+
+
+// Invalidates a caret-sized region of an edit box with 10k lines every frame, and shows the time to redraw on the
+//   title, which only rasterizes the lines in the invalid region.
+
+class MainWnd : public EditBox {
+private:
+	struct Style : EditBox::Style {
+		Style() {
+			width.normal(800px);
+			height.normal(600px);
+			position.setHorizontalCenter().setVerticalCenter();
+			border.width(5).color(ColorSet::DarkGreen);
+			background.setColor(ColorSet::White);
+			padding.setAll(10px);
+			font.size(16);
+		}
+	};
+private:
+	static constexpr uint line_number = 10000;
+private:
+	Timer timer = Timer([&]() { OnFrame(); });
+	wstring title;
+private:
+	static wstring GetDocument() {
+		wstring text;
+		for (uint line = 0; line < line_number; ++line) {
+			text += L"for (uint i = 0; i < " + std::to_wstring(line) + L"; ++i) { sum += values[i] * weights[i]; }\n";
+		}
+		return text;
+	}
+public:
+	MainWnd() : EditBox(make_style<Style>(), GetDocument()) { timer.Set(16); }
+	~MainWnd() {}
+private:
+	virtual const wstring GetTitle() const override { return title; }
+private:
+	void OnFrame() {
+		using std::chrono::steady_clock, std::chrono::microseconds, std::chrono::duration_cast;
+		Invalidate(Rect(100, 200, 2, 20));
+		auto begin = steady_clock::now();
+		desktop.CommitRedrawQueue();
+		auto redrawn = steady_clock::now();
+		title = L"Redraw caret region: " + std::to_wstring(duration_cast<microseconds>(redrawn - begin).count()) + L"us";
+		TitleChanged();
+	}
+};
+
+
+int main() {
+	MainWnd main_wnd;
+	desktop.AddChild(main_wnd);
+	desktop.MessageLoop();
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,73 @@
+#include "../WndDesign/WndDesign.h"
+#include "../WndDesign/wnd/TextBox.h"
+#include "../WndDesign/message/timer.h"
+
+#include <random>
+#include <chrono>
+
+
+using namespace WndDesign;
+
+
+// Types a character into a random paragraph of a text box with 10k paragraphs every frame,
+//   and shows the time spent in the edit, in relayout and in redraw on the title.
+
+class MainWnd : public TextBox {
+private:
+	struct Style : TextBox::Style {
+		Style() {
+			width.normal(800px);
+			height.normal(600px);
+			position.setHorizontalCenter().setVerticalCenter();
+			border.width(5).color(ColorSet::DarkGreen);
+			background.setColor(ColorSet::White);
+			padding.setAll(10px);
+			font.size(16);
+		}
+	};
+private:
+	static constexpr uint paragraph_number = 10000;
+	static constexpr uint paragraph_length = 80;
+private:
+	std::mt19937 random = std::mt19937(0);
+	Timer timer = Timer([&]() { OnFrame(); });
+	wstring title;
+private:
+	static wstring GetDocument() {
+		wstring paragraph = L"The quick brown fox jumps over the lazy dog. ";
+		while (paragraph.length() < paragraph_length - 1) { paragraph += paragraph; }
+		paragraph.resize(paragraph_length - 1); paragraph += L'\n';
+		wstring text; text.reserve(paragraph_number * paragraph_length);
+		for (uint i = 0; i < paragraph_number; ++i) { text += paragraph; }
+		return text;
+	}
+public:
+	MainWnd() : TextBox(make_style<Style>(), GetDocument()) { timer.Set(16); }
+	~MainWnd() {}
+private:
+	virtual const wstring GetTitle() const override { return title; }
+private:
+	void OnFrame() {
+		std::uniform_int_distribution<uint> position(0, GetText().GetLength());
+		using std::chrono::steady_clock, std::chrono::microseconds, std::chrono::duration_cast;
+		auto begin = steady_clock::now();
+		InsertText(position(random), L'x');
+		auto edited = steady_clock::now();
+		desktop.CommitReflowQueue();
+		auto reflowed = steady_clock::now();
+		desktop.CommitRedrawQueue();
+		auto redrawn = steady_clock::now();
+		title = L"Edit: " + std::to_wstring(duration_cast<microseconds>(edited - begin).count()) + L"us, " +
+			L"Relayout: " + std::to_wstring(duration_cast<microseconds>(reflowed - edited).count()) + L"us, " +
+			L"Redraw: " + std::to_wstring(duration_cast<microseconds>(redrawn - reflowed).count()) + L"us";
+		TitleChanged();
+	}
+};
+
+
+int main() {
+	MainWnd main_wnd;
+	desktop.AddChild(main_wnd);
+	desktop.MessageLoop();
+	return 0;
+}
\ No newline at end of file
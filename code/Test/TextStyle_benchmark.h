@@ -0,0 +1,73 @@
+#include "../WndDesign/WndDesign.h"
+#include "../WndDesign/style/text_style.h"
+#include "../WndDesign/message/timer.h"
+
+#include <vector>
+#include <random>
+#include <chrono>
+
+
+using namespace WndDesign;
+
+
+// Types and deletes characters at random positions of a text with 100k syntax highlighting style runs every frame, 
+//   and shows the time per keystroke of the style runs on the title.
+
+class MainWnd : public WndObject {
+private:
+	static constexpr Rect region = Rect(100, 100, 800, 100);
+	static constexpr uint run_number = 100000;
+	static constexpr uint run_length = 8;
+	static constexpr uint keys_per_frame = 100;
+private:
+	TextStyleRangeList styles;
+	std::mt19937 random = std::mt19937(0);
+	Timer timer = Timer([&]() { OnFrame(); });
+	wstring title;
+public:
+	MainWnd() {
+		const Color colors[] = { ColorSet::Blue, ColorSet::DarkGreen, ColorSet::Brown, ColorSet::Purple };
+		for (uint i = 0; i < run_number; ++i) {
+			styles.SetStyle(TextRange{ i * run_length * 2, run_length }, TextStyleColor(colors[i % std::size(colors)]));
+		}
+		timer.Set(16);
+	}
+	~MainWnd() {}
+private:
+	virtual const Rect UpdateRegionOnParent(Size parent_size) override { return region; }
+	virtual const pair<Size, Size> CalculateMinMaxSize(Size parent_size) override { return { region.size, region.size }; }
+	virtual const wstring GetTitle() const override { return title; }
+	virtual void OnPaint(FigureQueue& figure_queue, Rect accessible_region, Rect invalid_region) const override {
+		figure_queue.Append(point_zero, new Rectangle(accessible_region.size, ColorSet::White));
+	}
+private:
+	void OnFrame() {
+		std::uniform_int_distribution<uint> position(1, run_number * run_length * 2 - 1);
+		std::vector<uint> positions(keys_per_frame);
+		for (auto& pos : positions) { pos = position(random); }
+		using std::chrono::steady_clock, std::chrono::nanoseconds, std::chrono::duration_cast;
+		auto begin = steady_clock::now();
+		for (uint i = 0; i < keys_per_frame; ++i) {
+			// Typing a character extends the run before it, and the highlighter styles it again.
+			styles.ExtendStyle(TextRange{ positions[i], 1 });
+			styles.SetStyle(TextRange{ positions[i], 1 }, TextStyleColor(ColorSet::Red));
+		}
+		auto typed = steady_clock::now();
+		for (uint i = 0; i < keys_per_frame; ++i) {
+			styles.ShrinkStyle(TextRange{ positions[keys_per_frame - 1 - i], 1 });
+		}
+		auto deleted = steady_clock::now();
+		title = std::to_wstring(styles.GetRunNumber()) + L" runs, type: " +
+			std::to_wstring(duration_cast<nanoseconds>(typed - begin).count() / keys_per_frame) + L"ns, delete: " +
+			std::to_wstring(duration_cast<nanoseconds>(deleted - typed).count() / keys_per_frame) + L"ns";
+		TitleChanged();
+	}
+};
+
+
+int main() {
+	MainWnd main_wnd;
+	desktop.AddChild(main_wnd);
+	desktop.MessageLoop();
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,170 @@
+#include "../WndDesign/WndDesign.h"
+#include "../WndDesign/wnd/TextBox.h"
+#include "../WndDesign/style/text_style.h"
+
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <stdexcept>
+
+
+using namespace WndDesign;
+
+
+// Applies random set, clear, extend, shrink and bulk replace operations to TextStyleRangeList and to a model of one
+//   style value per character, compares the styles applied, the changed ranges reported and the number of runs
+//   after each operation, and shows the number of operations and the mismatches found.
+
+class MainWnd : public TextBox {
+private:
+	struct Style : TextBox::Style {
+		Style() {
+			width.normal(800px);
+			height.normal(600px);
+			position.setHorizontalCenter().setVerticalCenter();
+			border.width(5).color(ColorSet::DarkGreen);
+			background.setColor(ColorSet::White);
+			padding.setAll(10px);
+			font.size(16);
+		}
+	};
+private:
+	static constexpr uint round_number = 1000;
+	static constexpr uint operation_number = 400;
+	static constexpr int no_style = -1;
+private:
+	// The model, a style value for each character.
+	using Model = std::vector<int>;
+
+	// A style with an integer value, which writes its value to the characters of a model passed as the layout.
+	struct ModelStyle : TextStyleBase {
+		int value;
+		ModelStyle(int value) : value(value) {}
+		virtual Type GetType() const override { return Type::Color; }
+		virtual bool Equals(const TextStyleBase& style) const override { return value == static_cast<const ModelStyle&>(style).value; }
+		virtual unique_ptr<TextStyleBase> Clone() const override { return std::make_unique<ModelStyle>(*this); }
+		virtual void ApplyTo(TextLayout& layout, TextRange range) const override {
+			Model& model = reinterpret_cast<Model&>(layout);
+			for (uint i = range.begin; i < range.right(); ++i) {
+				if (i >= model.size() || model[i] != no_style) { throw std::runtime_error("style applied out of range or twice"); }
+				model[i] = value;
+			}
+		}
+	};
+	static TextLayout& AsLayout(Model& model) { return reinterpret_cast<TextLayout&>(model); }
+private:
+	std::mt19937 random = std::mt19937(0);
+	wstring title;
+	wstring mismatches;
+	uint mismatch_number = 0;
+private:
+	uint Random(uint bound) { return random() % bound; }
+	void Check(bool condition, const wchar* description, uint round, uint operation) {
+		if (condition) { return; }
+		mismatch_number++;
+		mismatches += std::to_wstring(round) + L":" + std::to_wstring(operation) + L" " + description + L'\n';
+	}
+	// Returns the number of runs a minimal list stores for the model, where the text after the last styled run is not stored.
+	static uint GetRunNumber(const Model& model) {
+		uint styled_end = 0;
+		for (uint i = 0; i < model.size(); ++i) { if (model[i] != no_style) { styled_end = i + 1; } }
+		uint run_number = 0;
+		for (uint i = 0; i < styled_end; ++i) { if (i == 0 || model[i] != model[i - 1]) { run_number++; } }
+		return run_number;
+	}
+	void RunRound(uint round) {
+		TextStyleRangeList styles;
+		Model model(Random(50), no_style);
+		for (uint operation = 0; operation < operation_number; ++operation) {
+			uint length = (uint)model.size();
+			uint begin = std::min(Random(length + 3), length);
+			uint range_length = std::min(Random(12), length - begin);
+			switch (Random(6)) {
+			case 0: {
+				int value = (int)Random(3);
+				styles.SetStyle(TextRange{ begin, range_length }, ModelStyle(value));
+				std::fill(model.begin() + begin, model.begin() + begin + range_length, value);
+			} break;
+			case 1: {
+				styles.ClearStyle(TextRange{ begin, range_length });
+				std::fill(model.begin() + begin, model.begin() + begin + range_length, no_style);
+			} break;
+			case 2: {
+				// Inserted text takes the style of the character before it, or after it at the beginning.
+				uint insert_length = Random(12);
+				int value = length == 0 ? no_style : model[begin == 0 ? 0 : begin - 1];
+				styles.ExtendStyle(TextRange{ begin, insert_length });
+				model.insert(model.begin() + begin, insert_length, value);
+			} break;
+			case 3: {
+				styles.ShrinkStyle(TextRange{ begin, range_length });
+				model.erase(model.begin() + begin, model.begin() + begin + range_length);
+			} break;
+			case 4: {
+				// Runs may start before and end after the range, and only the part in the range is styled.
+				range_length = std::min(range_length * 3, length - begin);
+				std::vector<ModelStyle> run_styles; run_styles.reserve(64);
+				std::vector<TextStyleRun> runs;
+				Model new_model = model;
+				std::fill(new_model.begin() + begin, new_model.begin() + begin + range_length, no_style);
+				for (uint pos = begin > 2 ? begin - 2 : 0; pos < begin + range_length + 3;) {
+					uint run_length = Random(4) + 1;
+					if (Random(3) != 0) {
+						run_styles.emplace_back((int)Random(3));
+						runs.push_back(TextStyleRun{ TextRange{ pos, run_length }, &run_styles.back() });
+						uint run_end = std::min(pos + run_length, begin + range_length);
+						for (uint i = std::max(pos, begin); i < run_end; ++i) { new_model[i] = run_styles.back().value; }
+					}
+					pos += run_length;
+				}
+				std::vector<TextRange> changed_ranges;
+				styles.ReplaceStyles(TextRange{ begin, range_length }, runs, changed_ranges);
+				for (uint i = begin; i < begin + range_length; ++i) {
+					bool is_changed = std::any_of(changed_ranges.begin(), changed_ranges.end(), [&](TextRange range) { return range.Contains(i); });
+					Check(is_changed == (model[i] != new_model[i]), L"changed ranges", round, operation);
+				}
+				for (size_t i = 1; i < changed_ranges.size(); ++i) {
+					Check(changed_ranges[i - 1].right() <= changed_ranges[i].begin, L"changed ranges order", round, operation);
+				}
+				model = std::move(new_model);
+			} break;
+			case 5: {
+				uint end = std::min(begin + range_length * 2, length);
+				// The styles are applied with the positions relative to the range, as to the layout of a paragraph.
+				Model applied(end - begin, no_style);
+				styles.ApplyTo(AsLayout(applied), TextRange{ begin, end - begin });
+				Check(applied == Model(model.begin() + begin, model.begin() + end), L"apply range", round, operation);
+			} break;
+			}
+			Model applied(model.size(), no_style);
+			styles.ApplyTo(AsLayout(applied));
+			Check(applied == model, L"apply", round, operation);
+			Check(styles.GetRunNumber() == GetRunNumber(model), L"run number", round, operation);
+		}
+	}
+public:
+	MainWnd() : TextBox(make_style<Style>(), L"") {
+		for (uint round = 0; round < round_number; ++round) {
+			try {
+				RunRound(round);
+			} catch (std::runtime_error& error) {
+				std::string what = error.what();
+				mismatch_number++;
+				mismatches += std::to_wstring(round) + L" " + wstring(what.begin(), what.end()) + L'\n';
+			}
+		}
+		title = std::to_wstring(round_number * operation_number) + L" operations, mismatches: " + std::to_wstring(mismatch_number);
+		SetText(mismatches);
+	}
+	~MainWnd() {}
+private:
+	virtual const wstring GetTitle() const override { return title; }
+};
+
+
+int main() {
+	MainWnd main_wnd;
+	desktop.AddChild(main_wnd);
+	desktop.MessageLoop();
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,71 @@
+#include "../WndDesign/WndDesign.h"
+#include "../WndDesign/wnd/ListLayout.h"
+#include "../WndDesign/wnd/TextBox.h"
+
+#include <vector>
+
+
+using namespace WndDesign;
+
+
+// A virtual list of 1M rows, with item windows created only for rows in the cached region.
+// The number of item windows created is shown on the title.
+
+class Item : public TextBox {
+private:
+	struct Style : TextBox::Style {
+		Style() {
+			width.max(100pct);
+			padding.setAll(5px);
+			font.size(16);
+		}
+	};
+public:
+	Item() : TextBox(make_style<Style>(), L"") {}
+};
+
+
+class MainWnd : public ListLayout, public ListLayout::ItemSource {
+private:
+	struct Style : ListLayout::Style {
+		Style() {
+			width.max(70pct);
+			height.max(80pct);
+			position.setHorizontalCenter().setVerticalCenter();
+			border.width(5).color(ColorSet::DarkGreen);
+			background.setColor(ColorSet::LightGray);
+			grid_height.min(20px).max(300px);
+			gridline.width(1);
+		}
+	};
+private:
+	static constexpr uint row_number = 1000000;
+private:
+	std::vector<std::unique_ptr<Item>> items;
+	wstring title;
+public:
+	MainWnd() : ListLayout(make_style<Style>()) { SetItemSource(*this, row_number); }
+	~MainWnd() {}
+private:
+	virtual const wstring GetTitle() const override { return title; }
+private:
+	virtual uint EstimateHeight(uint row) override { return row % 10 == 0 ? 48 : 28; }
+	virtual WndObject& CreateItem() override {
+		items.push_back(std::make_unique<Item>());
+		title = L"Item windows: " + std::to_wstring(items.size());
+		TitleChanged();
+		return *items.back();
+	}
+	virtual void BindItem(WndObject& item, uint row) override {
+		static_cast<Item&>(item).SetText(row % 10 == 0 ?
+			L"Row " + std::to_wstring(row) + L"\nThis row has two lines of text." : L"Row " + std::to_wstring(row));
+	}
+};
+
+
+int main() {
+	MainWnd main_wnd;
+	desktop.AddChild(main_wnd);
+	desktop.MessageLoop();
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,106 @@
+#include "../WndDesign/WndDesign.h"
+
+#include <vector>
+
+#define NOMINMAX
+#include <Windows.h>
+#include <psapi.h>
+
+
+using namespace WndDesign;
+
+
+// Constructs a tree of 1000 groups of 100 leaves (100k leaf windows),
+//   and shows the private bytes and GDI objects used per window on the title.
+
+class Leaf : public WndObject {
+public:
+	static constexpr uint size = 4;
+private:
+	Point point;
+public:
+	Leaf(Point point) : point(point) {}
+private:
+	virtual const Rect UpdateRegionOnParent(Size parent_size) override { return Rect(point, Size(size, size)); }
+	virtual void OnPaint(FigureQueue& figure_queue, Rect accessible_region, Rect invalid_region) const override {
+		figure_queue.Append(point_zero, new Rectangle(accessible_region.size, ColorSet::DarkGreen, 0.0f, color_transparent));
+	}
+};
+
+
+class Group : public WndObject {
+public:
+	static constexpr uint leaf_count = 100;
+	static constexpr Size size = Size(leaf_count * Leaf::size, Leaf::size);
+private:
+	Point point;
+	std::vector<std::unique_ptr<Leaf>> leaves;
+public:
+	Group(Point point) : point(point) {
+		leaves.reserve(leaf_count);
+		for (uint i = 0; i < leaf_count; ++i) {
+			leaves.push_back(std::make_unique<Leaf>(Point(i * Leaf::size, 0)));
+			RegisterChild(*leaves.back());
+		}
+	}
+private:
+	virtual const Rect UpdateRegionOnParent(Size parent_size) override { return Rect(point, size); }
+	virtual void OnChildRegionUpdate(WndObject& child) override { SetChildRegion(child, UpdateChildRegion(child, size)); }
+	virtual void OnPaint(FigureQueue& figure_queue, Rect accessible_region, Rect invalid_region) const override {
+		for (auto& leaf : leaves) {
+			if (!GetChildRegion(*leaf).Intersect(invalid_region).IsEmpty()) { CompositeChild(*leaf, figure_queue, invalid_region); }
+		}
+	}
+};
+
+
+class MainWnd : public WndObject {
+private:
+	static constexpr uint group_count = 1000;
+	static constexpr Rect region = Rect(100, 100, Group::size.width, 600);
+	static constexpr Size content_size = Size(Group::size.width, group_count * Group::size.height);
+private:
+	std::vector<std::unique_ptr<Group>> groups;
+	wstring title;
+private:
+	static size_t GetPrivateBytes() {
+		PROCESS_MEMORY_COUNTERS_EX counters = {};
+		GetProcessMemoryInfo(GetCurrentProcess(), (PROCESS_MEMORY_COUNTERS*)&counters, sizeof(counters));
+		return counters.PrivateUsage;
+	}
+	static uint GetGdiObjectCount() { return GetGuiResources(GetCurrentProcess(), GR_GDIOBJECTS); }
+public:
+	MainWnd() {
+		size_t bytes = GetPrivateBytes(); uint gdi_objects = GetGdiObjectCount();
+		groups.reserve(group_count);
+		for (uint i = 0; i < group_count; ++i) {
+			groups.push_back(std::make_unique<Group>(Point(0, i * Group::size.height)));
+			RegisterChild(*groups.back());
+		}
+		size_t wnd_count = group_count * (Group::leaf_count + 1);
+		bytes = GetPrivateBytes() - bytes; gdi_objects = GetGdiObjectCount() - gdi_objects;
+		title = L"Windows: " + std::to_wstring(wnd_count) + L", " +
+			L"Bytes per window: " + std::to_wstring(bytes / wnd_count) + L", " +
+			L"GDI objects: " + std::to_wstring(gdi_objects);
+		SetAccessibleRegion(Rect(point_zero, content_size));
+	}
+	~MainWnd() {}
+private:
+	virtual const Rect UpdateRegionOnParent(Size parent_size) override { return region; }
+	virtual const pair<Size, Size> CalculateMinMaxSize(Size parent_size) override { return { region.size, region.size }; }
+	virtual const wstring GetTitle() const override { return title; }
+	virtual void OnChildRegionUpdate(WndObject& child) override { SetChildRegion(child, UpdateChildRegion(child, content_size)); }
+	virtual void OnPaint(FigureQueue& figure_queue, Rect accessible_region, Rect invalid_region) const override {
+		for (auto& group : groups) {
+			if (!GetChildRegion(*group).Intersect(invalid_region).IsEmpty()) { CompositeChild(*group, figure_queue, invalid_region); }
+		}
+	}
+};
+
+
+int main() {
+	MainWnd main_wnd;
+	desktop.AddChild(main_wnd);
+	desktop.MessageLoop();
+	return 0;
+}
\ No newline at end of file
@@ -20,7 +20,7 @@ private:
 		}
 	};
 public:
-	MainWnd() : Wnd(std::make_unique<Style>()) {}
+	MainWnd() : Wnd(make_style<Style>()) {}
 	~MainWnd() {}
 
 private:
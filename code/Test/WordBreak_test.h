@@ -0,0 +1,119 @@
+#include "../WndDesign/WndDesign.h"
+#include "../WndDesign/wnd/TextBox.h"
+#include "../WndDesign/common/unicode_helper.h"
+
+#include <vector>
+#include <random>
+#include <chrono>
+
+#include <icu.h>
+
+#pragma comment(lib, "icu.lib")
+
+
+using namespace WndDesign;
+
+
+// Compares the word boundaries of WordBreakIterator with ICU word break iterators of several locales on a corpus of
+//   code, prose, random ASCII and text with other scripts, and shows the number of mismatched paragraphs of each 
+//   locale and the time of both on the title. WordBreakIterator follows the default locale, so the other locales
+//   show if their tailorings differ from it on the corpus, like en_US_POSIX of the C locale for the at sign.
+
+class MainWnd : public TextBox {
+private:
+	struct Style : TextBox::Style {
+		Style() {
+			width.normal(800px);
+			height.normal(600px);
+			position.setHorizontalCenter().setVerticalCenter();
+			border.width(5).color(ColorSet::DarkGreen);
+			background.setColor(ColorSet::White);
+			padding.setAll(10px);
+			font.size(16);
+		}
+	};
+private:
+	static constexpr uint random_paragraph_number = 100000;
+private:
+	wstring title;
+private:
+	static std::vector<wstring> GetCorpus() {
+		std::vector<wstring> corpus = {
+			L"for (uint i = 0; i < length; ++i) { boundaries.push_back(i); }",
+			L"int value_1 = compute(3.14, 1,000,000); // don't break 'quoted' words",
+			L"The quick brown fox jumps over the lazy dog. It's 12:30, e.g. mail me@example.com.",
+			L"path/to/file.cpp:42: error: expected ';' before '}' token\r\n",
+			L"  \t  multiple   spaces\tand\ttabs  ",
+			L"a.b.c 1.2.3 a,b 1,2 a;b 1;2 a:b 1:2 a'b 1'2 _a_ __init__ a_1 1_a",
+			L"\x4E2D\x6587\x6D4B\x8BD5 mixed with English and caf\x00E9 na\x00EFve \x0440\x0443\x0441\x0441\x043A\x0438\x0439",
+		};
+		// Random ASCII paragraphs biased towards the characters with word break rules.
+		static constexpr wchar characters[] = L"aZ09_.,;:'\"@ \t\r\v\f-+()!?#$%&*[]{}<>/\\|~`";
+		std::mt19937 random(0);
+		for (uint i = 0; i < random_paragraph_number; ++i) {
+			wstring paragraph(1 + random() % 24, L' ');
+			for (auto& ch : paragraph) {
+				ch = random() % 2 ? characters[random() % (sizeof(characters) / sizeof(wchar) - 1)] : (wchar)(random() % 0x80);
+				if (ch == L'\n') { ch = L' '; }
+			}
+			corpus.push_back(paragraph);
+		}
+		return corpus;
+	}
+public:
+	MainWnd() : TextBox(make_style<Style>(), L"") {
+		using std::chrono::steady_clock, std::chrono::milliseconds, std::chrono::duration_cast;
+		std::vector<wstring> corpus = GetCorpus();
+
+		std::vector<std::vector<uint>> boundaries(corpus.size());
+		auto begin = steady_clock::now();
+		WordBreakIterator iterator;
+		for (size_t i = 0; i < corpus.size(); ++i) {
+			uint length = (uint)corpus[i].length();
+			iterator.SetText(corpus[i].c_str(), length);
+			boundaries[i].push_back(0);
+			for (TextRange word = iterator.Seek(0);; word = iterator.Next()) {
+				boundaries[i].push_back(word.right());
+				if (word.right() >= length) { break; }
+			}
+		}
+		auto iterated = steady_clock::now();
+
+		// nullptr for the default locale, which is timed.
+		static constexpr const char* locales[] = { nullptr, "en_US", "sv_SE", "de_DE", "en_US_POSIX" };
+		wstring mismatch_numbers, mismatches; auto compared = iterated;
+		for (const char* locale : locales) {
+			wstring locale_name = locale == nullptr ? L"default" : wstring(locale, locale + strlen(locale));
+			UErrorCode status = U_ZERO_ERROR;
+			UBreakIterator* icu_iterator = ubrk_open(UBRK_WORD, locale, nullptr, 0, &status);
+			uint mismatch_number = 0;
+			for (size_t i = 0; i < corpus.size(); ++i) {
+				ubrk_setText(icu_iterator, (const UChar*)corpus[i].c_str(), (int32_t)corpus[i].length(), &status);
+				std::vector<uint> icu_boundaries;
+				for (int32_t boundary = ubrk_first(icu_iterator); boundary != UBRK_DONE; boundary = ubrk_next(icu_iterator)) {
+					icu_boundaries.push_back(boundary);
+				}
+				if (icu_boundaries != boundaries[i]) { mismatch_number++; mismatches += locale_name + L": " + corpus[i] + L'\n'; }
+			}
+			ubrk_close(icu_iterator);
+			if (locale == nullptr) { compared = steady_clock::now(); }
+			mismatch_numbers += L" " + locale_name + L" " + std::to_wstring(mismatch_number);
+		}
+
+		title = std::to_wstring(corpus.size()) + L" paragraphs, mismatches:" + mismatch_numbers + L", " +
+			L"WordBreakIterator: " + std::to_wstring(duration_cast<milliseconds>(iterated - begin).count()) + L"ms, " +
+			L"ICU: " + std::to_wstring(duration_cast<milliseconds>(compared - iterated).count()) + L"ms";
+		SetText(mismatches);
+	}
+	~MainWnd() {}
+private:
+	virtual const wstring GetTitle() const override { return title; }
+};
+
+
+int main() {
+	MainWnd main_wnd;
+	desktop.AddChild(main_wnd);
+	desktop.MessageLoop();
+	return 0;
+}
\ No newline at end of file
@@ -46,7 +46,7 @@ private:
 		for (int i = 0; i < 10; ++i) {
 			particles.emplace_back(point);
 		}
-		text = L"Particle Count: " + std::to_wstring(particles.size()); text_block.TextChanged();
+		text.Assign(L"Particle Count: " + std::to_wstring(particles.size())); text_block.TextChanged();
 	}
 	void UpdateParticle() {
 		for (auto& particle : particles) {
@@ -73,7 +73,7 @@ private:
 	}particle_figure = ParticleFigure(*this);
 
 private:
-	wstring text = L"Particle Count: 0";
+	TextBuffer text = TextBuffer(L"Particle Count: 0");
 	TextBlockStyle style;
 	TextBlock text_block = TextBlock(text, style);
 
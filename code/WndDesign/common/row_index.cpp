@@ -0,0 +1,213 @@
+#include "row_index.h"
+
+#include <vector>
+
+
+BEGIN_NAMESPACE(WndDesign)
+
+
+uint RowIndex::NextPriority() {
+	// xorshift32
+	_random_seed ^= _random_seed << 13;
+	_random_seed ^= _random_seed >> 17;
+	_random_seed ^= _random_seed << 5;
+	return _random_seed;
+}
+
+void RowIndex::Pull(Row& row) {
+	row.count = 1;
+	row.height_sum = row.height;
+	row.max_width = row.width;
+	row.estimated_count = row.estimated ? 1 : 0;
+	for (ref_ptr<Row> child : { row.left, row.right }) {
+		if (child == nullptr) { continue; }
+		child->parent = &row;
+		row.count += child->count;
+		row.height_sum += child->height_sum;
+		row.max_width = max(row.max_width, child->max_width);
+		row.estimated_count += child->estimated_count;
+	}
+}
+
+alloc_ptr<RowIndex::Row> RowIndex::Merge(alloc_ptr<Row> left, alloc_ptr<Row> right) {
+	if (left == nullptr) { return right; }
+	if (right == nullptr) { return left; }
+	if (left->priority > right->priority) {
+		left->right = Merge(left->right, right);
+		Pull(*left); left->parent = nullptr;
+		return left;
+	} else {
+		right->left = Merge(left, right->left);
+		Pull(*right); right->parent = nullptr;
+		return right;
+	}
+}
+
+std::pair<alloc_ptr<RowIndex::Row>, alloc_ptr<RowIndex::Row>> RowIndex::Split(alloc_ptr<Row> row, uint count) {
+	if (row == nullptr) { return { nullptr, nullptr }; }
+	row->parent = nullptr;
+	if (Count(row->left) >= count) {
+		auto [left, right] = Split(row->left, count);
+		row->left = right;
+		Pull(*row);
+		if (left != nullptr) { left->parent = nullptr; }
+		return { left, row };
+	} else {
+		auto [left, right] = Split(row->right, count - Count(row->left) - 1);
+		row->right = left;
+		Pull(*row);
+		if (right != nullptr) { right->parent = nullptr; }
+		return { row, right };
+	}
+}
+
+void RowIndex::Destroy(alloc_ptr<Row> row) {
+	if (row == nullptr) { return; }
+	Destroy(row->left);
+	Destroy(row->right);
+	delete row;
+}
+
+void RowIndex::Insert(uint row_begin, uint row_count, std::function<uint(uint)> height) {
+	if (row_count == 0) { return; }
+	if (row_begin > GetRowNumber()) { row_begin = GetRowNumber(); }
+
+	// Build a treap of the new rows in linear time with a stack of the right spine.
+	std::vector<ref_ptr<Row>> spine;
+	for (uint i = 0; i < row_count; ++i) {
+		alloc_ptr<Row> row = new Row();
+		row->height = height(i);
+		row->priority = NextPriority();
+		ref_ptr<Row> last = nullptr;
+		while (!spine.empty() && spine.back()->priority < row->priority) { last = spine.back(); spine.pop_back(); }
+		row->left = last;
+		if (!spine.empty()) { spine.back()->right = row; }
+		spine.push_back(row);
+	}
+	// Update subtree values in post order.
+	struct Local {
+		static void PullAll(ref_ptr<Row> row) {
+			if (row == nullptr) { return; }
+			PullAll(row->left); PullAll(row->right); Pull(*row);
+		}
+	};
+	alloc_ptr<Row> new_rows = spine.front();
+	Local::PullAll(new_rows);
+	new_rows->parent = nullptr;
+
+	auto [left, right] = Split(_root, row_begin);
+	_root = Merge(Merge(left, new_rows), right);
+	_root->parent = nullptr;
+}
+
+void RowIndex::Erase(uint row_begin, uint row_count) {
+	uint row_number = GetRowNumber();
+	if (row_begin >= row_number || row_count == 0) { return; }
+	if (row_count > row_number - row_begin) { row_count = row_number - row_begin; }
+	auto [left, rest] = Split(_root, row_begin);
+	auto [middle, right] = Split(rest, row_count);
+	Destroy(middle);
+	_root = Merge(left, right);
+	if (_root != nullptr) { _root->parent = nullptr; }
+}
+
+void RowIndex::Update(Row& row) {
+	for (ref_ptr<Row> it = &row; it != nullptr; it = it->parent) {
+		Pull(*it);
+	}
+}
+
+void RowIndex::SetAllEstimated() {
+	struct Local {
+		static void SetEstimated(ref_ptr<Row> row) {
+			if (row == nullptr) { return; }
+			SetEstimated(row->left); SetEstimated(row->right);
+			row->estimated = true; row->estimated_count = row->count;
+		}
+	};
+	Local::SetEstimated(_root);
+}
+
+void RowIndex::SetAllEstimated(uint height) {
+	struct Local {
+		static void SetEstimated(ref_ptr<Row> row, uint height) {
+			if (row == nullptr) { return; }
+			SetEstimated(row->left, height); SetEstimated(row->right, height);
+			row->height = height; row->estimated = true; Pull(*row);
+		}
+	};
+	Local::SetEstimated(_root, height);
+}
+
+ref_ptr<RowIndex::Row> RowIndex::GetRow(uint index) const {
+	ref_ptr<Row> row = _root;
+	while (row != nullptr) {
+		uint left_count = Count(row->left);
+		if (index < left_count) { row = row->left; continue; }
+		if (index == left_count) { return row; }
+		index -= left_count + 1; row = row->right;
+	}
+	return nullptr;
+}
+
+uint RowIndex::GetIndex(const Row& row) const {
+	uint index = Count(row.left);
+	for (ref_ptr<const Row> it = &row; it->parent != nullptr; it = it->parent) {
+		if (it->parent->right == it) { index += Count(it->parent->left) + 1; }
+	}
+	return index;
+}
+
+uint RowIndex::GetY(const Row& row) const {
+	uint64 y = Extent(row.left);
+	for (ref_ptr<const Row> it = &row; it->parent != nullptr; it = it->parent) {
+		if (it->parent->right == it) { y += Extent(it->parent->left) + it->parent->height + _gridline_width; }
+	}
+	return (uint)y;
+}
+
+ref_ptr<RowIndex::Row> RowIndex::GetNext(const Row& row) {
+	if (row.right != nullptr) {
+		ref_ptr<Row> it = row.right;
+		while (it->left != nullptr) { it = it->left; }
+		return it;
+	}
+	ref_ptr<const Row> it = &row;
+	while (it->parent != nullptr && it->parent->right == it) { it = it->parent; }
+	return it->parent;
+}
+
+ref_ptr<RowIndex::Row> RowIndex::HitTest(uint y) const {
+	uint64 offset = y;
+	ref_ptr<Row> row = _root;
+	while (row != nullptr) {
+		uint64 left_extent = Extent(row->left);
+		if (offset < left_extent) { row = row->left; continue; }
+		offset -= left_extent;
+		uint64 row_extent = (uint64)row->height + _gridline_width;
+		if (offset < row_extent) {
+			// The gridline below the last row is not included.
+			if (offset >= row->height && GetNext(*row) == nullptr) { return nullptr; }
+			return row;
+		}
+		offset -= row_extent; row = row->right;
+	}
+	return nullptr;
+}
+
+ref_ptr<RowIndex::Row> RowIndex::FindEstimated(ref_ptr<Row> row, uint begin) const {
+	while (row != nullptr && row->estimated_count > 0) {
+		uint left_count = Count(row->left);
+		if (begin < left_count) {
+			if (ref_ptr<Row> result = FindEstimated(row->left, begin); result != nullptr) { return result; }
+			begin = left_count;
+		}
+		if (begin == left_count && row->estimated) { return row; }
+		begin = begin > left_count ? begin - left_count - 1 : 0;
+		row = row->right;
+	}
+	return nullptr;
+}
+
+
+END_NAMESPACE(WndDesign)
\ No newline at end of file
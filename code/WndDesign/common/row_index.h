@@ -0,0 +1,96 @@
+#pragma once
+
+#include "core.h"
+#include "uncopyable.h"
+
+#include <utility>
+#include <functional>
+
+
+BEGIN_NAMESPACE(WndDesign)
+
+class WndObject;
+
+
+// Rows of a list stored in an implicit treap, where the index and y offset of a row are derived from
+//   the subtree sizes and height sums, so that insertion, erasion, resizing, hit testing and y lookup
+//   all take O(log n). Rows are never moved in memory, so a row pointer can be kept by its child window.
+class RowIndex : public Uncopyable {
+public:
+	struct Row : Uncopyable {
+	public:
+		uint height = 0;
+		uint width = 0;
+		ref_ptr<WndObject> wnd = nullptr;
+		bool estimated = true;  // height is estimated and the row is to be measured
+		uint measure_revision = 0;  // set by the owner when the row is measured
+
+	private:
+		friend class RowIndex;
+		ref_ptr<Row> parent = nullptr;
+		alloc_ptr<Row> left = nullptr;
+		alloc_ptr<Row> right = nullptr;
+		uint priority = 0;
+		uint count = 1;
+		uint64 height_sum = 0;
+		uint max_width = 0;
+		uint estimated_count = 0;
+	};
+
+public:
+	RowIndex() {}
+	~RowIndex() { Clear(); }
+
+private:
+	alloc_ptr<Row> _root = nullptr;
+	uint _gridline_width = 0;
+	uint _random_seed = 0x9E3779B9;
+
+private:
+	uint NextPriority();
+	static uint Count(ref_ptr<const Row> row) { return row == nullptr ? 0 : row->count; }
+	static uint64 HeightSum(ref_ptr<const Row> row) { return row == nullptr ? 0 : row->height_sum; }
+	static void Pull(Row& row);
+	static alloc_ptr<Row> Merge(alloc_ptr<Row> left, alloc_ptr<Row> right);
+	static std::pair<alloc_ptr<Row>, alloc_ptr<Row>> Split(alloc_ptr<Row> row, uint count);
+	static void Destroy(alloc_ptr<Row> row);
+	const uint64 Extent(ref_ptr<const Row> row) const { return HeightSum(row) + (uint64)Count(row) * _gridline_width; }
+	ref_ptr<Row> FindEstimated(ref_ptr<Row> row, uint begin) const;
+
+public:
+	uint GetGridlineWidth() const { return _gridline_width; }
+	void SetGridlineWidth(uint gridline_width) { _gridline_width = gridline_width; }
+
+	uint GetRowNumber() const { return Count(_root); }
+	uint GetTotalHeight() const { uint count = Count(_root); return count == 0 ? 0 : (uint)(Extent(_root) - _gridline_width); }
+	uint GetMaxWidth() const { return _root == nullptr ? 0 : _root->max_width; }
+	uint GetAverageHeight() const { uint count = Count(_root); return count == 0 ? 0 : (uint)(HeightSum(_root) / count); }
+	bool HasEstimatedRow() const { return _root != nullptr && _root->estimated_count > 0; }
+
+	// Insert row_count rows before row_begin, with height initialized to height(i) for the i-th row and marked estimated.
+	void Insert(uint row_begin, uint row_count, std::function<uint(uint)> height);
+	void Insert(uint row_begin, uint row_count, uint height) { Insert(row_begin, row_count, [=](uint) { return height; }); }
+	// Erase and destroy rows in [row_begin, row_begin + row_count).
+	void Erase(uint row_begin, uint row_count);
+	void Clear() { Destroy(_root); _root = nullptr; }
+
+	// Mark all rows estimated in O(n).
+	void SetAllEstimated();
+	// Set the height of all rows and mark them estimated in O(n).
+	void SetAllEstimated(uint height);
+	// Must be called after the height, width or estimated flag of the row is changed.
+	void Update(Row& row);
+
+	ref_ptr<Row> GetRow(uint index) const;
+	uint GetIndex(const Row& row) const;
+	uint GetY(const Row& row) const;
+	static ref_ptr<Row> GetNext(const Row& row);
+
+	// Returns the row that contains y (including the gridline below the row), or nullptr if y is beyond the last row.
+	ref_ptr<Row> HitTest(uint y) const;
+	// Returns the first estimated row whose index is not less than begin, or nullptr if none.
+	ref_ptr<Row> FindEstimated(uint begin = 0) const { return FindEstimated(_root, begin); }
+};
+
+
+END_NAMESPACE(WndDesign)
\ No newline at end of file
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "core.h"
+#include "uncopyable.h"
+#include "../geometry/geometry.h"
+
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+
+
+BEGIN_NAMESPACE(WndDesign)
+
+using std::vector;
+
+
+// Uniform grid of items with rectangular regions for region and point queries.
+// Items covering too many cells are kept in a separate list and returned by every query.
+template<class T>
+class SpatialGrid : public Uncopyable {
+public:
+	static constexpr int cell_size = 256;
+	static constexpr uint max_item_cell_number = 64;
+
+private:
+	std::unordered_map<uint64, vector<ref_ptr<T>>> _cells;
+	vector<ref_ptr<T>> _large_items;
+
+private:
+	static int CellIndex(int coordinate) { return coordinate >= 0 ? coordinate / cell_size : (coordinate + 1) / cell_size - 1; }
+	static uint64 CellKey(int x, int y) { return ((uint64)(uint)x << 32) | (uint64)(uint)y; }
+	static bool IsLarge(int x1, int y1, int x2, int y2) {
+		return x2 < x1 || y2 < y1 || (uint64)((long long)x2 - x1 + 1) * (uint64)((long long)y2 - y1 + 1) > max_item_cell_number;
+	}
+	static void EraseItem(vector<ref_ptr<T>>& items, ref_ptr<T> item) {
+		auto it = std::find(items.begin(), items.end(), item);
+		if (it != items.end()) { *it = items.back(); items.pop_back(); }
+	}
+	template<class Func>
+	static void ForEachCell(Rect region, Func func) {
+		int x1 = CellIndex(region.left()), y1 = CellIndex(region.top());
+		int x2 = CellIndex(region.right() - 1), y2 = CellIndex(region.bottom() - 1);
+		for (int y = y1; y <= y2; ++y) { for (int x = x1; x <= x2; ++x) { func(CellKey(x, y)); } }
+	}
+	static bool IsLarge(Rect region) {
+		return IsLarge(CellIndex(region.left()), CellIndex(region.top()), CellIndex(region.right() - 1), CellIndex(region.bottom() - 1));
+	}
+
+public:
+	void Insert(T& item, Rect region) {
+		if (region.IsEmpty()) { return; }
+		if (IsLarge(region)) { _large_items.push_back(&item); return; }
+		ForEachCell(region, [&](uint64 key) { _cells[key].push_back(&item); });
+	}
+	void Erase(T& item, Rect region) {
+		if (region.IsEmpty()) { return; }
+		if (IsLarge(region)) { EraseItem(_large_items, &item); return; }
+		ForEachCell(region, [&](uint64 key) {
+			auto it = _cells.find(key); if (it == _cells.end()) { return; }
+			EraseItem(it->second, &item);
+			if (it->second.empty()) { _cells.erase(it); }
+		});
+	}
+	void Clear() { _cells.clear(); _large_items.clear(); }
+
+	// Get items in the cells overlapping the region without duplicates. Items may not intersect the region.
+	void Query(Rect region, vector<ref_ptr<T>>& items) const {
+		items.assign(_large_items.begin(), _large_items.end());
+		if (region.IsEmpty()) { return; }
+		ForEachCell(region, [&](uint64 key) {
+			auto it = _cells.find(key); if (it == _cells.end()) { return; }
+			items.insert(items.end(), it->second.begin(), it->second.end());
+		});
+		std::sort(items.begin(), items.end());
+		items.erase(std::unique(items.begin(), items.end()), items.end());
+	}
+	void Query(Point point, vector<ref_ptr<T>>& items) const {
+		items.assign(_large_items.begin(), _large_items.end());
+		auto it = _cells.find(CellKey(CellIndex(point.x), CellIndex(point.y)));
+		if (it != _cells.end()) { items.insert(items.end(), it->second.begin(), it->second.end()); }
+	}
+};
+
+
+END_NAMESPACE(WndDesign)
\ No newline at end of file
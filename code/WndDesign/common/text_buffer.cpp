@@ -0,0 +1,213 @@
+#include "text_buffer.h"
+
+#include <cwchar>
+#include <intrin.h>
+
+
+BEGIN_NAMESPACE(WndDesign)
+
+
+uint TextBuffer::NextPriority() {
+	// xorshift32
+	_random_seed ^= _random_seed << 13;
+	_random_seed ^= _random_seed >> 17;
+	_random_seed ^= _random_seed << 5;
+	return _random_seed;
+}
+
+TextBuffer::NodePtr TextBuffer::MakeNode(shared_ptr<const wchar> str, uint length, uint priority, NodePtr left, NodePtr right) {
+	uint total_length = Length(left) + length + Length(right);
+	return std::make_shared<const Node>(Node{ std::move(str), length, total_length, priority, std::move(left), std::move(right) });
+}
+
+TextBuffer::NodePtr TextBuffer::Merge(const NodePtr& left, const NodePtr& right) {
+	if (left == nullptr) { return right; }
+	if (right == nullptr) { return left; }
+	if (left->priority > right->priority) {
+		return MakeNode(left->str, left->length, left->priority, left->left, Merge(left->right, right));
+	} else {
+		return MakeNode(right->str, right->length, right->priority, Merge(left, right->left), right->right);
+	}
+}
+
+std::pair<TextBuffer::NodePtr, TextBuffer::NodePtr> TextBuffer::Split(const NodePtr& node, uint pos) {
+	if (node == nullptr) { return { nullptr, nullptr }; }
+	if (pos == 0) { return { nullptr, node }; }
+	if (pos >= node->total_length) { return { node, nullptr }; }
+	uint piece_begin = Length(node->left), piece_end = piece_begin + node->length;
+	if (pos <= piece_begin) {
+		auto [left, right] = Split(node->left, pos);
+		return { left, MakeNode(node->str, node->length, node->priority, right, node->right) };
+	}
+	if (pos >= piece_end) {
+		auto [left, right] = Split(node->right, pos - piece_end);
+		return { MakeNode(node->str, node->length, node->priority, node->left, left), right };
+	}
+	// Split the piece into two new pieces with random priorities, as if they were inserted, or the fragments of a 
+	//   piece split again and again would keep the same priority and link into a chain.
+	uint offset = pos - piece_begin;
+	shared_ptr<const wchar> str_right(node->str, node->str.get() + offset);
+	NodePtr piece_left = MakeNode(node->str, offset, NextPriority(), nullptr, nullptr);
+	NodePtr piece_right = MakeNode(std::move(str_right), node->length - offset, NextPriority(), nullptr, nullptr);
+	return { Merge(node->left, piece_left), Merge(piece_right, node->right) };
+}
+
+TextBuffer::NodePtr TextBuffer::ExtendLast(const NodePtr& node, uint length) {
+	if (node->right == nullptr) { return MakeNode(node->str, node->length + length, node->priority, node->left, nullptr); }
+	return MakeNode(node->str, node->length, node->priority, node->left, ExtendLast(node->right, length));
+}
+
+bool TextBuffer::IsAppendable(const NodePtr& node, uint length) const {
+	// The last piece can be extended in place if it ends where the next text will be appended to the block.
+	if (node == nullptr || _block == nullptr || _block_length + length > block_capacity) { return false; }
+	ref_ptr<const Node> last = node.get();
+	while (last->right != nullptr) { last = last->right.get(); }
+	return last->str.get() + last->length == _block.get() + _block_length;
+}
+
+shared_ptr<const wchar> TextBuffer::Append(const wchar str[], uint length) {
+	if (length > block_capacity) {
+		shared_ptr<wchar> block(new wchar[length], std::default_delete<wchar[]>());
+		std::wmemcpy(block.get(), str, length);
+		return block;
+	}
+	if (_block == nullptr || _block_length + length > block_capacity) {
+		_block.reset(new wchar[block_capacity], std::default_delete<wchar[]>());
+		_block_length = 0;
+	}
+	std::wmemcpy(_block.get() + _block_length, str, length);
+	shared_ptr<const wchar> text(_block, _block.get() + _block_length);
+	_block_length += length;
+	return text;
+}
+
+uint TextBuffer::Scan(const wchar str[], uint length, wchar ch) {
+	uint i = 0;
+	__m128i pattern = _mm_set1_epi16(static_cast<short>(ch));
+	for (; i + 8 <= length; i += 8) {
+		__m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(str + i));
+		unsigned long mask = static_cast<unsigned long>(_mm_movemask_epi8(_mm_cmpeq_epi16(block, pattern)));
+		if (mask != 0) { unsigned long bit; _BitScanForward(&bit, mask); return i + bit / 2; }
+	}
+	for (; i < length; ++i) {
+		if (str[i] == ch) { return i; }
+	}
+	return npos;
+}
+
+uint TextBuffer::ScanReverse(const wchar str[], uint length, wchar ch) {
+	uint i = length;
+	__m128i pattern = _mm_set1_epi16(static_cast<short>(ch));
+	for (; i >= 8; i -= 8) {
+		__m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(str + i - 8));
+		unsigned long mask = static_cast<unsigned long>(_mm_movemask_epi8(_mm_cmpeq_epi16(block, pattern)));
+		if (mask != 0) { unsigned long bit; _BitScanReverse(&bit, mask); return i - 8 + bit / 2; }
+	}
+	for (; i > 0; --i) {
+		if (str[i - 1] == ch) { return i - 1; }
+	}
+	return npos;
+}
+
+uint TextBuffer::Scan(const wchar str[], uint length, wchar ch1, wchar ch2) {
+	uint i = 0;
+	__m128i pattern1 = _mm_set1_epi16(static_cast<short>(ch1)), pattern2 = _mm_set1_epi16(static_cast<short>(ch2));
+	for (; i + 8 <= length; i += 8) {
+		__m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(str + i));
+		__m128i match = _mm_or_si128(_mm_cmpeq_epi16(block, pattern1), _mm_cmpeq_epi16(block, pattern2));
+		unsigned long mask = static_cast<unsigned long>(_mm_movemask_epi8(match));
+		if (mask != 0) { unsigned long bit; _BitScanForward(&bit, mask); return i + bit / 2; }
+	}
+	for (; i < length; ++i) {
+		if (str[i] == ch1 || str[i] == ch2) { return i; }
+	}
+	return npos;
+}
+
+wchar TextBuffer::GetChar(uint pos) const {
+	if (pos >= GetLength()) { throw std::invalid_argument("invalid text position"); }
+	ref_ptr<const Node> node = _root.get();
+	for (;;) {
+		uint piece_begin = Length(node->left);
+		if (pos < piece_begin) { node = node->left.get(); continue; }
+		pos -= piece_begin;
+		if (pos < node->length) { return node->str.get()[pos]; }
+		pos -= node->length;
+		node = node->right.get();
+	}
+}
+
+const TextBuffer::Chunk TextBuffer::GetChunk(uint pos) const {
+	if (pos >= GetLength()) { throw std::invalid_argument("invalid text position"); }
+	ref_ptr<const Node> node = _root.get(); uint offset = 0;
+	for (;;) {
+		uint piece_begin = Length(node->left);
+		if (pos < piece_begin) { node = node->left.get(); continue; }
+		pos -= piece_begin; offset += piece_begin;
+		if (pos < node->length) { return { node->str.get(), offset, node->length }; }
+		pos -= node->length; offset += node->length;
+		node = node->right.get();
+	}
+}
+
+wstring TextBuffer::GetSubString(uint begin, uint length) const {
+	wstring str;
+	if (begin < GetLength()) { str.reserve(min(length, GetLength() - begin)); }
+	ForEachChunk(begin, length, [&](const wchar chunk[], uint chunk_length) { str.append(chunk, chunk_length); return true; });
+	return str;
+}
+
+uint TextBuffer::Find(wchar ch, uint begin) const {
+	if (begin >= GetLength()) { return npos; }
+	uint pos = begin, result = npos;
+	ForEachChunk(begin, GetLength() - begin, [&](const wchar chunk[], uint chunk_length) {
+		uint found = Scan(chunk, chunk_length, ch);
+		if (found != npos) { result = pos + found; return false; }
+		pos += chunk_length; return true;
+	});
+	return result;
+}
+
+uint TextBuffer::FindLast(wchar ch, uint end) const {
+	end = min(end, GetLength());
+	uint pos = end, result = npos;
+	ForEachChunkReverse(0, end, [&](const wchar chunk[], uint chunk_length) {
+		pos -= chunk_length;
+		uint found = ScanReverse(chunk, chunk_length, ch);
+		if (found != npos) { result = pos + found; return false; }
+		return true;
+	});
+	return result;
+}
+
+void TextBuffer::Assign(wstring text) {
+	_root = nullptr;
+	if (text.empty()) { return; }
+	auto owner = std::make_shared<const wstring>(std::move(text));
+	_root = MakeNode(shared_ptr<const wchar>(owner, owner->data()), (uint)owner->length(), NextPriority(), nullptr, nullptr);
+}
+
+void TextBuffer::Insert(uint pos, const wchar str[], uint length) {
+	if (pos > GetLength()) { throw std::invalid_argument("invalid text position"); }
+	if (length == 0) { return; }
+	auto [left, right] = Split(_root, pos);
+	if (IsAppendable(left, length)) {
+		Append(str, length);
+		left = ExtendLast(left, length);
+	} else {
+		left = Merge(left, MakeNode(Append(str, length), length, NextPriority(), nullptr, nullptr));
+	}
+	_root = Merge(left, right);
+}
+
+void TextBuffer::Erase(uint begin, uint length) {
+	if (begin > GetLength()) { throw std::invalid_argument("invalid text position"); }
+	length = min(length, GetLength() - begin);
+	if (length == 0) { return; }
+	auto [left, rest] = Split(_root, begin);
+	auto [middle, right] = Split(rest, length);
+	_root = Merge(left, right);
+}
+
+
+END_NAMESPACE(WndDesign)
\ No newline at end of file
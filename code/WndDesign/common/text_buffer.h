@@ -0,0 +1,177 @@
+#pragma once
+
+#include "core.h"
+
+#include <string>
+#include <memory>
+#include <utility>
+
+
+BEGIN_NAMESPACE(WndDesign)
+
+using std::wstring;
+using std::shared_ptr;
+
+
+// Text stored as a piece table. Pieces refer to the original text or to append-only blocks of inserted text,
+//   and are kept in an implicit treap ordered by text position, so that insertion and erasion take O(log n)
+//   in the number of pieces. Nodes are immutable and shared, so copying a buffer is an O(1) snapshot that is
+//   not affected by later edits of either copy.
+class TextBuffer {
+public:
+	static constexpr uint npos = (uint)-1;
+
+	struct Chunk {
+		const wchar* str;
+		uint begin;
+		uint length;
+	};
+
+private:
+	struct Node {
+		shared_ptr<const wchar> str;  // aliases the block that owns the text
+		uint length;
+		uint total_length;
+		uint priority;
+		shared_ptr<const Node> left;
+		shared_ptr<const Node> right;
+	};
+	using NodePtr = shared_ptr<const Node>;
+
+public:
+	TextBuffer() {}
+	TextBuffer(wstring text) { Assign(std::move(text)); }
+	TextBuffer(const TextBuffer& buffer) : _root(buffer._root), _random_seed(buffer._random_seed) {}
+	TextBuffer(TextBuffer&& buffer) = default;
+	TextBuffer& operator=(const TextBuffer& buffer) {
+		_root = buffer._root; _random_seed = buffer._random_seed;
+		_block = nullptr; _block_length = 0;
+		return *this;
+	}
+	TextBuffer& operator=(TextBuffer&& buffer) = default;
+	~TextBuffer() {}
+
+private:
+	static constexpr uint block_capacity = 4096;
+
+private:
+	NodePtr _root;
+	shared_ptr<wchar> _block;  // the block that inserted text is appended to, never shared with copies for writing
+	uint _block_length = 0;
+	uint _random_seed = 0x9E3779B9;
+
+private:
+	uint NextPriority();
+	static uint Length(const NodePtr& node) { return node == nullptr ? 0 : node->total_length; }
+	static NodePtr MakeNode(shared_ptr<const wchar> str, uint length, uint priority, NodePtr left, NodePtr right);
+	static NodePtr Merge(const NodePtr& left, const NodePtr& right);
+	std::pair<NodePtr, NodePtr> Split(const NodePtr& node, uint pos);
+	static NodePtr ExtendLast(const NodePtr& node, uint length);
+	bool IsAppendable(const NodePtr& node, uint length) const;
+	shared_ptr<const wchar> Append(const wchar str[], uint length);
+
+	// Returns the offset of the first or the last ch in str, or npos if not found. 8 characters are compared at a time.
+	static uint Scan(const wchar str[], uint length, wchar ch);
+	static uint ScanReverse(const wchar str[], uint length, wchar ch);
+	// Returns the offset of the first ch1 or ch2 in str, or npos if not found.
+	static uint Scan(const wchar str[], uint length, wchar ch1, wchar ch2);
+
+	template<class Func>
+	static bool ForEachChunk(ref_ptr<const Node> node, uint begin, uint end, Func& func);
+	template<class Func>
+	static bool ForEachChunkReverse(ref_ptr<const Node> node, uint begin, uint end, Func& func);
+
+public:
+	uint GetLength() const { return Length(_root); }
+	bool IsEmpty() const { return _root == nullptr; }
+
+	wchar GetChar(uint pos) const;
+	// Returns the piece that contains pos.
+	const Chunk GetChunk(uint pos) const;
+	wstring GetSubString(uint begin, uint length) const;
+	wstring GetString() const { return GetSubString(0, GetLength()); }
+
+	// Returns the position of the first ch not before begin, or npos if not found.
+	uint Find(wchar ch, uint begin = 0) const;
+	// Returns the position of the last ch before end, or npos if not found.
+	uint FindLast(wchar ch, uint end = npos) const;
+
+	// Calls func(uint pos, wchar ch) for the positions of ch1 or ch2 in [begin, begin + length) in order,
+	//   as for finding all line breaks.
+	template<class Func>
+	void FindEach(wchar ch1, wchar ch2, uint begin, uint length, Func func) const;
+
+	// Calls func(const wchar str[], uint length) for the pieces of [begin, begin + length) in order,
+	//   until func returns false.
+	template<class Func>
+	void ForEachChunk(uint begin, uint length, Func func) const;
+	template<class Func>
+	void ForEachChunkReverse(uint begin, uint length, Func func) const;
+
+public:
+	void Assign(wstring text);
+	void Insert(uint pos, const wchar str[], uint length);
+	void Insert(uint pos, const wstring& str) { Insert(pos, str.data(), (uint)str.length()); }
+	void Insert(uint pos, wchar ch) { Insert(pos, &ch, 1); }
+	// length may be out of range, and the text till the end is erased.
+	void Erase(uint begin, uint length);
+	void Replace(uint begin, uint length, const wchar str[], uint new_length) { Erase(begin, length); Insert(begin, str, new_length); }
+	void Replace(uint begin, uint length, const wstring& str) { Replace(begin, length, str.data(), (uint)str.length()); }
+	void Replace(uint begin, uint length, wchar ch) { Replace(begin, length, &ch, 1); }
+	void Clear() { _root = nullptr; }
+};
+
+
+template<class Func>
+inline bool TextBuffer::ForEachChunk(ref_ptr<const Node> node, uint begin, uint end, Func& func) {
+	if (node == nullptr || begin >= end) { return true; }
+	uint piece_begin = Length(node->left), piece_end = piece_begin + node->length;
+	if (begin < piece_begin && !ForEachChunk(node->left.get(), begin, min(end, piece_begin), func)) { return false; }
+	if (begin < piece_end && end > piece_begin) {
+		uint chunk_begin = max(begin, piece_begin), chunk_end = min(end, piece_end);
+		if (!func(node->str.get() + (chunk_begin - piece_begin), chunk_end - chunk_begin)) { return false; }
+	}
+	if (end > piece_end) { return ForEachChunk(node->right.get(), begin > piece_end ? begin - piece_end : 0, end - piece_end, func); }
+	return true;
+}
+
+template<class Func>
+inline bool TextBuffer::ForEachChunkReverse(ref_ptr<const Node> node, uint begin, uint end, Func& func) {
+	if (node == nullptr || begin >= end) { return true; }
+	uint piece_begin = Length(node->left), piece_end = piece_begin + node->length;
+	if (end > piece_end && !ForEachChunkReverse(node->right.get(), begin > piece_end ? begin - piece_end : 0, end - piece_end, func)) { return false; }
+	if (begin < piece_end && end > piece_begin) {
+		uint chunk_begin = max(begin, piece_begin), chunk_end = min(end, piece_end);
+		if (!func(node->str.get() + (chunk_begin - piece_begin), chunk_end - chunk_begin)) { return false; }
+	}
+	if (begin < piece_begin) { return ForEachChunkReverse(node->left.get(), begin, min(end, piece_begin), func); }
+	return true;
+}
+
+template<class Func>
+inline void TextBuffer::ForEachChunk(uint begin, uint length, Func func) const {
+	if (begin > GetLength()) { throw std::invalid_argument("invalid text position"); }
+	ForEachChunk(_root.get(), begin, begin + min(length, GetLength() - begin), func);
+}
+
+template<class Func>
+inline void TextBuffer::ForEachChunkReverse(uint begin, uint length, Func func) const {
+	if (begin > GetLength()) { throw std::invalid_argument("invalid text position"); }
+	ForEachChunkReverse(_root.get(), begin, begin + min(length, GetLength() - begin), func);
+}
+
+template<class Func>
+inline void TextBuffer::FindEach(wchar ch1, wchar ch2, uint begin, uint length, Func func) const {
+	uint pos = begin;
+	ForEachChunk(begin, length, [&](const wchar chunk[], uint chunk_length) {
+		for (uint offset = 0;;) {
+			uint found = Scan(chunk + offset, chunk_length - offset, ch1, ch2);
+			if (found == npos) { break; }
+			offset += found; func(pos + offset, chunk[offset]); ++offset;
+		}
+		pos += chunk_length; return true;
+	});
+}
+
+
+END_NAMESPACE(WndDesign)
\ No newline at end of file
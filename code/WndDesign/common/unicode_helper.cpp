@@ -1,6 +1,11 @@
 #include "unicode_helper.h"
 
 #include <icu.h>
+#include <intrin.h>
+
+#include <array>
+#include <mutex>
+#include <algorithm>
 
 #pragma comment(lib, "icu.lib")
 
@@ -15,6 +20,144 @@ UErrorCode status = U_ZERO_ERROR;
 inline UBreakIterator* GetUBreakIterator(void* iter) { return static_cast<UBreakIterator*>(iter); }
 
 
+// Opening an ICU word break iterator loads the break rules, so iterators are cloned from the first one opened, 
+//   and are reused after the WordBreakIterators are destroyed.
+class UBreakIteratorPool {
+private:
+	std::mutex mutex;
+	alloc_ptr<UBreakIterator> prototype = nullptr;
+	vector<alloc_ptr<UBreakIterator>> iterators;
+public:
+	~UBreakIteratorPool() {
+		for (auto iter : iterators) { ubrk_close(iter); }
+		if (prototype != nullptr) { ubrk_close(prototype); }
+	}
+	alloc_ptr<UBreakIterator> Acquire() {
+		std::lock_guard<std::mutex> lock(mutex);
+		if (!iterators.empty()) { alloc_ptr<UBreakIterator> iter = iterators.back(); iterators.pop_back(); return iter; }
+		UErrorCode status = U_ZERO_ERROR;
+		if (prototype == nullptr) { prototype = ubrk_open(UBRK_WORD, nullptr, nullptr, 0, &status); assert(U_SUCCESS(status)); }
+		alloc_ptr<UBreakIterator> iter = ubrk_safeClone(prototype, nullptr, nullptr, &status); assert(U_SUCCESS(status));
+		return iter;
+	}
+	void Release(alloc_ptr<UBreakIterator> iter) {
+		std::lock_guard<std::mutex> lock(mutex);
+		iterators.push_back(iter);
+	}
+};
+
+UBreakIteratorPool& GetUBreakIteratorPool() {
+	static UBreakIteratorPool pool;
+	return pool;
+}
+
+
+// Word break classes of ASCII characters in UAX #29, the apostrophe acts as a MidNumLet without Hebrew letters.
+enum class WordBreakClass : uchar { Other, Letter, Numeric, ExtendNumLet, MidLetter, MidNum, MidNumLet, CR, LF, Newline, Space, _Number };
+
+using WordBreakClassTable = std::array<WordBreakClass, 0x80>;
+
+inline bool IsAscii(const wchar str[], uint length) {
+	// Or 8 characters at a time, and test the bits above 7 at last.
+	uint i = 0; __m128i bits = _mm_setzero_si128();
+	for (; i + 8 <= length; i += 8) { bits = _mm_or_si128(bits, _mm_loadu_si128(reinterpret_cast<const __m128i*>(str + i))); }
+	wchar rest = 0;
+	for (; i < length; ++i) { rest |= str[i]; }
+	bits = _mm_and_si128(_mm_or_si128(bits, _mm_set1_epi16(static_cast<short>(rest))), _mm_set1_epi16(static_cast<short>(0xFF80)));
+	return _mm_movemask_epi8(_mm_cmpeq_epi16(bits, _mm_setzero_si128())) == 0xFFFF;
+}
+
+void GetAsciiWordBoundaries(const WordBreakClassTable& table, const wchar str[], uint length, vector<uint>& boundaries) {
+	using C = WordBreakClass;
+	auto is_letter = [](C c) { return c == C::Letter; };
+	auto is_numeric = [](C c) { return c == C::Numeric; };
+	auto is_mid_letter = [](C c) { return c == C::MidLetter || c == C::MidNumLet; };
+	auto is_mid_numeric = [](C c) { return c == C::MidNum || c == C::MidNumLet; };
+	auto is_newline = [](C c) { return c == C::CR || c == C::LF || c == C::Newline; };
+	auto get_class = [&](uint i) { return i < length ? table[str[i]] : C::Other; };
+
+	boundaries.clear();
+	boundaries.push_back(0);
+	for (uint i = 1; i < length; ++i) {
+		C prev_prev = i >= 2 ? get_class(i - 2) : C::Other, prev = get_class(i - 1), next = get_class(i), next_next = get_class(i + 1);
+		bool is_break = true;
+		if (prev == C::CR && next == C::LF) { is_break = false; }  // WB3
+		else if (is_newline(prev) || is_newline(next)) { is_break = true; }  // WB3a, WB3b
+		else if (prev == C::Space && next == C::Space) { is_break = false; }  // WB3d
+		else if (is_letter(prev) && is_letter(next)) { is_break = false; }  // WB5
+		else if (is_letter(prev) && is_mid_letter(next) && is_letter(next_next)) { is_break = false; }  // WB6
+		else if (is_letter(prev_prev) && is_mid_letter(prev) && is_letter(next)) { is_break = false; }  // WB7
+		else if ((is_letter(prev) || is_numeric(prev)) && (is_letter(next) || is_numeric(next))) { is_break = false; }  // WB8, WB9, WB10
+		else if (is_numeric(prev_prev) && is_mid_numeric(prev) && is_numeric(next)) { is_break = false; }  // WB11
+		else if (is_numeric(prev) && is_mid_numeric(next) && is_numeric(next_next)) { is_break = false; }  // WB12
+		else if ((is_letter(prev) || is_numeric(prev) || prev == C::ExtendNumLet) && next == C::ExtendNumLet) { is_break = false; }  // WB13a
+		else if (prev == C::ExtendNumLet && (is_letter(next) || is_numeric(next))) { is_break = false; }  // WB13b
+		if (is_break) { boundaries.push_back(i); }
+	}
+	if (length > 0) { boundaries.push_back(length); }
+}
+
+// ICU tailors the classes of some characters, like the colon which is not a MidLetter, and the at sign which is 
+//   a letter since ICU 72, so the classes are checked against the ICU iterator in use once. Each character is put
+//   between characters of all the classes, and is given the first class that gives the same boundaries as ICU.
+//   The fast path is disabled if there's no such class.
+struct AsciiWordBreakClassTable {
+	WordBreakClassTable table = {};
+	bool is_valid = true;
+
+	AsciiWordBreakClassTable() {
+		for (wchar ch = L'a'; ch <= L'z'; ++ch) { table[ch] = WordBreakClass::Letter; }
+		for (wchar ch = L'A'; ch <= L'Z'; ++ch) { table[ch] = WordBreakClass::Letter; }
+		for (wchar ch = L'0'; ch <= L'9'; ++ch) { table[ch] = WordBreakClass::Numeric; }
+		table[L'_'] = WordBreakClass::ExtendNumLet;
+		table[L':'] = WordBreakClass::MidLetter;
+		table[L','] = table[L';'] = WordBreakClass::MidNum;
+		table[L'.'] = table[L'\''] = WordBreakClass::MidNumLet;
+		table[L'\r'] = WordBreakClass::CR;
+		table[L'\n'] = WordBreakClass::LF;
+		table[L'\v'] = table[L'\f'] = WordBreakClass::Newline;
+		table[L' '] = WordBreakClass::Space;
+
+		UBreakIterator* iter = GetUBreakIteratorPool().Acquire();
+		static constexpr wchar samples[] = L"a1_:,. \r\n\v!";
+		vector<uint> icu_boundaries, boundaries;
+		auto is_same_as_icu = [&](wchar ch) {
+			for (wchar prev : samples) {
+				for (wchar next : samples) {
+					if (prev == 0 || next == 0) { continue; }
+					wchar str[5] = { prev, ch, next, ch, prev };
+					UErrorCode status = U_ZERO_ERROR;
+					ubrk_setText(iter, (const UChar*)str, 5, &status); assert(U_SUCCESS(status));
+					icu_boundaries.clear();
+					for (int32_t boundary = ubrk_first(iter); boundary != UBRK_DONE; boundary = ubrk_next(iter)) { icu_boundaries.push_back(boundary); }
+					GetAsciiWordBoundaries(table, str, 5, boundaries);
+					if (boundaries != icu_boundaries) { return false; }
+				}
+			}
+			return true;
+		};
+		// The samples may have wrong classes in the first pass, so the classes are checked until none is changed.
+		for (bool is_changed = true; is_changed && is_valid;) {
+			is_changed = false;
+			for (wchar ch = 0; ch < 0x80 && is_valid; ++ch) {
+				if (is_same_as_icu(ch)) { continue; }
+				is_changed = true; is_valid = false;
+				for (uint type = 0; type < (uint)WordBreakClass::_Number && !is_valid; ++type) {
+					table[ch] = (WordBreakClass)type;
+					is_valid = is_same_as_icu(ch);
+				}
+			}
+		}
+		GetUBreakIteratorPool().Release(iter);
+	}
+};
+
+const AsciiWordBreakClassTable& GetAsciiWordBreakClassTable() {
+	static AsciiWordBreakClassTable table;
+	return table;
+}
+
+
 END_NAMESPACE(Anonymous)
 
 
@@ -22,25 +165,42 @@ static_assert(sizeof(wchar_t) == sizeof(UChar));
 
 
 WordBreakIterator::WordBreakIterator() {
-	iter = ubrk_open(UBRK_WORD, nullptr, nullptr, 0, &status); assert(U_SUCCESS(status));
+	iter = nullptr;
 	str = nullptr; length = 0;
 	begin = end = UBRK_DONE;
+	is_ascii = false;
 }
 
 WordBreakIterator::~WordBreakIterator() {
-	ubrk_close(GetUBreakIterator(iter));
+	if (iter != nullptr) { GetUBreakIteratorPool().Release(GetUBreakIterator(iter)); }
 }
 
 void WordBreakIterator::SetText(const wchar str[], uint length) {
-	ubrk_setText(GetUBreakIterator(iter), (const UChar*)str, length, &status); assert(U_SUCCESS(status));
+	is_ascii = IsAscii(str, length) && GetAsciiWordBreakClassTable().is_valid;
+	if (is_ascii) {
+		GetAsciiWordBoundaries(GetAsciiWordBreakClassTable().table, str, length, boundaries);
+	} else {
+		if (iter == nullptr) { iter = GetUBreakIteratorPool().Acquire(); }
+		ubrk_setText(GetUBreakIterator(iter), (const UChar*)str, length, &status); assert(U_SUCCESS(status));
+	}
 	this->str = str; this->length = length;
 	begin = end = UBRK_DONE;
 }
 
+uint WordBreakIterator::Preceding(uint pos) {
+	if (!is_ascii) { return ubrk_preceding(GetUBreakIterator(iter), pos); }
+	return *(std::lower_bound(boundaries.begin(), boundaries.end(), pos) - 1);
+}
+
+uint WordBreakIterator::Following(uint pos) {
+	if (!is_ascii) { return ubrk_following(GetUBreakIterator(iter), pos); }
+	return *std::upper_bound(boundaries.begin(), boundaries.end(), pos);
+}
+
 const TextRange WordBreakIterator::Seek(uint pos) {
 	if (str == nullptr || pos >= length) { throw std::invalid_argument("invalid text position"); }
-	begin = ubrk_preceding(GetUBreakIterator(iter), pos + 1); assert(begin != UBRK_DONE);
-	end = ubrk_next(GetUBreakIterator(iter)); assert(end != UBRK_DONE);
+	begin = Preceding(pos + 1); assert(begin != UBRK_DONE);
+	end = Following(begin); assert(end != UBRK_DONE);
 	assert(end > begin);
 	return { begin, end - begin };
 }
@@ -49,7 +209,7 @@ const TextRange WordBreakIterator::Next() {
 	if (str == nullptr || begin == -1) { throw std::invalid_argument("invalid text position"); }
 	if (end >= length) { throw std::invalid_argument("cannot increment iterator past end"); }
 	begin = end;
-	end = ubrk_next(GetUBreakIterator(iter)); assert(end != UBRK_DONE);
+	end = Following(begin); assert(end != UBRK_DONE);
 	assert(end > begin);
 	return { begin, end - begin };
 }
@@ -58,7 +218,7 @@ const TextRange WordBreakIterator::Prev() {
 	if (str == nullptr || begin == -1) { throw std::invalid_argument("invalid text position"); }
 	if (begin == 0) { throw std::invalid_argument("cannot decrement iterator before begin"); }
 	end = begin;
-	begin = ubrk_preceding(GetUBreakIterator(iter), begin); assert(begin != UBRK_DONE);
+	begin = Preceding(begin); assert(begin != UBRK_DONE);
 	assert(end > begin);
 	return { begin, end - begin };
 }
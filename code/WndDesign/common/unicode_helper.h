@@ -5,11 +5,13 @@
 #include "../geometry/text_range.h"
 
 #include <string>
+#include <vector>
 
 
 BEGIN_NAMESPACE(WndDesign)
 
 using std::wstring;
+using std::vector;
 
 
 enum class UTF16CharType : uchar {
@@ -34,11 +36,20 @@ inline uint GetUTF16CharLength(wchar ch) {
 }
 
 
+// Iterates the words of a text by the word boundaries of ICU. ASCII text is segmented with the word break classes 
+//   of UAX #29 without ICU, which gives the same boundaries. For other text, the ICU iterator is cloned from a shared
+//   one when first used and returned to the pool when the WordBreakIterator is destroyed.
 class WordBreakIterator : public Uncopyable {
 private:
-	alloc_ptr<void> iter;
+	alloc_ptr<void> iter;  // acquired from the pool for text other than ASCII
 	ref_ptr<const wchar> str; uint length;
 	uint begin, end;
+	bool is_ascii;
+	vector<uint> boundaries;  // of ASCII text, including 0 and length
+
+private:
+	uint Preceding(uint pos);
+	uint Following(uint pos);
 
 public:
 	WordBreakIterator();
@@ -120,13 +120,23 @@ void ImageFigure::DrawOn(RenderTarget& target, Vector offset) const {
 ////                   text_layout.h                   ////
 //////////////////////////////////////////////////////////
 
-void TextBlockFigure::DrawOn(RenderTarget& target, Vector offset) const {
+void TextLayoutFigure::DrawOn(RenderTarget& target, Vector offset) const {
+	// Glyph runs of the lines out of the line region are culled by the clip.
+	target.PushAxisAlignedClip(Rect2RECT(line_region + offset), D2D1_ANTIALIAS_MODE_ALIASED);
 	target.DrawTextLayout(
 		Point2POINT(point_zero + offset),
-		&text_block.GetLayout(),
-		&GetSolidColorBrush(text_block.GetDefaultStyle().font._color),
+		&layout,
+		&GetSolidColorBrush(color),
 		D2D1_DRAW_TEXT_OPTIONS_CLIP | D2D1_DRAW_TEXT_OPTIONS_ENABLE_COLOR_FONT
 	);
+	target.PopAxisAlignedClip();
+}
+
+void TextBlockFigure::DrawOn(RenderTarget& target, Vector offset) const {
+	Color color = text_block.GetDefaultStyle().font._color;
+	text_block.ForEachLayout(region_infinite, [&](TextLayout& layout, Point point, Rect line_region) {
+		TextLayoutFigure(layout, line_region, color).DrawOn(target, point - point_zero + offset);
+	});
 }
 
 
@@ -0,0 +1,219 @@
+#include "paragraph_index.h"
+#include "../system/directx/directx_helper.h"
+#include "../system/directx/dwrite_api.h"
+
+
+BEGIN_NAMESPACE(WndDesign)
+
+
+uint ParagraphIndex::NextPriority() {
+	// xorshift32
+	_random_seed ^= _random_seed << 13;
+	_random_seed ^= _random_seed >> 17;
+	_random_seed ^= _random_seed << 5;
+	return _random_seed;
+}
+
+void ParagraphIndex::Pull(Paragraph& paragraph) {
+	paragraph.count = 1;
+	paragraph.length_sum = paragraph.length;
+	paragraph.height_sum = paragraph.height;
+	paragraph.max_width = paragraph.width;
+	paragraph.unmeasured_count = paragraph.measured ? 0 : 1;
+	for (ref_ptr<Paragraph> child : { paragraph.left, paragraph.right }) {
+		if (child == nullptr) { continue; }
+		child->parent = &paragraph;
+		paragraph.count += child->count;
+		paragraph.length_sum += child->length_sum;
+		paragraph.height_sum += child->height_sum;
+		paragraph.max_width = max(paragraph.max_width, child->max_width);
+		paragraph.unmeasured_count += child->unmeasured_count;
+	}
+}
+
+alloc_ptr<ParagraphIndex::Paragraph> ParagraphIndex::Merge(alloc_ptr<Paragraph> left, alloc_ptr<Paragraph> right) {
+	if (left == nullptr) { return right; }
+	if (right == nullptr) { return left; }
+	if (left->priority > right->priority) {
+		left->right = Merge(left->right, right);
+		Pull(*left); left->parent = nullptr;
+		return left;
+	} else {
+		right->left = Merge(left, right->left);
+		Pull(*right); right->parent = nullptr;
+		return right;
+	}
+}
+
+std::pair<alloc_ptr<ParagraphIndex::Paragraph>, alloc_ptr<ParagraphIndex::Paragraph>> ParagraphIndex::Split(alloc_ptr<Paragraph> paragraph, uint count) {
+	if (paragraph == nullptr) { return { nullptr, nullptr }; }
+	paragraph->parent = nullptr;
+	if (Count(paragraph->left) >= count) {
+		auto [left, right] = Split(paragraph->left, count);
+		paragraph->left = right;
+		Pull(*paragraph);
+		if (left != nullptr) { left->parent = nullptr; }
+		return { left, paragraph };
+	} else {
+		auto [left, right] = Split(paragraph->right, count - Count(paragraph->left) - 1);
+		paragraph->right = left;
+		Pull(*paragraph);
+		if (right != nullptr) { right->parent = nullptr; }
+		return { paragraph, right };
+	}
+}
+
+void ParagraphIndex::Destroy(alloc_ptr<Paragraph> paragraph) {
+	if (paragraph == nullptr) { return; }
+	Destroy(paragraph->left);
+	Destroy(paragraph->right);
+	SafeRelease(&paragraph->layout);
+	delete paragraph;
+}
+
+void ParagraphIndex::Insert(uint index, const vector<uint>& lengths, const HeightEstimator& estimate_height) {
+	if (lengths.empty()) { return; }
+	if (index > GetParagraphNumber()) { index = GetParagraphNumber(); }
+
+	// Build a treap of the new paragraphs in linear time with a stack of the right spine.
+	vector<ref_ptr<Paragraph>> spine;
+	for (uint length : lengths) {
+		alloc_ptr<Paragraph> paragraph = new Paragraph();
+		paragraph->length = length;
+		if (estimate_height != nullptr) { paragraph->height = estimate_height(length); }
+		paragraph->priority = NextPriority();
+		ref_ptr<Paragraph> last = nullptr;
+		while (!spine.empty() && spine.back()->priority < paragraph->priority) { last = spine.back(); spine.pop_back(); }
+		paragraph->left = last;
+		if (!spine.empty()) { spine.back()->right = paragraph; }
+		spine.push_back(paragraph);
+	}
+	// Update subtree values in post order.
+	struct Local {
+		static void PullAll(ref_ptr<Paragraph> paragraph) {
+			if (paragraph == nullptr) { return; }
+			PullAll(paragraph->left); PullAll(paragraph->right); Pull(*paragraph);
+		}
+	};
+	alloc_ptr<Paragraph> new_paragraphs = spine.front();
+	Local::PullAll(new_paragraphs);
+	new_paragraphs->parent = nullptr;
+
+	auto [left, right] = Split(_root, index);
+	_root = Merge(Merge(left, new_paragraphs), right);
+	_root->parent = nullptr;
+}
+
+void ParagraphIndex::Erase(uint index, uint count) {
+	uint paragraph_number = GetParagraphNumber();
+	if (index >= paragraph_number || count == 0) { return; }
+	if (count > paragraph_number - index) { count = paragraph_number - index; }
+	auto [left, rest] = Split(_root, index);
+	auto [middle, right] = Split(rest, count);
+	Destroy(middle);
+	_root = Merge(left, right);
+	if (_root != nullptr) { _root->parent = nullptr; }
+}
+
+void ParagraphIndex::SetAllUnmeasured(const HeightEstimator& estimate_height) {
+	struct Local {
+		static void SetUnmeasured(ref_ptr<Paragraph> paragraph, const HeightEstimator& estimate_height) {
+			if (paragraph == nullptr) { return; }
+			SetUnmeasured(paragraph->left, estimate_height); SetUnmeasured(paragraph->right, estimate_height);
+			paragraph->measured = false;
+			if (estimate_height != nullptr) { paragraph->height = estimate_height(paragraph->length); }
+			Pull(*paragraph);
+		}
+	};
+	Local::SetUnmeasured(_root, estimate_height);
+}
+
+void ParagraphIndex::Update(Paragraph& paragraph) {
+	for (ref_ptr<Paragraph> it = &paragraph; it != nullptr; it = it->parent) {
+		Pull(*it);
+	}
+}
+
+ref_ptr<ParagraphIndex::Paragraph> ParagraphIndex::GetParagraph(uint index) const {
+	ref_ptr<Paragraph> paragraph = _root;
+	while (paragraph != nullptr) {
+		uint left_count = Count(paragraph->left);
+		if (index < left_count) { paragraph = paragraph->left; continue; }
+		if (index == left_count) { return paragraph; }
+		index -= left_count + 1; paragraph = paragraph->right;
+	}
+	return nullptr;
+}
+
+uint ParagraphIndex::GetIndex(const Paragraph& paragraph) const {
+	uint index = Count(paragraph.left);
+	for (ref_ptr<const Paragraph> it = &paragraph; it->parent != nullptr; it = it->parent) {
+		if (it->parent->right == it) { index += Count(it->parent->left) + 1; }
+	}
+	return index;
+}
+
+uint ParagraphIndex::GetBegin(const Paragraph& paragraph) const {
+	uint begin = Length(paragraph.left);
+	for (ref_ptr<const Paragraph> it = &paragraph; it->parent != nullptr; it = it->parent) {
+		if (it->parent->right == it) { begin += Length(it->parent->left) + it->parent->length; }
+	}
+	return begin;
+}
+
+uint ParagraphIndex::GetY(const Paragraph& paragraph) const {
+	uint64 y = HeightSum(paragraph.left);
+	for (ref_ptr<const Paragraph> it = &paragraph; it->parent != nullptr; it = it->parent) {
+		if (it->parent->right == it) { y += HeightSum(it->parent->left) + it->parent->height; }
+	}
+	return (uint)y;
+}
+
+ref_ptr<ParagraphIndex::Paragraph> ParagraphIndex::GetNext(const Paragraph& paragraph) {
+	if (paragraph.right != nullptr) {
+		ref_ptr<Paragraph> it = paragraph.right;
+		while (it->left != nullptr) { it = it->left; }
+		return it;
+	}
+	ref_ptr<const Paragraph> it = &paragraph;
+	while (it->parent != nullptr && it->parent->right == it) { it = it->parent; }
+	return it->parent;
+}
+
+ref_ptr<ParagraphIndex::Paragraph> ParagraphIndex::HitTestPosition(uint position) const {
+	ref_ptr<Paragraph> paragraph = _root;
+	while (paragraph != nullptr) {
+		uint left_length = Length(paragraph->left);
+		if (position < left_length) { paragraph = paragraph->left; continue; }
+		position -= left_length;
+		if (position < paragraph->length || paragraph->right == nullptr) { return paragraph; }
+		position -= paragraph->length; paragraph = paragraph->right;
+	}
+	return nullptr;
+}
+
+ref_ptr<ParagraphIndex::Paragraph> ParagraphIndex::HitTestY(uint y) const {
+	uint64 offset = y;
+	ref_ptr<Paragraph> paragraph = _root;
+	while (paragraph != nullptr) {
+		uint64 left_height = HeightSum(paragraph->left);
+		if (offset < left_height) { paragraph = paragraph->left; continue; }
+		offset -= left_height;
+		if (offset < paragraph->height || paragraph->right == nullptr) { return paragraph; }
+		offset -= paragraph->height; paragraph = paragraph->right;
+	}
+	return nullptr;
+}
+
+ref_ptr<ParagraphIndex::Paragraph> ParagraphIndex::FindUnmeasured() const {
+	ref_ptr<Paragraph> paragraph = _root;
+	while (paragraph != nullptr && paragraph->unmeasured_count > 0) {
+		if (paragraph->left != nullptr && paragraph->left->unmeasured_count > 0) { paragraph = paragraph->left; continue; }
+		if (!paragraph->measured) { return paragraph; }
+		paragraph = paragraph->right;
+	}
+	return nullptr;
+}
+
+
+END_NAMESPACE(WndDesign)
\ No newline at end of file
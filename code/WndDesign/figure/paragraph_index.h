@@ -0,0 +1,106 @@
+#pragma once
+
+#include "../common/core.h"
+#include "../common/uncopyable.h"
+
+#include <vector>
+#include <functional>
+
+
+BEGIN_NAMESPACE(WndDesign)
+
+using std::vector;
+
+struct TextLayout;  // An alias for IDWriteTextLayout.
+
+
+// Paragraphs of a text block stored in an implicit treap, where the text position and y offset of a paragraph
+//   are derived from the subtree sums of text length and height, so that finding a paragraph by text position
+//   or by y, inserting, erasing and resizing paragraphs all take O(log n), and the paragraphs after a resized
+//   one are shifted implicitly.
+class ParagraphIndex : public Uncopyable {
+public:
+	struct Paragraph : Uncopyable {
+	public:
+		uint length = 0;  // including the line break
+		uint break_length = 0;  // the length of the line break at the end, 2 for \r\n, 1 for \n or a lone \r, 0 for the last paragraph
+		alloc_ptr<TextLayout> layout = nullptr;  // created lazily, released with the paragraph
+		uint width = 0;
+		uint height = 0;
+		bool measured = false;  // the layout is created and the size is up to date, otherwise the height is estimated
+		bool layout_shared = false;  // the layout is shared by the layout cache and must not be modified
+		bool monospace = false;  // measured with the cell metrics in monospace layout, and hit tested without the layout
+		bool single_cell = false;  // in monospace layout, each character takes one cell
+
+	private:
+		friend class ParagraphIndex;
+		ref_ptr<Paragraph> parent = nullptr;
+		alloc_ptr<Paragraph> left = nullptr;
+		alloc_ptr<Paragraph> right = nullptr;
+		uint priority = 0;
+		uint count = 1;
+		uint length_sum = 0;
+		uint64 height_sum = 0;
+		uint max_width = 0;
+		uint unmeasured_count = 0;
+	};
+
+public:
+	// Returns the estimated height of an unmeasured paragraph of the length.
+	using HeightEstimator = std::function<uint(uint length)>;
+
+public:
+	ParagraphIndex() {}
+	~ParagraphIndex() { Clear(); }
+
+private:
+	alloc_ptr<Paragraph> _root = nullptr;
+	uint _random_seed = 0x9E3779B9;
+
+private:
+	uint NextPriority();
+	static uint Count(ref_ptr<const Paragraph> paragraph) { return paragraph == nullptr ? 0 : paragraph->count; }
+	static uint Length(ref_ptr<const Paragraph> paragraph) { return paragraph == nullptr ? 0 : paragraph->length_sum; }
+	static uint64 HeightSum(ref_ptr<const Paragraph> paragraph) { return paragraph == nullptr ? 0 : paragraph->height_sum; }
+	static void Pull(Paragraph& paragraph);
+	static alloc_ptr<Paragraph> Merge(alloc_ptr<Paragraph> left, alloc_ptr<Paragraph> right);
+	static std::pair<alloc_ptr<Paragraph>, alloc_ptr<Paragraph>> Split(alloc_ptr<Paragraph> paragraph, uint count);
+	static void Destroy(alloc_ptr<Paragraph> paragraph);
+
+public:
+	uint GetParagraphNumber() const { return Count(_root); }
+	uint GetTextLength() const { return Length(_root); }
+	uint GetTotalHeight() const { return (uint)HeightSum(_root); }
+	uint GetMaxWidth() const { return _root == nullptr ? 0 : _root->max_width; }
+	bool HasUnmeasured() const { return _root != nullptr && _root->unmeasured_count > 0; }
+
+	// Insert paragraphs of lengths before the paragraph at index, unmeasured and without layout,
+	//   with estimated heights if the estimator is given.
+	void Insert(uint index, const vector<uint>& lengths, const HeightEstimator& estimate_height = nullptr);
+	// Erase paragraphs in [index, index + count) and release their layouts.
+	void Erase(uint index, uint count);
+	void Clear() { Destroy(_root); _root = nullptr; }
+
+	// Mark all paragraphs unmeasured in O(n), the layouts are kept, and the heights are estimated again if the 
+	//   estimator is given, or kept as the estimated heights.
+	void SetAllUnmeasured(const HeightEstimator& estimate_height = nullptr);
+	// Must be called after the size or measured flag of the paragraph is changed.
+	void Update(Paragraph& paragraph);
+
+	ref_ptr<Paragraph> GetFirst() const { return GetParagraph(0); }
+	ref_ptr<Paragraph> GetParagraph(uint index) const;
+	uint GetIndex(const Paragraph& paragraph) const;
+	uint GetBegin(const Paragraph& paragraph) const;
+	uint GetY(const Paragraph& paragraph) const;
+	static ref_ptr<Paragraph> GetNext(const Paragraph& paragraph);
+
+	// Returns the paragraph that contains the text position, or the last paragraph if the position is beyond the text.
+	ref_ptr<Paragraph> HitTestPosition(uint position) const;
+	// Returns the paragraph that contains y, or the last paragraph if y is beyond the last paragraph.
+	ref_ptr<Paragraph> HitTestY(uint y) const;
+	// Returns the first unmeasured paragraph, or nullptr if all are measured.
+	ref_ptr<Paragraph> FindUnmeasured() const;
+};
+
+
+END_NAMESPACE(WndDesign)
\ No newline at end of file
@@ -1,7 +1,10 @@
 #include "text_block.h"
+#include "text_layout_cache.h"
 #include "../system/directx/directx_helper.h"
 #include "../system/directx/dwrite_api.h"
 
+#include <algorithm>
+
 
 BEGIN_NAMESPACE(WndDesign)
 
@@ -12,85 +15,472 @@ IDWriteTextFormat** AsTextFormat(TextLayout** text_format) { return reinterpret_
 IDWriteTextLayout** AsTextLayout(TextLayout** text_layout) { return reinterpret_cast<IDWriteTextLayout**>(text_layout); }
 
 
-TextBlock::TextBlock(wstring& text, TextBlockStyle& style) :
-	_text(text), _style(style), _format(nullptr), _layout(nullptr), _max_size(size_max), _size() {
+using Paragraph = ParagraphIndex::Paragraph;
+
+// The line break at the end of a paragraph is not laid out, or it would be laid out as another empty line.
+inline uint GetLayoutLength(const Paragraph& paragraph) { return paragraph.length - paragraph.break_length; }
+
+
+TextBlock::TextBlock(const TextBuffer& text, const TextBlockStyle& style) :
+	_text(text), _style(&style), _format(nullptr), _max_size(size_max), _size(), _top(0), _is_size_valid(false),
+	_is_virtual(false), _layout_region(region_empty), 
+	_measured_line_number(0), _measured_line_height_sum(0.0), _measured_char_number(0), _measured_char_width_sum(0.0),
+	_is_monospace(false), _cell() {
 	TextChanged();
 }
 
 TextBlock::~TextBlock() {
-	SafeRelease(AsTextLayout(&_layout));
+	_paragraphs.Clear();
 	SafeRelease(AsTextFormat(&_format));
 }
 
-void TextBlock::UpdateSize() const {
-	DWRITE_TEXT_METRICS1 metrics;
-	_layout->GetMetrics(&metrics);
-	_size = Size(
-		static_cast<uint>(ceil(metrics.widthIncludingTrailingWhitespace)),  // Round up the size.
-		static_cast<uint>(ceil(metrics.heightIncludingTrailingWhitespace))
-	);
-}
-
-void TextBlock::TextChanged() {
-	// Recreate TextFormat and TextLayout.
-	SafeRelease(AsTextLayout(&_layout));
-	SafeRelease(AsTextFormat(&_format));
-	hr << GetDWriteFactory().CreateTextFormat(
-		_style.font._family.c_str(),
-		NULL,
-		static_cast<DWRITE_FONT_WEIGHT>(_style.font._weight),
-		static_cast<DWRITE_FONT_STYLE>(_style.font._style),
-		static_cast<DWRITE_FONT_STRETCH>(_style.font._stretch),
-		static_cast<FLOAT>(_style.font._size),
-		_style.font._locale.c_str(),
-		AsTextFormat(&_format)
-	);
+void TextBlock::CreateLayout(Paragraph& paragraph, uint begin) const {
+	uint length = GetLayoutLength(paragraph);
+	const wchar* text = L""; wstring joined_text;
+	if (length > 0) {
+		TextBuffer::Chunk chunk = _text.GetChunk(begin);
+		if (chunk.begin + chunk.length >= begin + length) {
+			text = chunk.str + (begin - chunk.begin);
+		} else {
+			joined_text = _text.GetSubString(begin, length); text = joined_text.c_str();
+		}
+	}
+	// Short paragraphs without range styles share the layouts of the same text.
+	paragraph.layout_shared = false;
+	bool has_style = false;
+	for (auto& style : _range_styles) { has_style |= style.HasStyle(TextRange{ begin, length }); }
+	if (!has_style) {
+		paragraph.layout = GetSharedTextLayout(text, length, *AsTextFormat(_format), _max_size);
+		if (paragraph.layout != nullptr) { paragraph.layout_shared = true; return; }
+	}
 	hr << GetDWriteFactory().CreateTextLayout(
-		_text.c_str(), static_cast<UINT>(_text.length()),
+		text, static_cast<UINT>(length),
 		AsTextFormat(_format),
 		(FLOAT)_max_size.width, (FLOAT)_max_size.height,
-		AsTextLayout(&_layout)
+		AsTextLayout(&paragraph.layout)
 	);
+	for (auto& style : _range_styles) { style.ApplyTo(*paragraph.layout, TextRange{ begin, length }); }
+}
 
-	// Set paragraph styles.
-	_layout->SetTextAlignment(static_cast<DWRITE_TEXT_ALIGNMENT>(_style.paragraph._text_align));
-	_layout->SetParagraphAlignment(static_cast<DWRITE_PARAGRAPH_ALIGNMENT>(_style.paragraph._paragraph_align));
-	_layout->SetFlowDirection(static_cast<DWRITE_FLOW_DIRECTION>(_style.paragraph._flow_direction));
-	_layout->SetReadingDirection(static_cast<DWRITE_READING_DIRECTION>(_style.paragraph._read_direction));
-	_layout->SetWordWrapping(static_cast<DWRITE_WORD_WRAPPING>(_style.paragraph._word_wrap));
-	ValueTag line_height = _style.paragraph._line_height;
-	if (line_height.IsPixel()) {
-		_layout->SetLineSpacing(DWRITE_LINE_SPACING_METHOD_UNIFORM, static_cast<FLOAT>(line_height.AsUnsigned()), 0.7F * line_height.AsUnsigned());
-	} else if (line_height.IsPercent()) {
-		_layout->SetLineSpacing(DWRITE_LINE_SPACING_METHOD_PROPORTIONAL, line_height.AsUnsigned() / 100.0F, line_height.AsUnsigned() / 110.0F);
+TextLayout& TextBlock::GetLayout(Paragraph& paragraph) const {
+	// Paragraphs out of the layout region in virtual layout are laid out when hit tested, with the heights still estimated.
+	if (paragraph.layout == nullptr) { CreateLayout(paragraph, _paragraphs.GetBegin(paragraph)); }
+	return *paragraph.layout;
+}
+
+void TextBlock::MeasureParagraph(Paragraph& paragraph) const {
+	// Paragraphs in monospace layout are measured without creating the layout.
+	FLOAT width, height; UINT32 line_count = 1;
+	paragraph.monospace = IsMonospace() && MeasureCells(paragraph, _paragraphs.GetBegin(paragraph), width);
+	if (paragraph.monospace) {
+		height = _cell.line_height;
 	} else {
-		_layout->SetLineSpacing(DWRITE_LINE_SPACING_METHOD_DEFAULT, 0.0F, 0.0F);  // The last two parameters are ignored.
+		DWRITE_TEXT_METRICS1 metrics;
+		GetLayout(paragraph).GetMetrics(&metrics);
+		width = metrics.widthIncludingTrailingWhitespace;
+		height = metrics.heightIncludingTrailingWhitespace;
+		line_count = metrics.lineCount;
 	}
-	ValueTag tab_size = _style.paragraph._tab_size;
-	if (tab_size.IsPixel()) {
-		_layout->SetIncrementalTabStop(static_cast<FLOAT>(tab_size.AsUnsigned()));
-	} 	else if (tab_size.IsPercent()) {
-		_layout->SetIncrementalTabStop(static_cast<FLOAT>(tab_size.AsUnsigned()) * _style.font._size / 100.0F);
+	paragraph.width = static_cast<uint>(ceil(width));  // Round up the size.
+	paragraph.height = static_cast<uint>(ceil(height));
+	paragraph.measured = true;
+	_paragraphs.Update(paragraph);
+
+	// Refine the estimation with the measured paragraph.
+	_measured_line_number += line_count;
+	_measured_line_height_sum += height;
+	uint length = GetLayoutLength(paragraph);
+	if (line_count == 1 && length > 0) {
+		_measured_char_number += length;
+		_measured_char_width_sum += width;
 	}
+}
 
-	// Set text range styles and update layout size.
-	ApplyAllStyles();
-	UpdateSize();
+void TextBlock::UpdateSize() const {
+	if (!_is_virtual) {
+		// Only the paragraphs created or changed since the last update are laid out.
+		for (ref_ptr<Paragraph> paragraph = _paragraphs.FindUnmeasured(); paragraph != nullptr; paragraph = _paragraphs.FindUnmeasured()) {
+			MeasureParagraph(*paragraph);
+		}
+	} else if (!_layout_region.IsEmpty()) {
+		// Only the paragraphs in the layout region are laid out, at the positions after the estimated paragraphs above.
+		int top = _layout_region.top() - _top, bottom = _layout_region.bottom() - _top;
+		ref_ptr<Paragraph> paragraph = _paragraphs.HitTestY((uint)max(top, 0));
+		int y = paragraph == nullptr ? 0 : (int)_paragraphs.GetY(*paragraph);
+		for (; paragraph != nullptr && y < bottom; paragraph = ParagraphIndex::GetNext(*paragraph)) {
+			if (!paragraph->measured) { MeasureParagraph(*paragraph); }
+			y += (int)paragraph->height;
+		}
+	}
+	_size = Size(_paragraphs.GetMaxWidth(), _paragraphs.GetTotalHeight());
+
+	// Paragraphs are laid out with top alignment, and the text block is aligned as a whole.
+	int space = (int)_max_size.height - (int)_size.height;
+	switch (_style->paragraph._paragraph_align) {
+	case ParagraphAlign::Top: _top = 0; break;
+	case ParagraphAlign::Bottom: _top = space; break;
+	case ParagraphAlign::Center: _top = space / 2; break;
+	}
+	_is_size_valid = true;
+}
+
+void TextBlock::InsertParagraphs(uint index, uint begin, uint end) {
+	// Line breaks are \r\n, \n or a lone \r as DirectWrite takes them, found in one pass over the pieces of the text.
+	vector<uint> lengths, break_lengths; uint pos = begin;
+	auto add_paragraph = [&](uint paragraph_end, uint break_length) {
+		lengths.push_back(paragraph_end - pos); break_lengths.push_back(break_length); pos = paragraph_end;
+	};
+	uint cr_position = TextBuffer::npos;  // the \r found last, which may be followed by \n
+	_text.FindEach(L'\n', L'\r', begin, end - begin, [&](uint line_break, wchar ch) {
+		if (cr_position != TextBuffer::npos) {
+			if (ch == L'\n' && line_break == cr_position + 1) { add_paragraph(line_break + 1, 2); cr_position = TextBuffer::npos; return; }
+			add_paragraph(cr_position + 1, 1); cr_position = TextBuffer::npos;
+		}
+		if (ch == L'\n') { add_paragraph(line_break + 1, 1); } else { cr_position = line_break; }
+	});
+	if (cr_position != TextBuffer::npos) { add_paragraph(cr_position + 1, 1); }
+	// The last paragraph of the text doesn't end with a line break and may be empty.
+	if (index == _paragraphs.GetParagraphNumber()) { lengths.push_back(end - pos); } else { assert(pos == end); }
+	_paragraphs.Insert(index, lengths, GetHeightEstimator());
+	ref_ptr<Paragraph> paragraph = _paragraphs.GetParagraph(index);
+	for (uint break_length : break_lengths) { paragraph->break_length = break_length; paragraph = ParagraphIndex::GetNext(*paragraph); }
+}
+
+void TextBlock::UpdateParagraphs(uint begin, uint old_length, uint new_length) {
+	ref_ptr<Paragraph> first = _paragraphs.HitTestPosition(begin);
+	ref_ptr<Paragraph> last = _paragraphs.HitTestPosition(begin + old_length);
+	// A paragraph ending with a lone \r is joined if the text after it now begins with \n.
+	if (uint index = _paragraphs.GetIndex(*first); index > 0 && begin == _paragraphs.GetBegin(*first)) {
+		ref_ptr<Paragraph> previous = _paragraphs.GetParagraph(index - 1);
+		if (previous->break_length == 1 && _text.GetChar(begin - 1) == L'\r') { first = previous; }
+	}
+	uint first_index = _paragraphs.GetIndex(*first), last_index = _paragraphs.GetIndex(*last);
+	uint paragraphs_begin = _paragraphs.GetBegin(*first);
+	uint paragraphs_end = _paragraphs.GetBegin(*last) + last->length - old_length + new_length;
+	_paragraphs.Erase(first_index, last_index - first_index + 1);
+	InsertParagraphs(first_index, paragraphs_begin, paragraphs_end);
+	_is_size_valid = false;
+}
+
+void TextBlock::ResetLayouts(const vector<TextRange>& ranges) {
+	ref_ptr<Paragraph> last_paragraph = nullptr;
+	for (auto& range : ranges) {
+		ref_ptr<Paragraph> paragraph = _paragraphs.HitTestPosition(range.begin);
+		uint paragraph_begin = _paragraphs.GetBegin(*paragraph);
+		for (; paragraph != nullptr && paragraph_begin < range.right(); paragraph = ParagraphIndex::GetNext(*paragraph)) {
+			if (paragraph != last_paragraph) {
+				SafeRelease(&paragraph->layout);
+				paragraph->measured = false;
+				_paragraphs.Update(*paragraph);
+				last_paragraph = paragraph;
+			}
+			paragraph_begin += paragraph->length;
+		}
+	}
+	if (last_paragraph != nullptr) { _is_size_valid = false; }
+}
+
+void TextBlock::TextChanged() {
+	// Get the shared TextFormat and recreate all paragraphs.
+	SafeRelease(AsTextFormat(&_format));
+	*AsTextFormat(&_format) = GetTextFormat(*_style);
+	if (_is_monospace) { ResetCellMetrics(); }
+
+	// The paragraphs will be laid out with text range styles when the size is queried.
+	ResetEstimation();
+	_paragraphs.Clear();
+	InsertParagraphs(0, 0, _text.GetLength());
+	_is_size_valid = false;
 }
 
 void TextBlock::AutoResize(Size max_size) const {
 	if (_max_size == max_size) { return; }
 
-	if (_max_size.width != max_size.width) {
-		_max_size.width = max_size.width; _layout->SetMaxWidth(static_cast<FLOAT>(_max_size.width));
-	}
-	if (_max_size.height != max_size.height) {
-		_max_size.height = max_size.height; _layout->SetMaxHeight(static_cast<FLOAT>(_max_size.height));
+	bool is_width_changed = _max_size.width != max_size.width;
+	_max_size = max_size;
+	for (ref_ptr<Paragraph> paragraph = _paragraphs.GetFirst(); paragraph != nullptr; paragraph = ParagraphIndex::GetNext(*paragraph)) {
+		if (paragraph->layout == nullptr) { continue; }
+		if (paragraph->layout_shared) {
+			// Shared layouts are not modified, but laid out again with the max size.
+			SafeRelease(&paragraph->layout);
+			paragraph->measured = false;
+			_paragraphs.Update(*paragraph);
+			continue;
+		}
+		paragraph->layout->SetMaxWidth(static_cast<FLOAT>(_max_size.width));
+		paragraph->layout->SetMaxHeight(static_cast<FLOAT>(_max_size.height));
 	}
+	if (is_width_changed) { _paragraphs.SetAllUnmeasured(GetHeightEstimator()); }
 
 	UpdateSize();
 }
 
+// Returns the region of the lines of the layout overlapping [top, bottom) in the layout.
+inline Rect GetLineRegion(TextLayout& layout, uint width, uint height, int top, int bottom) {
+	if (top <= 0 && bottom >= (int)height) { return Rect(0, 0, width, height); }
+	UINT32 line_cnt;
+	layout.GetLineMetrics((DWRITE_LINE_METRICS1*)nullptr, 0, &line_cnt);
+	vector<DWRITE_LINE_METRICS1> line_metrics(line_cnt);
+	layout.GetLineMetrics(line_metrics.data(), line_cnt, &line_cnt);
+	bool found = false; FLOAT line_top = 0.0F, line_bottom = 0.0F, y = 0.0F;
+	for (auto& line : line_metrics) {
+		if (y >= bottom) { break; }
+		if (y + line.height > top) {
+			if (!found) { line_top = y; found = true; }
+			line_bottom = y + line.height;
+		}
+		y += line.height;
+	}
+	if (!found) { return region_empty; }
+	int region_top = (int)floorf(line_top), region_bottom = min((int)ceilf(line_bottom), (int)height);
+	return Rect(0, region_top, width, (uint)max(region_bottom - region_top, 0));
+}
+
+void TextBlock::ForEachLayout(Rect region, std::function<void(TextLayout&, Point, Rect)> func) const {
+	GetSize();
+	if (region.IsEmpty()) { return; }
+	// Paragraphs are found by y, and only those overlapping the region are visited.
+	uint width = max(_size.width, _max_size.width);
+	int top = region.top() - _top, bottom = region.bottom() - _top;
+	ref_ptr<Paragraph> paragraph = _paragraphs.HitTestY((uint)max(top, 0));
+	int y = paragraph == nullptr ? 0 : (int)_paragraphs.GetY(*paragraph);
+	for (; paragraph != nullptr && y < bottom; paragraph = ParagraphIndex::GetNext(*paragraph)) {
+		if (paragraph->measured) {
+			// Paragraphs measured in monospace layout are laid out when first drawn.
+			TextLayout& layout = GetLayout(*paragraph);
+			Rect line_region = GetLineRegion(layout, width, paragraph->height, top - y, bottom - y);
+			if (!line_region.IsEmpty()) { func(layout, Point(0, _top + y), line_region); }
+		}
+		y += (int)paragraph->height;
+	}
+}
+
+void TextBlock::ResetEstimation() {
+	// Seed the estimation with a sample text as if it were a measured paragraph.
+	static constexpr wchar sample[] = L"The quick brown fox jumps over the lazy dog.";
+	static constexpr uint sample_length = sizeof(sample) / sizeof(wchar) - 1;
+	alloc_ptr<TextLayout> layout = nullptr;
+	hr << GetDWriteFactory().CreateTextLayout(
+		sample, sample_length, AsTextFormat(_format), (FLOAT)size_max.width, (FLOAT)size_max.height, AsTextLayout(&layout)
+	);
+	DWRITE_TEXT_METRICS1 metrics;
+	layout->GetMetrics(&metrics);
+	SafeRelease(&layout);
+	_measured_line_number = 1;
+	_measured_line_height_sum = metrics.heightIncludingTrailingWhitespace;
+	_measured_char_number = sample_length;
+	_measured_char_width_sum = metrics.widthIncludingTrailingWhitespace;
+}
+
+uint TextBlock::EstimateHeight(uint length) const {
+	double line_height = _measured_line_height_sum / _measured_line_number;
+	double line_number = 1.0;
+	if (_style->paragraph._word_wrap != WordWrap::NoWrap && _max_size.width > 0) {
+		double width = length * _measured_char_width_sum / _measured_char_number;
+		line_number = max(1.0, ceil(width / _max_size.width));
+	}
+	return static_cast<uint>(ceil(line_number * line_height));
+}
+
+ParagraphIndex::HeightEstimator TextBlock::GetHeightEstimator() const {
+	if (!_is_virtual) { return nullptr; }
+	return [this](uint length) { return EstimateHeight(length); };
+}
+
+void TextBlock::SetVirtual(bool is_virtual) {
+	if (_is_virtual == is_virtual) { return; }
+	_is_virtual = is_virtual;
+	// Paragraphs not in the layout region will use estimated heights, or all paragraphs will be laid out.
+	if (_is_virtual) { _paragraphs.SetAllUnmeasured(GetHeightEstimator()); }
+	_is_size_valid = false;
+}
+
+bool TextBlock::SetLayoutRegion(Rect region) const {
+	_layout_region = region;
+	if (!_is_virtual || _layout_region.IsEmpty()) { return true; }
+	int top = _layout_region.top() - _top, bottom = _layout_region.bottom() - _top;
+	ref_ptr<Paragraph> paragraph = _paragraphs.HitTestY((uint)max(top, 0));
+	int y = paragraph == nullptr ? 0 : (int)_paragraphs.GetY(*paragraph);
+	for (; paragraph != nullptr && y < bottom; paragraph = ParagraphIndex::GetNext(*paragraph)) {
+		if (!paragraph->measured) { _is_size_valid = false; return false; }
+		y += (int)paragraph->height;
+	}
+	return true;
+}
+
+uint TextBlock::HitTestParagraph(int y) const {
+	ref_ptr<Paragraph> paragraph = _paragraphs.HitTestY((uint)max(y - _top, 0));
+	return paragraph == nullptr ? 0 : _paragraphs.GetBegin(*paragraph);
+}
+
+uint TextBlock::GetParagraphIndex(uint text_position) const {
+	return _paragraphs.GetIndex(*_paragraphs.HitTestPosition(text_position));
+}
+
+const TextRange TextBlock::GetParagraphRange(uint index) const {
+	ref_ptr<Paragraph> paragraph = _paragraphs.GetParagraph(min(index, _paragraphs.GetParagraphNumber() - 1));
+	return TextRange{ _paragraphs.GetBegin(*paragraph), paragraph->length };
+}
+
+int TextBlock::GetParagraphY(uint text_position) const {
+	ref_ptr<Paragraph> paragraph = _paragraphs.HitTestPosition(text_position);
+	return _top + (paragraph == nullptr ? 0 : (int)_paragraphs.GetY(*paragraph));
+}
+
+
+// Returns the cells a character takes in monospace layout, 2 for wide characters and 0 for tabs, or -1 if the 
+//   character must be laid out, like controls, combining marks, surrogates and characters of other scripts.
+inline int GetCellNumber(wchar ch) {
+	if (ch == L'\t') { return 0; }
+	if ((ch >= 0x20 && ch < 0x7F) || (ch >= 0xA0 && ch < 0x250 && ch != 0xAD)) { return 1; }
+	if ((ch >= 0x1100 && ch < 0x1160) || (ch >= 0x2E80 && ch < 0x302A) || (ch >= 0x3030 && ch < 0x303F) ||
+		(ch >= 0x3041 && ch < 0x3099) || (ch >= 0x309B && ch < 0xA4D0) || (ch >= 0xAC00 && ch < 0xD7A4) ||
+		(ch >= 0xF900 && ch < 0xFB00) || (ch >= 0xFE30 && ch < 0xFE50) || (ch >= 0xFF01 && ch < 0xFF61) || (ch >= 0xFFE0 && ch < 0xFFE7)) {
+		return 2;
+	}
+	return -1;
+}
+
+inline bool IsMeasuredInCells(const Paragraph& paragraph) { return paragraph.measured && paragraph.monospace; }
+
+void TextBlock::ResetCellMetrics() {
+	_cell = CellMetrics();
+	auto& paragraph = _style->paragraph;
+	if (paragraph._flow_direction != FlowDirection::TopToBottom || paragraph._read_direction != ReadDirection::LeftToRight ||
+		(paragraph._text_align != TextAlign::Leading && paragraph._text_align != TextAlign::Justified)) {
+		return;
+	}
+
+	// The font is monospace if narrow characters of different shapes have the same width, and the wide characters
+	//   are measured with ideographs, kana and hangul, which may come from different fallback fonts.
+	static constexpr uint sample_length = 64;
+	auto measure = [&](wchar ch) {
+		wstring sample(sample_length, ch);
+		alloc_ptr<TextLayout> layout = nullptr;
+		hr << GetDWriteFactory().CreateTextLayout(
+			sample.c_str(), sample_length, AsTextFormat(_format), (FLOAT)size_max.width, (FLOAT)size_max.height, AsTextLayout(&layout)
+		);
+		DWRITE_TEXT_METRICS1 metrics;
+		layout->GetMetrics(&metrics);
+		SafeRelease(&layout);
+		return metrics;
+	};
+	auto is_same = [](const DWRITE_TEXT_METRICS1& a, const DWRITE_TEXT_METRICS1& b) {
+		return fabsf(a.widthIncludingTrailingWhitespace - b.widthIncludingTrailingWhitespace) < 0.5F &&
+			a.heightIncludingTrailingWhitespace == b.heightIncludingTrailingWhitespace;
+	};
+	DWRITE_TEXT_METRICS1 narrow = measure(L'0');
+	for (wchar ch : { L'i', L'W', L'_', L' ' }) {
+		if (!is_same(measure(ch), narrow)) { return; }
+	}
+	_cell.width = narrow.widthIncludingTrailingWhitespace / sample_length;
+	_cell.line_height = narrow.heightIncludingTrailingWhitespace;
+	_cell.tab_width = AsTextFormat(_format)->GetIncrementalTabStop();
+	DWRITE_TEXT_METRICS1 wide = measure(L'\x4E00');
+	if (wide.heightIncludingTrailingWhitespace == narrow.heightIncludingTrailingWhitespace &&
+		is_same(measure(L'\x3042'), wide) && is_same(measure(L'\xAC00'), wide)) {
+		_cell.wide_width = wide.widthIncludingTrailingWhitespace / sample_length;
+	}
+}
+
+template<class Func>
+void TextBlock::ForEachCell(uint begin, uint length, Func func) const {
+	uint offset = 0; float x = 0.0f;
+	_text.ForEachChunk(begin, length, [&](const wchar str[], uint chunk_length) {
+		for (uint i = 0; i < chunk_length; ++i, ++offset) {
+			float right;
+			switch (GetCellNumber(str[i])) {
+			case 0: right = (floorf(x / _cell.tab_width) + 1.0f) * _cell.tab_width; break;
+			case 2: right = x + _cell.wide_width; break;
+			default: right = x + _cell.width; break;
+			}
+			if (!func(offset, x, right)) { return false; }
+			x = right;
+		}
+		return true;
+	});
+}
+
+bool TextBlock::MeasureCells(Paragraph& paragraph, uint begin, float& width) const {
+	// Color styles are allowed, which don't change the advances.
+	uint length = GetLayoutLength(paragraph);
+	for (uint type = 0; type < TextStyleBase::_TypeNumber(); ++type) {
+		if (type == (uint)TextStyleBase::Type::Color) { continue; }
+		if (_range_styles[type].HasStyle(TextRange{ begin, length })) { return false; }
+	}
+	bool is_valid = true, single_cell = true;
+	_text.ForEachChunk(begin, length, [&](const wchar str[], uint chunk_length) {
+		for (uint i = 0; i < chunk_length; ++i) {
+			int cells = GetCellNumber(str[i]);
+			if (cells == 1) { continue; }
+			single_cell = false;
+			if (cells < 0 || (cells == 0 && _cell.tab_width <= 0.0f) || (cells == 2 && _cell.wide_width == 0.0f)) { is_valid = false; return false; }
+		}
+		return true;
+	});
+	if (!is_valid) { return false; }
+	width = length * _cell.width;
+	if (!single_cell) { ForEachCell(begin, length, [&](uint offset, float left, float right) { width = right; return true; }); }
+	// Paragraphs longer than a line are wrapped by the layout.
+	if (_style->paragraph._word_wrap != WordWrap::NoWrap && width > _max_size.width) { return false; }
+	paragraph.single_cell = single_cell;
+	return true;
+}
+
+const DWRITE_HIT_TEST_METRICS TextBlock::GetCellMetrics(const Paragraph& paragraph, uint begin, uint offset) const {
+	uint length = GetLayoutLength(paragraph);
+	offset = min(offset, length);
+	float left = 0.0f, right = 0.0f;
+	if (paragraph.single_cell) {
+		left = offset * _cell.width;
+		right = offset < length ? left + _cell.width : left;
+	} else {
+		ForEachCell(begin, length, [&](uint i, float cell_left, float cell_right) {
+			if (i == offset) { left = cell_left; right = cell_right; return false; }
+			left = right = cell_right; return true;
+		});
+	}
+	DWRITE_HIT_TEST_METRICS metrics = {};
+	metrics.textPosition = offset;
+	metrics.length = offset < length ? 1 : 0;
+	metrics.left = left;
+	metrics.width = right - left;
+	metrics.height = _cell.line_height;
+	metrics.isText = TRUE;
+	return metrics;
+}
+
+const DWRITE_HIT_TEST_METRICS TextBlock::HitTestCell(const Paragraph& paragraph, uint begin, float x, bool& is_trailing_hit) const {
+	// Points after the line hit the trailing side of the last character, as the text layout does.
+	uint length = GetLayoutLength(paragraph);
+	uint offset = 0; is_trailing_hit = false;
+	if (length > 0 && x >= 0.0f) {
+		if (paragraph.single_cell) {
+			float column = x / _cell.width;
+			if (column >= length) {
+				offset = length - 1; is_trailing_hit = true;
+			} else {
+				offset = (uint)column; is_trailing_hit = column - offset >= 0.5f;
+			}
+		} else {
+			offset = length - 1; is_trailing_hit = true;
+			ForEachCell(begin, length, [&](uint i, float left, float right) {
+				if (x >= right) { return true; }
+				offset = i; is_trailing_hit = x >= (left + right) / 2; return false;
+			});
+		}
+	}
+	return GetCellMetrics(paragraph, begin, offset);
+}
+
+void TextBlock::SetMonospace(bool is_monospace) {
+	if (_is_monospace == is_monospace) { return; }
+	_is_monospace = is_monospace;
+	if (_is_monospace) { ResetCellMetrics(); }
+	_paragraphs.SetAllUnmeasured(GetHeightEstimator());
+	_is_size_valid = false;
+}
+
 
 inline const TextBlockHitTestInfo HitTestMetricsToInfo(const DWRITE_HIT_TEST_METRICS& metrics, bool is_inside, bool is_trailing_hit) {
 	Point left_top = Point((int)roundf(metrics.left), (int)roundf(metrics.top));
@@ -106,40 +496,95 @@ inline const TextBlockHitTestInfo HitTestMetricsToInfo(const DWRITE_HIT_TEST_MET
 }
 
 const TextBlockHitTestInfo TextBlock::HitTestPoint(Point point) const {
+	GetSize();
+	int y = point.y - _top;
+	ref_ptr<Paragraph> paragraph = _paragraphs.HitTestY(y < 0 ? 0 : (uint)y);
+	int paragraph_y = (int)_paragraphs.GetY(*paragraph);
+	uint paragraph_begin = _paragraphs.GetBegin(*paragraph);
 	BOOL isTrailingHit;
 	BOOL isInside;
 	DWRITE_HIT_TEST_METRICS metrics;
-	_layout->HitTestPoint(static_cast<FLOAT>(point.x), static_cast<FLOAT>(point.y), &isTrailingHit, &isInside, &metrics);
+	if (IsMeasuredInCells(*paragraph)) {
+		bool is_trailing_hit;
+		metrics = HitTestCell(*paragraph, paragraph_begin, static_cast<FLOAT>(point.x), is_trailing_hit);
+		isTrailingHit = is_trailing_hit;
+		isInside = point.x >= 0 && static_cast<FLOAT>(point.x) < metrics.left + metrics.width &&
+			y >= paragraph_y && y < paragraph_y + (int)paragraph->height;
+	} else {
+		GetLayout(*paragraph).HitTestPoint(static_cast<FLOAT>(point.x), static_cast<FLOAT>(y - paragraph_y), &isTrailingHit, &isInside, &metrics);
+	}
+	metrics.textPosition += paragraph_begin;
+	metrics.top += static_cast<FLOAT>(_top + paragraph_y);
 	return HitTestMetricsToInfo(metrics, (bool)isInside, (bool)isTrailingHit);
 }
 
 const TextBlockHitTestInfo TextBlock::HitTestTextPosition(uint text_position) const {
+	GetSize();
+	ref_ptr<Paragraph> paragraph = _paragraphs.HitTestPosition(text_position);
+	uint paragraph_begin = _paragraphs.GetBegin(*paragraph);
+	// Positions in the line break are hit tested as the end of the paragraph, with the line break as the character there.
+	uint layout_length = GetLayoutLength(*paragraph);
+	text_position = min(text_position - paragraph_begin, layout_length);
 	FLOAT x, y;
 	DWRITE_HIT_TEST_METRICS metrics;
-	_layout->HitTestTextPosition(text_position, false, &x, &y, &metrics);
+	if (IsMeasuredInCells(*paragraph)) {
+		metrics = GetCellMetrics(*paragraph, paragraph_begin, text_position);
+	} else {
+		GetLayout(*paragraph).HitTestTextPosition(text_position, false, &x, &y, &metrics);
+	}
+	if (text_position == layout_length) { metrics.length = paragraph->break_length; metrics.width = 0.0F; }
+	metrics.textPosition += paragraph_begin;
+	metrics.top += static_cast<FLOAT>(_top + (int)_paragraphs.GetY(*paragraph));
 	return HitTestMetricsToInfo(metrics, true, false);
 }
 
 void TextBlock::HitTestTextRange(uint text_position, uint text_length, vector<TextBlockHitTestInfo>& geometry_regions) const {
+	GetSize();
+	geometry_regions.clear();
 	vector<DWRITE_HIT_TEST_METRICS> metrics;
 
-	UINT32 line_cnt;
-	_layout->GetLineMetrics((DWRITE_LINE_METRICS1*)nullptr, 0, &line_cnt);
-
-	UINT32 actual_size = line_cnt; // The assumed actual line size.
+	uint text_end = text_position + text_length;
+	ref_ptr<Paragraph> paragraph = _paragraphs.HitTestPosition(text_position);
+	uint paragraph_begin = _paragraphs.GetBegin(*paragraph);
+	int paragraph_y = _top + (int)_paragraphs.GetY(*paragraph);
 	do {
-		metrics.resize(actual_size);
-		_layout->HitTestTextRange(text_position, text_length, 0, 0, metrics.data(), static_cast<UINT32>(metrics.size()), &actual_size);
-	} while (actual_size > metrics.size());
-	metrics.resize(actual_size);
-
-	geometry_regions.resize(metrics.size());
-	for (size_t i = 0; i < geometry_regions.size(); ++i) {
-		geometry_regions[i] = HitTestMetricsToInfo(metrics[i], true, false);
-
-		// Add width for empty lines.
-		if (geometry_regions[i].geometry_region.size.width < 5) { geometry_regions[i].geometry_region.size.width = 5; }
-	}
+		// The line break is hit tested as the end of the paragraph.
+		uint layout_length = GetLayoutLength(*paragraph);
+		uint begin = min(max(text_position, paragraph_begin) - paragraph_begin, layout_length);
+		uint end = min(min(text_end, paragraph_begin + paragraph->length) - paragraph_begin, layout_length);
+
+		if (IsMeasuredInCells(*paragraph)) {
+			// The range is in one line.
+			DWRITE_HIT_TEST_METRICS range = GetCellMetrics(*paragraph, paragraph_begin, begin);
+			range.length = end - begin;
+			range.width = GetCellMetrics(*paragraph, paragraph_begin, end).left - range.left;
+			range.top = static_cast<FLOAT>(paragraph_y);
+			metrics.assign(1, range);
+		} else {
+			UINT32 line_cnt;
+			GetLayout(*paragraph).GetLineMetrics((DWRITE_LINE_METRICS1*)nullptr, 0, &line_cnt);
+
+			UINT32 actual_size = line_cnt; // The assumed actual line size.
+			do {
+				metrics.resize(actual_size);
+				paragraph->layout->HitTestTextRange(begin, end - begin, 0, static_cast<FLOAT>(paragraph_y),
+													metrics.data(), static_cast<UINT32>(metrics.size()), &actual_size);
+			} while (actual_size > metrics.size());
+			metrics.resize(actual_size);
+		}
+
+		for (auto& it : metrics) {
+			it.textPosition += paragraph_begin;
+			geometry_regions.push_back(HitTestMetricsToInfo(it, true, false));
+
+			// Add width for empty lines.
+			if (geometry_regions.back().geometry_region.size.width < 5) { geometry_regions.back().geometry_region.size.width = 5; }
+		}
+
+		paragraph_begin += paragraph->length;
+		paragraph_y += (int)paragraph->height;
+		paragraph = ParagraphIndex::GetNext(*paragraph);
+	} while (paragraph != nullptr && paragraph_begin < text_end);
 }
 
 
@@ -159,41 +604,76 @@ void TextBlock::ShrinkStyle(uint begin, uint length) {
 	for (auto& style : _range_styles) { style.ShrinkStyle(TextRange{ begin, length }); }
 }
 
-void TextBlock::ApplyAllStyles() {
-	for (auto& style : _range_styles) { style.ApplyTo(*_layout); }
-}
-
 void TextBlock::SetStyle(uint begin, uint length, const TextStyleBase& style) {
 	SetStyle(begin, length, style, true);
-	style.ApplyTo(*_layout, TextRange{ begin, length });
+	// Apply the style to the existing layouts, the others will be created with the style.
+	uint end = begin + length;
+	ref_ptr<Paragraph> paragraph = _paragraphs.HitTestPosition(begin);
+	uint paragraph_begin = _paragraphs.GetBegin(*paragraph);
+	for (; paragraph != nullptr && paragraph_begin < end; paragraph = ParagraphIndex::GetNext(*paragraph)) {
+		if (paragraph->layout != nullptr && paragraph->layout_shared) {
+			// Shared layouts are not modified, but laid out again with the style.
+			SafeRelease(&paragraph->layout);
+			paragraph->measured = false;
+			_paragraphs.Update(*paragraph);
+		} else if (paragraph->layout != nullptr) {
+			uint local_begin = max(begin, paragraph_begin) - paragraph_begin;
+			uint local_end = min(end, paragraph_begin + paragraph->length) - paragraph_begin;
+			style.ApplyTo(*paragraph->layout, TextRange{ local_begin, local_end - local_begin });
+			paragraph->measured = false;
+			_paragraphs.Update(*paragraph);
+		} else if (IsMeasuredInCells(*paragraph)) {
+			// Measured in monospace layout without the layout, which may no longer apply with the style.
+			paragraph->measured = false;
+			_paragraphs.Update(*paragraph);
+		}
+		paragraph_begin += paragraph->length;
+	}
+	_is_size_valid = false;
 }
 
 void TextBlock::ClearStyle(uint begin, uint length) {
 	ClearStyle(begin, length, true);
-	TextChanged(); // Just recreate the layout.
+	ResetParagraphs(begin, length); // Just recreate the layouts.
 }
 
-void TextBlock::TextDeleted(uint begin, uint length) {
-	ShrinkStyle(begin, length);
-	TextChanged();
+void TextBlock::SetStyles(uint begin, uint length, const vector<TextStyleRun>& runs) {
+	array<vector<TextStyleRun>, TextStyleBase::_TypeNumber()> runs_by_type;
+	for (auto& run : runs) { runs_by_type[(uint)run.style->GetType()].push_back(run); }
+	vector<TextRange> changed_ranges;
+	for (uint type = 0; type < TextStyleBase::_TypeNumber(); ++type) {
+		_range_styles[type].ReplaceStyles(TextRange{ begin, length }, runs_by_type[type], changed_ranges);
+	}
+	std::sort(changed_ranges.begin(), changed_ranges.end(), [](TextRange a, TextRange b) { return a.begin < b.begin; });
+	ResetLayouts(changed_ranges);
 }
 
-void TextBlock::TextInsertedResetStyle(uint begin, uint length, const vector<unique_ptr<TextStyleBase>>& styles) {
-	ExtendStyle(begin, length);
-	ClearStyle(begin, length, true);
-	for (auto& style : styles) { SetStyle(begin, length, *style, true); }
-	TextChanged();
+void TextBlock::TextReplacedResetStyle(uint begin, uint old_length, uint new_length, const vector<unique_ptr<TextStyleBase>>& styles) {
+	old_length = min(old_length, _paragraphs.GetTextLength() - begin);
+	if (old_length > 0) { ShrinkStyle(begin, old_length); }
+	if (new_length > 0) {
+		ExtendStyle(begin, new_length);
+		ClearStyle(begin, new_length, true);
+		for (auto& style : styles) { SetStyle(begin, new_length, *style, true); }
+	}
+	UpdateParagraphs(begin, old_length, new_length);
 }
 
-void TextBlock::TextInsertedMergeStyle(uint begin, uint length, const vector<unique_ptr<TextStyleBase>>& styles) {
-	ExtendStyle(begin, length);
-	for (auto& style : styles) { SetStyle(begin, length, *style, true); }
-	TextChanged();
+void TextBlock::TextReplacedMergeStyle(uint begin, uint old_length, uint new_length, const vector<unique_ptr<TextStyleBase>>& styles) {
+	old_length = min(old_length, _paragraphs.GetTextLength() - begin);
+	if (old_length > 0) { ShrinkStyle(begin, old_length); }
+	if (new_length > 0) {
+		ExtendStyle(begin, new_length);
+		for (auto& style : styles) { SetStyle(begin, new_length, *style, true); }
+	}
+	UpdateParagraphs(begin, old_length, new_length);
 }
 
-void TextBlock::TextInsertedWithoutStyle(uint begin, uint length) {
-	ExtendStyle(begin, length);
-	TextChanged();
+void TextBlock::TextReplacedWithoutStyle(uint begin, uint old_length, uint new_length) {
+	old_length = min(old_length, _paragraphs.GetTextLength() - begin);
+	if (old_length > 0) { ShrinkStyle(begin, old_length); }
+	if (new_length > 0) { ExtendStyle(begin, new_length); }
+	UpdateParagraphs(begin, old_length, new_length);
 }
 
 
@@ -1,11 +1,17 @@
 #pragma once
 
 #include "figure_base.h"
+#include "paragraph_index.h"
 #include "../style/text_block_style.h"
 #include "../style/text_style.h"
+#include "../common/text_buffer.h"
 
 #include <array>
 #include <vector>
+#include <functional>
+
+
+struct DWRITE_HIT_TEST_METRICS;
 
 
 BEGIN_NAMESPACE(WndDesign)
@@ -16,28 +22,102 @@ using std::vector;
 
 class TextBlock : Uncopyable {
 public:
-	TextBlock(wstring& text, TextBlockStyle& style);
+	TextBlock(const TextBuffer& text, const TextBlockStyle& style);
 	~TextBlock();
 
 
 	//// text layout ////
 private:
-	const wstring& _text;
-	const TextBlockStyle& _style;
+	const TextBuffer& _text;
+	ref_ptr<const TextBlockStyle> _style;
 private:
 	alloc_ptr<TextLayout> _format;
-	alloc_ptr<TextLayout> _layout;
+	mutable ParagraphIndex _paragraphs;  // each paragraph has its own layout, laid out lazily
 	mutable Size _max_size;
 	mutable Size _size;
+	mutable int _top;  // offset of the first paragraph for paragraph alignment
+	mutable bool _is_size_valid;
 public:
-	const Size GetSize() const { return _size; }
-	TextLayout& GetLayout() const { return *_layout; }
-	const TextBlockStyle& GetDefaultStyle() const { return _style; }
+	const Size GetSize() const { if (!_is_size_valid) { UpdateSize(); } return _size; }
+	const TextBlockStyle& GetDefaultStyle() const { return *_style; }
+	// The style must have the same value, for the text layout is not updated.
+	void SetDefaultStyle(const TextBlockStyle& style) { _style = &style; }
 private:
+	void CreateLayout(ParagraphIndex::Paragraph& paragraph, uint begin) const;
+	TextLayout& GetLayout(ParagraphIndex::Paragraph& paragraph) const;
+	void MeasureParagraph(ParagraphIndex::Paragraph& paragraph) const;
 	void UpdateSize() const;
+	// Recreate the paragraphs covering [begin, begin + old_length) of the old text, which is replaced by new_length characters.
+	void UpdateParagraphs(uint begin, uint old_length, uint new_length);
+	// Split [begin, end) of the text into paragraphs inserted before the paragraph at index.
+	void InsertParagraphs(uint index, uint begin, uint end);
+	// Recreate the layouts of the paragraphs covering [begin, begin + length).
+	void ResetParagraphs(uint begin, uint length) { UpdateParagraphs(begin, length, length); }
+	// Release the layouts of the paragraphs intersecting the sorted ranges, which will be laid out again.
+	void ResetLayouts(const vector<TextRange>& ranges);
 public:
 	void TextChanged();
 	void AutoResize(Size max_size) const;
+	// Text layout is calculated lazily when the size is first queried, which can be done in advance on worker threads.
+	void PrepareLayout() const { GetSize(); }
+	// Calls func(layout, point, line_region) for the layout of each laid out paragraph overlapping the region, with its
+	//   position in the text block and the region of its lines overlapping the region relative to the position.
+	void ForEachLayout(Rect region, std::function<void(TextLayout&, Point, Rect)> func) const;
+	// Paragraphs are the lines of the text separated by line breaks, and are found by text position or by index in 
+	//   O(log n), as for line navigation. There is at least one paragraph, and the range includes the line break.
+	uint GetParagraphNumber() const { return _paragraphs.GetParagraphNumber(); }
+	uint GetParagraphIndex(uint text_position) const;
+	const TextRange GetParagraphRange(uint index) const;
+
+	// Virtual layout: only the paragraphs overlapping the layout region are laid out, and the heights of the others
+	//   are estimated from the average line height and character width of the measured paragraphs, so the time to 
+	//   lay out a large text doesn't depend on its length. Estimated heights are kept until the paragraphs are in 
+	//   the layout region, and the estimation is refined as more paragraphs are measured.
+private:
+	bool _is_virtual;
+	mutable Rect _layout_region;
+	mutable uint64 _measured_line_number;
+	mutable double _measured_line_height_sum;
+	mutable uint64 _measured_char_number;  // of single-line paragraphs, for estimating line wrapping
+	mutable double _measured_char_width_sum;
+private:
+	void ResetEstimation();
+	uint EstimateHeight(uint length) const;
+	ParagraphIndex::HeightEstimator GetHeightEstimator() const;
+public:
+	bool IsVirtual() const { return _is_virtual; }
+	void SetVirtual(bool is_virtual);
+	// Set the region to lay out in virtual layout, returns false if there are paragraphs in the region to be laid out.
+	bool SetLayoutRegion(Rect region) const;
+	// Returns the text position of the paragraph at y, and the y of the paragraph at a text position, 
+	//   which are used to keep the paragraph still when the estimated heights above it are refined.
+	uint HitTestParagraph(int y) const;
+	int GetParagraphY(uint text_position) const;
+	// Monospace layout: paragraphs of plain or color-only text in a monospace font that fit in one line are measured 
+	//   and hit tested arithmetically with the cell metrics of the font, and the layouts are only created for drawing.
+	//   Tabs advance to the tab stops, and wide characters take the width of an ideograph if the fallback fonts agree,
+	//   other paragraphs are laid out as usual.
+private:
+	struct CellMetrics {
+		float width = 0.0f;  // 0 if the font is not monospace
+		float wide_width = 0.0f;  // 0 if the wide characters don't have the same width
+		float line_height = 0.0f;
+		float tab_width = 0.0f;
+	};
+	bool _is_monospace;
+	CellMetrics _cell;
+private:
+	void ResetCellMetrics();
+	// Calls func(offset, left, right) for the characters in [begin, begin + length) in one line until func returns false.
+	template<class Func>
+	void ForEachCell(uint begin, uint length, Func func) const;
+	// Measures a paragraph with the cell metrics, returns false if it must be laid out.
+	bool MeasureCells(ParagraphIndex::Paragraph& paragraph, uint begin, float& width) const;
+	const DWRITE_HIT_TEST_METRICS GetCellMetrics(const ParagraphIndex::Paragraph& paragraph, uint begin, uint offset) const;
+	const DWRITE_HIT_TEST_METRICS HitTestCell(const ParagraphIndex::Paragraph& paragraph, uint begin, float x, bool& is_trailing_hit) const;
+public:
+	bool IsMonospace() const { return _is_monospace && _cell.width > 0.0f; }
+	void SetMonospace(bool is_monospace);
 public:
 	const TextBlockHitTestInfo HitTestPoint(Point point) const;
 	const TextBlockHitTestInfo HitTestTextPosition(uint text_position) const;
@@ -53,35 +133,43 @@ private:
 	void ClearStyle(uint begin, uint length, bool internal_use_tag);
 	void ExtendStyle(uint begin, uint length);
 	void ShrinkStyle(uint begin, uint length);
-	void ApplyAllStyles();
 
 	// Set or clear the style of a text range.
 public:
 	void SetStyle(uint begin, uint length, const TextStyleBase& style);
 	void ClearStyle(uint begin, uint length);
+	// Replace the styles of a text range with the runs sorted by position, as for syntax highlighting. Only the 
+	//   paragraphs where the styles have changed are laid out again.
+	void SetStyles(uint begin, uint length, const vector<TextStyleRun>& runs);
 
-	// Update layout and styles when text inserted or deleted.
+	// Update layout and styles when text inserted, deleted or replaced. Only the paragraphs touched are laid out again.
 public:
-	void TextDeleted(uint begin, uint length);
-	void TextInsertedResetStyle(uint begin, uint length, const vector<unique_ptr<TextStyleBase>>& styles);
-	void TextInsertedMergeStyle(uint begin, uint length, const vector<unique_ptr<TextStyleBase>>& styles);
-	void TextInsertedWithoutStyle(uint begin, uint length);
-
-	void TextReplacedResetStyle(uint begin, uint old_length, uint new_length, const vector<unique_ptr<TextStyleBase>>& styles) {
-		ShrinkStyle(begin, old_length);
-		TextInsertedResetStyle(begin, new_length, styles);
-	}
-	void TextReplacedMergeStyle(uint begin, uint old_length, uint new_length, const vector<unique_ptr<TextStyleBase>>& styles) {
-		ShrinkStyle(begin, old_length);
-		TextInsertedMergeStyle(begin, new_length, styles);
+	void TextReplacedResetStyle(uint begin, uint old_length, uint new_length, const vector<unique_ptr<TextStyleBase>>& styles);
+	void TextReplacedMergeStyle(uint begin, uint old_length, uint new_length, const vector<unique_ptr<TextStyleBase>>& styles);
+	void TextReplacedWithoutStyle(uint begin, uint old_length, uint new_length);
+
+	void TextDeleted(uint begin, uint length) { TextReplacedWithoutStyle(begin, length, 0); }
+	void TextInsertedResetStyle(uint begin, uint length, const vector<unique_ptr<TextStyleBase>>& styles) {
+		TextReplacedResetStyle(begin, 0, length, styles);
 	}
-	void TextReplacedWithoutStyle(uint begin, uint old_length, uint new_length) {
-		ShrinkStyle(begin, old_length);
-		TextInsertedWithoutStyle(begin, new_length);
+	void TextInsertedMergeStyle(uint begin, uint length, const vector<unique_ptr<TextStyleBase>>& styles) {
+		TextReplacedMergeStyle(begin, 0, length, styles);
 	}
+	void TextInsertedWithoutStyle(uint begin, uint length) { TextReplacedWithoutStyle(begin, 0, length); }
 };
 
 
+// Draws the lines of a paragraph layout in the line region, only the lines overlapping the clip region are rasterized.
+struct TextLayoutFigure : Figure {
+	TextLayout& layout;
+	Rect line_region;
+	Color color;
+
+	TextLayoutFigure(TextLayout& layout, Rect line_region, Color color) : layout(layout), line_region(line_region), color(color) {}
+	virtual const Rect GetRegion() const override { return line_region; }
+	virtual void DrawOn(RenderTarget& target, Vector offset) const override; // defined in figure_types.cpp
+};
+
 struct TextBlockFigure : Figure {
 	const TextBlock& text_block;
 
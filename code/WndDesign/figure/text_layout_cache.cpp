@@ -0,0 +1,199 @@
+#include "text_layout_cache.h"
+#include "../system/directx/directx_helper.h"
+#include "../system/directx/dwrite_api.h"
+
+#include <map>
+#include <list>
+#include <tuple>
+#include <mutex>
+#include <unordered_map>
+
+
+BEGIN_NAMESPACE(WndDesign)
+
+BEGIN_NAMESPACE(Anonymous)
+
+
+IDWriteTextFormat* CreateTextFormat(const TextBlockStyle& style) {
+	IDWriteTextFormat* format = nullptr;
+	hr << GetDWriteFactory().CreateTextFormat(
+		style.font._family.c_str(),
+		NULL,
+		static_cast<DWRITE_FONT_WEIGHT>(style.font._weight),
+		static_cast<DWRITE_FONT_STYLE>(style.font._style),
+		static_cast<DWRITE_FONT_STRETCH>(style.font._stretch),
+		static_cast<FLOAT>(style.font._size),
+		style.font._locale.c_str(),
+		&format
+	);
+
+	// Set paragraph styles on the format, which are inherited by the layouts of all paragraphs.
+	format->SetTextAlignment(static_cast<DWRITE_TEXT_ALIGNMENT>(style.paragraph._text_align));
+	format->SetParagraphAlignment(DWRITE_PARAGRAPH_ALIGNMENT_NEAR);
+	format->SetFlowDirection(static_cast<DWRITE_FLOW_DIRECTION>(style.paragraph._flow_direction));
+	format->SetReadingDirection(static_cast<DWRITE_READING_DIRECTION>(style.paragraph._read_direction));
+	format->SetWordWrapping(static_cast<DWRITE_WORD_WRAPPING>(style.paragraph._word_wrap));
+	ValueTag line_height = style.paragraph._line_height;
+	if (line_height.IsPixel()) {
+		format->SetLineSpacing(DWRITE_LINE_SPACING_METHOD_UNIFORM, static_cast<FLOAT>(line_height.AsUnsigned()), 0.7F * line_height.AsUnsigned());
+	} else if (line_height.IsPercent()) {
+		format->SetLineSpacing(DWRITE_LINE_SPACING_METHOD_PROPORTIONAL, line_height.AsUnsigned() / 100.0F, line_height.AsUnsigned() / 110.0F);
+	} else {
+		format->SetLineSpacing(DWRITE_LINE_SPACING_METHOD_DEFAULT, 0.0F, 0.0F);  // The last two parameters are ignored.
+	}
+	ValueTag tab_size = style.paragraph._tab_size;
+	if (tab_size.IsPixel()) {
+		format->SetIncrementalTabStop(static_cast<FLOAT>(tab_size.AsUnsigned()));
+	} 	else if (tab_size.IsPercent()) {
+		format->SetIncrementalTabStop(static_cast<FLOAT>(tab_size.AsUnsigned()) * style.font._size / 100.0F);
+	}
+	return format;
+}
+
+inline std::pair<int, int> ValueTagKey(ValueTag value) {
+	return { value.IsPixel() ? 1 : value.IsPercent() ? 2 : 0, value.AsSigned() };
+}
+
+
+struct TextFormatCache {
+public:
+	using Key = std::tuple<
+		wstring, wstring, FontWeight, FontStyle, FontStretch, float,
+		TextAlign, FlowDirection, ReadDirection, WordWrap, std::pair<int, int>, std::pair<int, int>
+	>;
+public:
+	std::mutex mutex;
+	std::map<Key, IDWriteTextFormat*> formats;
+public:
+	TextFormatCache() { GetDWriteFactory(); }  // The factory is destroyed after the cache.
+	~TextFormatCache() { for (auto& [key, format] : formats) { SafeRelease(&format); } }
+public:
+	IDWriteTextFormat* Get(const TextBlockStyle& style) {
+		Key key(
+			style.font._family, style.font._locale, style.font._weight, style.font._style, style.font._stretch, style.font._size,
+			style.paragraph._text_align, style.paragraph._flow_direction, style.paragraph._read_direction, style.paragraph._word_wrap,
+			ValueTagKey(style.paragraph._line_height), ValueTagKey(style.paragraph._tab_size)
+		);
+		std::lock_guard<std::mutex> lock(mutex);
+		auto [it, inserted] = formats.emplace(std::move(key), nullptr);
+		if (inserted) { it->second = CreateTextFormat(style); }
+		it->second->AddRef();
+		return it->second;
+	}
+};
+
+
+struct TextLayoutCache {
+public:
+	static constexpr uint max_text_length = 256;  // only short texts like labels are shared
+public:
+	struct Key {
+		wstring text;
+		ref_ptr<IDWriteTextFormat> format;  // formats are never destroyed during the process
+		Size max_size;
+		bool operator==(const Key& key) const { return text == key.text && format == key.format && max_size == key.max_size; }
+	};
+	struct KeyHash {
+		size_t operator()(const Key& key) const {
+			size_t hash = std::hash<wstring>()(key.text);
+			hash = hash * 31 + std::hash<ref_ptr<IDWriteTextFormat>>()(key.format);
+			hash = hash * 31 + key.max_size.width;
+			hash = hash * 31 + key.max_size.height;
+			return hash;
+		}
+	};
+	using Entry = std::pair<Key, TextLayout*>;
+public:
+	std::mutex mutex;
+	uint capacity = 1024;
+	std::list<Entry> entries;  // the most recently used first
+	std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> index;
+public:
+	TextLayoutCache() { GetDWriteFactory(); }
+	~TextLayoutCache() { SetCapacity(0); }
+private:
+	void Evict() {
+		while (entries.size() > capacity) {
+			index.erase(entries.back().first);
+			SafeRelease(&entries.back().second);
+			entries.pop_back();
+		}
+	}
+public:
+	void SetCapacity(uint capacity) {
+		std::lock_guard<std::mutex> lock(mutex);
+		this->capacity = capacity;
+		Evict();
+	}
+	TextLayout* Get(const wchar text[], uint length, IDWriteTextFormat& format, Size max_size) {
+		if (length > max_text_length) { return nullptr; }
+		Key key{ wstring(text, length), &format, max_size };
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			if (capacity == 0) { return nullptr; }
+			if (auto it = index.find(key); it != index.end()) {
+				entries.splice(entries.begin(), entries, it->second);
+				entries.front().second->AddRef();
+				return entries.front().second;
+			}
+		}
+
+		// The text is shaped without the lock, so that threads laying out other texts don't wait for it.
+		TextLayout* layout = nullptr;
+		hr << GetDWriteFactory().CreateTextLayout(
+			text, static_cast<UINT>(length), &format, (FLOAT)max_size.width, (FLOAT)max_size.height,
+			reinterpret_cast<IDWriteTextLayout**>(&layout)
+		);
+		// Shape the text now, so that the layout is only read when shared.
+		DWRITE_TEXT_METRICS1 metrics;
+		layout->GetMetrics(&metrics);
+
+		// If another thread has shaped the same text meanwhile, its layout is shared and this one is dropped.
+		TextLayout* duplicate = nullptr;
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			if (capacity == 0) { return layout; }  // not cached, but still read only
+			if (auto it = index.find(key); it != index.end()) {
+				entries.splice(entries.begin(), entries, it->second);
+				duplicate = layout; layout = entries.front().second;
+			} else {
+				entries.emplace_front(key, layout);
+				index.emplace(std::move(key), entries.begin());
+				Evict();
+			}
+			layout->AddRef();
+		}
+		SafeRelease(&duplicate);
+		return layout;
+	}
+};
+
+
+TextFormatCache& GetTextFormatCache() {
+	static TextFormatCache cache;
+	return cache;
+}
+
+TextLayoutCache& GetTextLayoutCache() {
+	static TextLayoutCache cache;
+	return cache;
+}
+
+
+END_NAMESPACE(Anonymous)
+
+
+IDWriteTextFormat* GetTextFormat(const TextBlockStyle& style) {
+	return GetTextFormatCache().Get(style);
+}
+
+TextLayout* GetSharedTextLayout(const wchar text[], uint length, IDWriteTextFormat& format, Size max_size) {
+	return GetTextLayoutCache().Get(text, length, format, max_size);
+}
+
+void SetTextLayoutCacheCapacity(uint capacity) {
+	GetTextLayoutCache().SetCapacity(capacity);
+}
+
+
+END_NAMESPACE(WndDesign)
\ No newline at end of file
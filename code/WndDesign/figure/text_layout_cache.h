@@ -0,0 +1,29 @@
+#pragma once
+
+#include "../geometry/geometry.h"
+#include "../style/text_block_style.h"
+
+
+struct IDWriteTextFormat;
+
+
+BEGIN_NAMESPACE(WndDesign)
+
+struct TextLayout;  // An alias for IDWriteTextLayout.
+
+
+// Text formats and shaped text layouts shared by all text blocks of the process.
+
+// Returns the text format of the font and paragraph styles with a new reference. The text format for the same 
+//   styles is created only once, and must not be modified.
+IDWriteTextFormat* GetTextFormat(const TextBlockStyle& style);
+
+// Returns the shaped layout of the text with the format and max size with a new reference, or nullptr if the text 
+//   is too long to be shared. Recently used layouts are kept, and the shared layouts must not be modified.
+TextLayout* GetSharedTextLayout(const wchar text[], uint length, IDWriteTextFormat& format, Size max_size);
+
+// Set the max number of the recently used layouts to keep, 0 for not sharing layouts.
+void SetTextLayoutCacheCapacity(uint capacity);
+
+
+END_NAMESPACE(WndDesign)
\ No newline at end of file
@@ -17,7 +17,7 @@ public:
 
 private:
 	static constexpr uint period = 40;  // 40ms
-	struct WndHelper : public Wnd { public: Wnd::GetStyle; Wnd::CompositeEffectChanged; };
+	struct WndHelper : public Wnd { public: Wnd::GetStyle; Wnd::ModifyStyle; Wnd::CompositeEffectChanged; };
 
 private:
 	WndHelper& wnd;
@@ -35,7 +35,7 @@ private:
 
 private:
 	void OnTimer() {
-		uchar& current_opacity = wnd.GetStyle().composite._opacity;
+		uchar& current_opacity = wnd.ModifyStyle().composite._opacity;
 		if (current_opacity == target_opacity) {
 			timer.Stop(); callback(); return;
 		}
@@ -48,10 +48,10 @@ private:
 public:
 	void Set(uint time_to_finish, uchar target_opacity = 0) {
 		Stop();
-		uchar& current_opacity = wnd.GetStyle().composite._opacity;
+		uchar current_opacity = wnd.GetStyle().composite._opacity;
 		if (time_to_finish == 0) {
 			if (target_opacity != current_opacity) {
-				current_opacity = target_opacity; 
+				wnd.ModifyStyle().composite._opacity = target_opacity; 
 				wnd.CompositeEffectChanged();
 			}
 			callback(); return;
@@ -35,6 +35,7 @@ class DefaultBorderResizer : public BorderResizer {
 public:
 	DefaultBorderResizer() {}
 	~DefaultBorderResizer() {}
+	virtual unique_ptr<BorderResizer> Clone() const override { return std::make_unique<DefaultBorderResizer>(*this); }
 
 private:
 	bool _is_mouse_down = false;
@@ -105,6 +106,7 @@ class AeroSnapBorderResizer : public BorderResizer {
 public:
 	AeroSnapBorderResizer() {}
 	~AeroSnapBorderResizer() {}
+	virtual unique_ptr<BorderResizer> Clone() const override { return std::make_unique<AeroSnapBorderResizer>(*this); }
 private:
 	virtual void Handler(Wnd& wnd, Rect window_region, uint border_width, Msg msg, Para para) override {
 		if (IsMouseMsg(msg)) {
@@ -122,5 +124,10 @@ unique_ptr<BorderResizer> CreateEmptyBorderResizer() { return std::make_unique<B
 unique_ptr<BorderResizer> CreateDefaultBorderResizer() { return std::make_unique<DefaultBorderResizer>(); }
 unique_ptr<BorderResizer> CreateAeroSnapBorderResizer() { return std::make_unique<AeroSnapBorderResizer>(); }
 
+shared_ptr<const BorderResizer> GetEmptyBorderResizer() {
+	static shared_ptr<const BorderResizer> empty_resizer = CreateEmptyBorderResizer();
+	return empty_resizer;
+}
+
 
 END_NAMESPACE(WndDesign)
\ No newline at end of file
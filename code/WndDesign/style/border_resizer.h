@@ -10,6 +10,7 @@
 BEGIN_NAMESPACE(WndDesign)
 
 using std::unique_ptr;
+using std::shared_ptr;
 
 class Wnd;
 
@@ -18,6 +19,9 @@ class BorderResizer {
 public:
 	BorderResizer() {}
 	virtual ~BorderResizer() {}
+public:
+	// The resizer in a style is a prototype, each window uses its own clone. Derived resizers override it to copy themselves.
+	virtual unique_ptr<BorderResizer> Clone() const { return std::make_unique<BorderResizer>(*this); }
 public:
 	virtual void Handler(Wnd& wnd, Rect window_region, uint border_width, Msg msg, Para para);
 protected:
@@ -31,5 +35,8 @@ unique_ptr<BorderResizer> CreateEmptyBorderResizer();
 unique_ptr<BorderResizer> CreateDefaultBorderResizer();
 unique_ptr<BorderResizer> CreateAeroSnapBorderResizer();
 
+// The empty resizer shared by styles as the default prototype, so that default styles compare equal.
+shared_ptr<const BorderResizer> GetEmptyBorderResizer();
+
 
 END_NAMESPACE(WndDesign)
\ No newline at end of file
@@ -21,6 +21,7 @@ class DefaultScrollbar : public Scrollbar {
 public:
 	DefaultScrollbar() {}
 	virtual ~DefaultScrollbar() override {}
+	virtual unique_ptr<Scrollbar> Clone() const override { return std::make_unique<DefaultScrollbar>(*this); }
 
 	// scroll offset update
 private:
@@ -156,5 +157,15 @@ public:
 unique_ptr<Scrollbar> CreateEmptyScrollbar() { return std::make_unique<Scrollbar>(); }
 unique_ptr<Scrollbar> CreateDefaultScrollbar() { return std::make_unique<DefaultScrollbar>(); }
 
+shared_ptr<const Scrollbar> GetEmptyScrollbar() {
+	static shared_ptr<const Scrollbar> empty_scrollbar = CreateEmptyScrollbar();
+	return empty_scrollbar;
+}
+
+shared_ptr<const Scrollbar> GetDefaultScrollbar() {
+	static shared_ptr<const Scrollbar> default_scrollbar = CreateDefaultScrollbar();
+	return default_scrollbar;
+}
+
 
 END_NAMESPACE(WndDesign)
\ No newline at end of file
@@ -10,6 +10,7 @@
 BEGIN_NAMESPACE(WndDesign)
 
 using std::unique_ptr;
+using std::shared_ptr;
 
 class FigureQueue;
 class Wnd;
@@ -20,6 +21,10 @@ public:
 	Scrollbar() {}
 	virtual ~Scrollbar() {}
 
+	// The scrollbar in a style is a prototype, each window uses its own clone. Derived scrollbars override it to copy themselves.
+public:
+	virtual unique_ptr<Scrollbar> Clone() const { return std::make_unique<Scrollbar>(*this); }
+
 	// scroll offset update
 public:
 	virtual void Update(Wnd& wnd, Rect region, Size entire_size, Rect display_region) { _region = region; }
@@ -57,5 +62,9 @@ protected:
 unique_ptr<Scrollbar> CreateEmptyScrollbar();
 unique_ptr<Scrollbar> CreateDefaultScrollbar();
 
+// The scrollbars shared by styles as prototypes, so that the styles using them compare equal.
+shared_ptr<const Scrollbar> GetEmptyScrollbar();
+shared_ptr<const Scrollbar> GetDefaultScrollbar();
+
 
 END_NAMESPACE(WndDesign)
\ No newline at end of file
@@ -9,10 +9,55 @@
 BEGIN_NAMESPACE(WndDesign)
 
 
-// a helper class for calculating region from style
-struct StyleCalculator : public WndStyle {
+// The region styles of a window, overridden by the window itself when its region is specified by parent window 
+//   or resized by border resizer, so that the style shared with other windows needn't be copied.
+struct RegionStyle {
+public:
+	using LengthStyle = WndStyle::LengthStyle;
+	using PositionStyle = WndStyle::PositionStyle;
+public:
+	LengthStyle width;
+	LengthStyle height;
+	PositionStyle position;
+	uint border_width;
+public:
+	RegionStyle(const WndStyle& style) : width(style.width), height(style.height), position(style.position), border_width(style.border._width) {}
+
+	void ResetRegionOnParent(Rect region_on_parent, Size parent_size) {
+		Margin margin_to_parent = CalculateRelativeMargin(parent_size, region_on_parent);
+		position.set(px(margin_to_parent.left), px(margin_to_parent.top), px(margin_to_parent.right), px(margin_to_parent.bottom));
+		width.normal(px(region_on_parent.size.width)); height.normal(px(region_on_parent.size.height));
+	}
+	void ResetRegionOnParent(Rect old_region_on_parent, Margin margin_to_extend, Size size_min, Size size_max);
+};
+
+
+// a helper class for calculating region from style, with the region styles overridden by the window if any
+struct StyleCalculator {
+public:
+	using LengthStyle = WndStyle::LengthStyle;
+	using PositionStyle = WndStyle::PositionStyle;
+	using BorderStyle = WndStyle::BorderStyle;
+	using PaddingStyle = WndStyle::PaddingStyle;
+	using ClientStyle = WndStyle::ClientStyle;
 private:
-	StyleCalculator() = delete;
+	const LengthStyle& width;
+	const LengthStyle& height;
+	const PositionStyle& position;
+	const BorderStyle& border;
+	const uint border_width;
+	const PaddingStyle& padding;
+	const ClientStyle& client;
+public:
+	StyleCalculator(const WndStyle& style, ref_ptr<const RegionStyle> region_style = nullptr) :
+		width(region_style ? region_style->width : style.width),
+		height(region_style ? region_style->height : style.height),
+		position(region_style ? region_style->position : style.position),
+		border(style.border),
+		border_width(region_style ? region_style->border_width : style.border._width),
+		padding(style.padding),
+		client(style.client) {
+	}
 
 	// style dependency identification
 public:
@@ -31,9 +76,6 @@ public:
 	static bool IsPaddingRelative(const PaddingStyle& padding) {
 		return padding._left.IsPercent() || padding._top.IsPercent() || padding._right.IsPercent() || padding._bottom.IsPercent();
 	}
-	static bool IsScrollbarAuto(const ScrollbarStyle& scrollbar) {
-		return scrollbar._resource->IsMarginAuto();
-	}
 	static bool IsClientRelative(const ClientStyle& client) {
 		return client._left.IsPercent() || client._top.IsPercent() || IsLengthRelative(client.width) || IsLengthRelative(client.height);
 	}
@@ -54,12 +96,25 @@ public:
 	bool IsRegionOnParentAuto() const {
 		return IsRegionHorizontalAuto() || IsRegionVerticalAuto();
 	}
+public:
+	// If the interval on parent is calculated with the parent length, other than checking it is zero.
+	static bool IsIntervalRelative(const LengthStyle& length, ValueTag position_low, ValueTag position_high) {
+		if (IsLengthRelative(length) || position_low.IsPercent() || position_high.IsPercent() || position_low.IsCenter()) { return true; }
+		if (position_low.IsAuto()) { return !position_high.IsAuto(); }  // aligned to the high edge
+		return IsLengthAuto(length) && !IsPositionAuto(position_high);  // stretched between both edges
+	}
+	// Keeps the parent lengths the region on parent depends on, the others are only distinguished from zero.
+	// Parent sizes that have the same dependency result in the same region on parent and min max size.
+	const Size GetParentSizeDependency(Size parent_size) const {
+		auto dependency = [](bool is_relative, uint parent_length) { return is_relative || parent_length == 0 ? parent_length : (uint)-1; };
+		return Size(
+			dependency(IsIntervalRelative(width, position._left, position._right), parent_size.width),
+			dependency(IsIntervalRelative(height, position._top, position._bottom), parent_size.height)
+		);
+	}
 	bool IsMarginRelative() const {
 		return IsPaddingRelative(padding);
 	}
-	bool IsMarginAuto() const {
-		return IsScrollbarAuto(scrollbar);
-	}
 	bool IsClientRegionRelative() const {
 		return IsClientRelative(client);
 	}
@@ -136,60 +191,25 @@ public:
 			CalculateLength(height, position._top, position._bottom, parent_size.height)
 		);
 	}
-	void ResetRegionOnParent(Rect region_on_parent, Size parent_size) {
-		Margin margin_to_parent = CalculateRelativeMargin(parent_size, region_on_parent);
-		position.set(px(margin_to_parent.left), px(margin_to_parent.top), px(margin_to_parent.right), px(margin_to_parent.bottom));
-		width.normal(px(region_on_parent.size.width)); height.normal(px(region_on_parent.size.height));
-	}
-	void ResetRegionOnParent(Rect old_region_on_parent, Margin margin_to_extend, Size size_min, Size size_max) {
-		if (margin_to_extend.left) {
-			uint new_width = (uint)((int)old_region_on_parent.size.width + margin_to_extend.left);
-			new_width = Clamp(new_width, size_min.width, size_max.width);
-			int new_left = old_region_on_parent.point.x + (int)old_region_on_parent.size.width - (int)new_width;
-			width.normal(px(new_width)); position.left(px(new_left));
-		}
-		if (margin_to_extend.top) {
-			uint new_height = (uint)((int)old_region_on_parent.size.height + margin_to_extend.top);
-			new_height = Clamp(new_height, size_min.height, size_max.height);
-			int new_top = old_region_on_parent.point.y + (int)old_region_on_parent.size.height - (int)new_height;
-			height.normal(px(new_height)); position.top(px(new_top));
-		}
-		if (margin_to_extend.right) { 
-			uint new_width = (uint)((int)old_region_on_parent.size.width + margin_to_extend.right);
-			new_width = Clamp(new_width, size_min.width, size_max.width);
-			width.normal(px(new_width)); position.left(px(old_region_on_parent.point.x));
-		}
-		if (margin_to_extend.bottom) { 
-			uint new_height = (uint)((int)old_region_on_parent.size.height + margin_to_extend.bottom);
-			new_height = Clamp(new_height, size_min.height, size_max.height);
-			height.normal(px(new_height)); position.top(px(old_region_on_parent.point.y));
-		}
-	}
-	bool HasScrollbar() const {
-		return scrollbar._resource->IsVisible();
-	}
-	const Margin GetScrollbarMargin() const {
-		return scrollbar._resource->GetMargin();
-	}
 	bool HasBorder() const { 
-		return border._width > 0 && border._color != color_transparent; 
+		return border_width > 0 && border._color != color_transparent; 
 	}
 	unique_ptr<Figure> GetBorder(Size display_size) const { 
 		if (border._radius > 0) {
-			return std::make_unique<RoundedRectangle>(display_size, border._radius, (float)border._width, border._color);
+			return std::make_unique<RoundedRectangle>(display_size, border._radius, (float)border_width, border._color);
 		} else {
-			return std::make_unique<Rectangle>(display_size, (float)border._width, border._color);
+			return std::make_unique<Rectangle>(display_size, (float)border_width, border._color);
 		}
 	}
 	bool HitTestBorder(Size display_size, Point point) const {
 		Rect display_region = Rect(point_zero, display_size);
-		return display_region.Contains(point) && !ShrinkRegionByLength(display_region, border._width).Contains(point);
+		return display_region.Contains(point) && !ShrinkRegionByLength(display_region, border_width).Contains(point);
 	}
 	bool IsPointInside(Size display_size, Point point) const {
 		return PointInRoundedRectangle(display_size, border._radius, point);
 	}
 	const Margin CalculateBorderMargin() const {
-		return { (int)border._width, (int)border._width, (int)border._width, (int)border._width };
+		return { (int)border_width, (int)border_width, (int)border_width, (int)border_width };
 	}
 	const Rect GetDisplayRegionWithoutBorder(Size display_size) const {
 		return ShrinkRegionByMargin(Rect(point_zero, display_size), CalculateBorderMargin());
@@ -241,9 +261,29 @@ public:
 };
 
 
-inline const StyleCalculator& GetStyleCalculator(const WndStyle& style) {
-	static_assert(sizeof(StyleCalculator) == sizeof(WndStyle));
-	return static_cast<const StyleCalculator&>(style);
+inline void RegionStyle::ResetRegionOnParent(Rect old_region_on_parent, Margin margin_to_extend, Size size_min, Size size_max) {
+	if (margin_to_extend.left) {
+		uint new_width = (uint)((int)old_region_on_parent.size.width + margin_to_extend.left);
+		new_width = StyleCalculator::Clamp(new_width, size_min.width, size_max.width);
+		int new_left = old_region_on_parent.point.x + (int)old_region_on_parent.size.width - (int)new_width;
+		width.normal(px(new_width)); position.left(px(new_left));
+	}
+	if (margin_to_extend.top) {
+		uint new_height = (uint)((int)old_region_on_parent.size.height + margin_to_extend.top);
+		new_height = StyleCalculator::Clamp(new_height, size_min.height, size_max.height);
+		int new_top = old_region_on_parent.point.y + (int)old_region_on_parent.size.height - (int)new_height;
+		height.normal(px(new_height)); position.top(px(new_top));
+	}
+	if (margin_to_extend.right) { 
+		uint new_width = (uint)((int)old_region_on_parent.size.width + margin_to_extend.right);
+		new_width = StyleCalculator::Clamp(new_width, size_min.width, size_max.width);
+		width.normal(px(new_width)); position.left(px(old_region_on_parent.point.x));
+	}
+	if (margin_to_extend.bottom) { 
+		uint new_height = (uint)((int)old_region_on_parent.size.height + margin_to_extend.bottom);
+		new_height = StyleCalculator::Clamp(new_height, size_min.height, size_max.height);
+		height.normal(px(new_height)); position.top(px(old_region_on_parent.point.y));
+	}
 }
 
 
@@ -0,0 +1,98 @@
+#pragma once
+
+#include "wnd_style.h"
+
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <type_traits>
+
+
+BEGIN_NAMESPACE(WndDesign)
+
+using std::shared_ptr;
+using std::weak_ptr;
+
+
+// Reference-counted window style, which may be shared by many windows and is copied when modified
+//   by a window that is sharing it.
+// The copy function is captured when the style is created, so that derived styles are copied without slicing.
+template<class T>
+class style_ptr {
+private:
+	template<class U> friend class style_ptr;
+	template<class U> friend style_ptr<U> GetSharedStyle(const U& style);
+	using CopyFunction = shared_ptr<WndStyle>(*)(const WndStyle& style);
+private:
+	shared_ptr<T> _style;
+	CopyFunction _copy;
+	bool _is_interned = false;  // interned styles may be found by value later, and are always copied when modified
+private:
+	template<class U>
+	static shared_ptr<WndStyle> Copy(const WndStyle& style) { return std::make_shared<U>(static_cast<const U&>(style)); }
+	style_ptr(shared_ptr<T> style, bool is_interned) : _style(std::move(style)), _copy(Copy<T>), _is_interned(is_interned) {}
+
+public:
+	template<class U, class = std::enable_if_t<std::is_base_of_v<T, U>>>
+	style_ptr(unique_ptr<U> style) : _style(std::move(style)), _copy(Copy<U>) {}
+	template<class U, class = std::enable_if_t<std::is_base_of_v<T, U>>>
+	style_ptr(style_ptr<U> style) : _style(std::move(style._style)), _copy(style._copy), _is_interned(style._is_interned) {}
+
+	bool IsNull() const { return _style == nullptr; }
+	bool IsShared() const { return _is_interned || _style.use_count() > 1; }
+
+	const T& Get() const { return *_style; }
+	// Returns false if the style is not shared and needn't be copied.
+	bool CopyIfShared() {
+		if (!IsShared()) { return false; }
+		_style = std::static_pointer_cast<T>(_copy(*_style));
+		_is_interned = false;
+		return true;
+	}
+	T& GetMutable() { CopyIfShared(); return *_style; }
+};
+
+
+// The class that defines the operator== of a style.
+template<class T> struct StyleEqualityClass;
+template<class C> struct StyleEqualityClass<bool (C::*)(const C&) const> { using type = C; };
+
+
+// Returns the style equal to the style if any window is using one, or a new shared copy of it.
+// Equal styles are found by T::Hash() and compared with T::operator==.
+template<class T>
+style_ptr<T> GetSharedStyle(const T& style) {
+	using EqualityClass = typename StyleEqualityClass<decltype(&T::operator==)>::type;
+	static_assert(std::is_same_v<EqualityClass, T> || sizeof(EqualityClass) == sizeof(T), 
+				  "a style that adds fields must define operator== to compare them");
+	static std::mutex mutex;
+	static std::unordered_multimap<size_t, weak_ptr<T>> styles;
+	size_t hash = style.Hash();
+	std::lock_guard<std::mutex> lock(mutex);
+	auto [begin, end] = styles.equal_range(hash);
+	for (auto it = begin; it != end;) {
+		shared_ptr<T> shared_style = it->second.lock();
+		if (shared_style == nullptr) { it = styles.erase(it); continue; }  // no window is using it
+		if (*shared_style == style) { return style_ptr<T>(std::move(shared_style), true); }
+		++it;
+	}
+	shared_ptr<T> shared_style = std::make_shared<T>(style);
+	styles.emplace(hash, shared_style);
+	return style_ptr<T>(std::move(shared_style), true);
+}
+
+// The default style of the type, shared by all windows using it.
+template<class T>
+style_ptr<T> GetSharedStyle() {
+	static const style_ptr<T> style = GetSharedStyle(T());
+	return style;
+}
+
+// Creates the style and shares it by value, windows created with equal styles hold a single copy.
+template<class T, class... Args>
+style_ptr<T> make_style(Args&&... args) {
+	return GetSharedStyle(T(std::forward<Args>(args)...));
+}
+
+
+END_NAMESPACE(WndDesign)
\ No newline at end of file
@@ -4,6 +4,7 @@
 #include "../figure/color.h"
 
 #include <string>
+#include <functional>
 
 
 BEGIN_NAMESPACE(WndDesign)
@@ -108,6 +109,10 @@ struct TextBlockStyle {
 		constexpr ParagraphFormat& word_wrap(WordWrap word_wrap) { _word_wrap = word_wrap; return *this; }
 		constexpr ParagraphFormat& line_height(ValueTag line_height) { _line_height = line_height; return *this; }
 		constexpr ParagraphFormat& tab_size(ValueTag tab_size) { _tab_size = tab_size; return *this; }
+		constexpr bool operator==(const ParagraphFormat& other) const {
+			return _text_align == other._text_align && _paragraph_align == other._paragraph_align && _flow_direction == other._flow_direction &&
+				_read_direction == other._read_direction && _word_wrap == other._word_wrap && _line_height == other._line_height && _tab_size == other._tab_size;
+		}
 	}paragraph;
 
 
@@ -133,7 +138,20 @@ struct TextBlockStyle {
 		constexpr FontFormat& color(Color color) { _color = color; return *this; }
 		constexpr FontFormat& underline(bool underline) { _underline = underline; return *this; }
 		constexpr FontFormat& strikeline(bool strikeline) { _strikeline = strikeline; return *this; }
+		bool operator==(const FontFormat& other) const {
+			return _family == other._family && _locale == other._locale && _weight == other._weight && _style == other._style &&
+				_stretch == other._stretch && _underline == other._underline && _strikeline == other._strikeline && _size == other._size && _color == other._color;
+		}
 	}font;
+
+	bool operator==(const TextBlockStyle& other) const { return paragraph == other.paragraph && font == other.font; }
+	size_t Hash() const {
+		size_t hash = std::hash<wstring>()(font._family);
+		hash = hash * 31 + std::hash<float>()(font._size);
+		hash = hash * 31 + font._color.AsUnsigned();
+		hash = hash * 31 + static_cast<size_t>(font._weight);
+		return hash;
+	}
 };
 
 
@@ -4,6 +4,8 @@
 #include "../system/directx/dwrite_api.h"
 #include "../system/directx/d2d_api.h"
 
+#include <algorithm>
+
 
 BEGIN_NAMESPACE(WndDesign)
 
@@ -13,124 +15,250 @@ inline const DWRITE_TEXT_RANGE TextRange2TextRange(TextRange range) {
 }
 
 
-enum class TextRangeRelation {
-	Left,
-	LeftIntersect,
-	Overlapped,
-	Overlapping,
-	RightIntersect,
-	Right
-};
-
-// a is #relation# relative to b.
-inline TextRangeRelation TestTextRangeRelation(TextRange a, TextRange b) {
-	assert(!a.IsEmpty() && !b.IsEmpty());
-	if (a.right() <= b.left()) { return TextRangeRelation::Left; }
-	if (a.right() < b.right() && a.left() < b.left()) { return TextRangeRelation::LeftIntersect; }
-	if (a.right() <= b.right() && a.left() >= b.left()) { return TextRangeRelation::Overlapped; }
-	if (a.right() >= b.right() && a.left() <= b.left()) { return TextRangeRelation::Overlapping; }
-	if (a.right() > b.right() && a.left() > b.left()) { return TextRangeRelation::RightIntersect; }
-	if (a.left() >= b.right()) { return TextRangeRelation::Right; }
-	assert(0); return TextRangeRelation::Right;
-}
-
-list<TextStyleRangeList::TextStyleRange>::iterator TextStyleRangeList::ClearStyle(TextRange range) {
-	auto it = styles.begin();
-	while (it != styles.end()) {
-		switch (TestTextRangeRelation(it->range, range)) {
-		case TextRangeRelation::Left:
-			it++; break;
-		case TextRangeRelation::LeftIntersect:
-			it->range.length = range.begin - it->range.begin; it++; break;
-		case TextRangeRelation::Overlapped:
-			styles.erase(it++); break;
-		case TextRangeRelation::Overlapping: {
-				uint length = static_cast<uint>(it->range.right() - range.right());
-				auto it_prev = it++;
-				it_prev->range.length = range.begin - it_prev->range.begin;
-				if (it_prev->range.length == 0) {
-					it_prev->range.begin = range.right(); it_prev->range.length = length;
-					it = it_prev;
-				} else if (length != 0) {
-					styles.emplace(it, TextStyleRange{ TextRange{range.right(), length}, it_prev->style->Clone() });
-					it--;
-				}
-			}return it;
-		case TextRangeRelation::RightIntersect:
-			it->range.length = static_cast<uint>(it->range.right() - range.right());
-			it->range.begin = range.right();
-			return it;
-		case TextRangeRelation::Right:
-			return it;
-		default: assert(0);
-		}
+uint TextStyleRangeList::NextPriority() {
+	// xorshift32
+	_random_seed ^= _random_seed << 13;
+	_random_seed ^= _random_seed >> 17;
+	_random_seed ^= _random_seed << 5;
+	return _random_seed;
+}
+
+void TextStyleRangeList::Pull(Run& run) {
+	run.count = Count(run.left) + 1 + Count(run.right);
+	run.length_sum = Length(run.left) + run.length + Length(run.right);
+}
+
+alloc_ptr<TextStyleRangeList::Run> TextStyleRangeList::Merge(alloc_ptr<Run> left, alloc_ptr<Run> right) {
+	if (left == nullptr) { return right; }
+	if (right == nullptr) { return left; }
+	if (left->priority > right->priority) {
+		left->right = Merge(left->right, right);
+		Pull(*left);
+		return left;
+	} else {
+		right->left = Merge(left, right->left);
+		Pull(*right);
+		return right;
 	}
-	return it;
-}
-
-void TextStyleRangeList::SetStyle(TextRange range, const TextStyleBase& style) {
-	auto it = ClearStyle(range);
-	auto it_prev = it;
-	bool extended = false;
-	if (it != styles.begin()) {
-		it_prev--;
-		if (it_prev->range.right() == range.left() && it_prev->style->Equals(style)) {
-			it_prev->range.length += range.length;
-			extended = true;
-		}
+}
+
+std::pair<alloc_ptr<TextStyleRangeList::Run>, alloc_ptr<TextStyleRangeList::Run>> TextStyleRangeList::Split(alloc_ptr<Run> run, uint pos) {
+	if (run == nullptr) { return { nullptr, nullptr }; }
+	if (pos == 0) { return { nullptr, run }; }
+	if (pos >= run->length_sum) { return { run, nullptr }; }
+	uint run_begin = Length(run->left), run_end = run_begin + run->length;
+	if (pos <= run_begin) {
+		auto [left, right] = Split(run->left, pos);
+		run->left = right; Pull(*run);
+		return { left, run };
 	}
-	if (it != styles.end()) {
-		if (range.right() == it->range.left() && it->style->Equals(style)) {
-			if (extended) {
-				it_prev->range.length += it->range.length;
-				styles.erase(it++);
-			} else {
-				it->range.length += range.length;
-				it->range.begin = range.begin;
-				extended = true;
-			}
-		}
+	if (pos >= run_end) {
+		auto [left, right] = Split(run->right, pos - run_end);
+		run->right = left; Pull(*run);
+		return { run, right };
 	}
-	if (!extended) {
-		styles.emplace(it, TextStyleRange{ range, style.Clone() });
+	// Split the run, both halves keep the priority which is no less than that of the children.
+	alloc_ptr<Run> run_right = new Run();
+	run_right->length = run_end - pos;
+	run_right->style = run->style;
+	run_right->priority = run->priority;
+	run_right->right = run->right;
+	run->right = nullptr;
+	run->length = pos - run_begin;
+	Pull(*run_right); Pull(*run);
+	return { run, run_right };
+}
+
+void TextStyleRangeList::Destroy(alloc_ptr<Run> run) {
+	if (run == nullptr) { return; }
+	Destroy(run->left);
+	Destroy(run->right);
+	delete run;
+}
+
+void TextStyleRangeList::ExtendRun(Run& run, uint pos, uint length) {
+	uint run_begin = Length(run.left);
+	if (pos < run_begin) {
+		ExtendRun(*run.left, pos, length);
+	} else if (pos >= run_begin + run.length && run.right != nullptr) {
+		ExtendRun(*run.right, pos - run_begin - run.length, length);
+	} else {
+		run.length += length;
 	}
+	Pull(run);
 }
 
-void TextStyleRangeList::ExtendStyle(TextRange range) {
-	auto it = styles.begin();
-	while (it != styles.end()) {
-		if (it->range.right() < range.left()) { it++; continue; }
-		if (it->range.Contains(range.begin - 1) || (it->range.begin == range.begin && range.begin == 0)) {
-			it->range.length += range.length;
-			it++; break;
-		}
-		if (it->range.left() >= range.left()) {
-			break;
-		}
+template<class Func>
+void TextStyleRangeList::ForEachRun(ref_ptr<const Run> run, uint offset, TextRange range, Func& func) {
+	// Only the subtrees intersecting range are visited.
+	if (run == nullptr || offset >= range.right() || offset + run->length_sum <= range.left()) { return; }
+	ForEachRun(run->left, offset, range, func);
+	uint run_begin = offset + Length(run->left), run_end = run_begin + run->length;
+	if (run_begin < range.right() && run_end > range.left()) {
+		func(max(run_begin, range.left()), min(run_end, range.right()), run->style.get());
+	}
+	ForEachRun(run->right, run_end, range, func);
+}
+
+bool TextStyleRangeList::HasStyle(TextRange range) const {
+	bool has_style = false;
+	auto test = [&](uint begin, uint end, ref_ptr<const TextStyleBase> style) { has_style |= style != nullptr; };
+	ForEachRun(_root, 0, range, test);
+	return has_style;
+}
+
+void TextStyleRangeList::ApplyTo(ref_ptr<const Run> run, uint offset, TextLayout& layout, TextRange range) {
+	auto apply_to = [&](uint begin, uint end, ref_ptr<const TextStyleBase> style) {
+		if (style != nullptr) { style->ApplyTo(layout, TextRange{ begin - range.begin, end - begin }); }
+	};
+	ForEachRun(run, offset, range, apply_to);
+}
+
+shared_ptr<const TextStyleBase> TextStyleRangeList::Intern(const TextStyleBase& style) {
+	for (auto& interned_style : _interned_styles) {
+		if (interned_style->Equals(style)) { return interned_style; }
+	}
+	// Styles no longer used by any run are released.
+	_interned_styles.erase(
+		std::remove_if(_interned_styles.begin(), _interned_styles.end(), [](auto& style) { return style.use_count() == 1; }),
+		_interned_styles.end()
+	);
+	_interned_styles.push_back(style.Clone());
+	return _interned_styles.back();
+}
+
+alloc_ptr<TextStyleRangeList::Run> TextStyleRangeList::MakeRun(uint length, shared_ptr<const TextStyleBase> style) {
+	alloc_ptr<Run> run = new Run();
+	run->length = length;
+	run->style = std::move(style);
+	run->priority = NextPriority();
+	Pull(*run);
+	return run;
+}
+
+alloc_ptr<TextStyleRangeList::Run> TextStyleRangeList::MakeRuns(const vector<std::pair<uint, shared_ptr<const TextStyleBase>>>& runs) {
+	if (runs.empty()) { return nullptr; }
+	// Build a treap of the runs in linear time with a stack of the right spine.
+	vector<ref_ptr<Run>> spine;
+	for (auto& [length, style] : runs) {
+		alloc_ptr<Run> run = MakeRun(length, style);
+		ref_ptr<Run> last = nullptr;
+		while (!spine.empty() && spine.back()->priority < run->priority) { last = spine.back(); spine.pop_back(); }
+		run->left = last;
+		if (!spine.empty()) { spine.back()->right = run; }
+		spine.push_back(run);
 	}
-	while (it != styles.end()) {
-		it->range.begin += static_cast<int>(range.length);
-		it++;
+	// Update subtree values in post order.
+	struct Local {
+		static void PullAll(ref_ptr<Run> run) {
+			if (run == nullptr) { return; }
+			PullAll(run->left); PullAll(run->right); Pull(*run);
+		}
+	};
+	Local::PullAll(spine.front());
+	return spine.front();
+}
+
+alloc_ptr<TextStyleRangeList::Run> TextStyleRangeList::Join(alloc_ptr<Run> left, alloc_ptr<Run> right) {
+	if (left == nullptr || right == nullptr) { return Merge(left, right); }
+	ref_ptr<Run> last = left; while (last->right != nullptr) { last = last->right; }
+	ref_ptr<Run> first = right; while (first->left != nullptr) { first = first->left; }
+	if (last->style == first->style) {
+		uint length = first->length;
+		auto [run, rest] = Split(right, length);
+		Destroy(run);
+		ExtendRun(*left, Length(left) - 1, length);
+		right = rest;
 	}
+	return Merge(left, right);
 }
 
-void TextStyleRangeList::ShrinkStyle(TextRange range) {
-	auto it = ClearStyle(range);
-	auto it_prev = it;
-	for (auto it_right = it; it_right != styles.end(); ++it_right) {
-		it_right->range.begin -= static_cast<int>(range.length);
+void TextStyleRangeList::TrimEnd() {
+	// The text after the last styled run is not stored.
+	if (_root == nullptr) { return; }
+	ref_ptr<Run> last = _root; while (last->right != nullptr) { last = last->right; }
+	if (last->style != nullptr) { return; }
+	auto [left, right] = Split(_root, Length(_root) - last->length);
+	Destroy(right);
+	_root = left;
+}
+
+void TextStyleRangeList::ReplaceStyle(TextRange range, shared_ptr<const TextStyleBase> style) {
+	if (range.IsEmpty() || (style == nullptr && range.begin >= Length(_root))) { return; }
+	auto [left, rest] = Split(_root, range.begin);
+	if (range.begin > Length(left)) { left = Merge(left, MakeRun(range.begin - Length(left), nullptr)); }
+	auto [middle, right] = Split(rest, range.length);
+	Destroy(middle);
+	_root = Join(Join(left, MakeRun(range.length, std::move(style))), right);
+	TrimEnd();
+}
+
+void TextStyleRangeList::ReplaceStyles(TextRange range, const vector<TextStyleRun>& runs, vector<TextRange>& changed_ranges) {
+	if (range.IsEmpty()) { return; }
+	using StyledLength = std::pair<uint, shared_ptr<const TextStyleBase>>;
+
+	// Make the new runs covering range, with runs without style in the gaps.
+	vector<StyledLength> new_runs;
+	auto append = [&](uint length, shared_ptr<const TextStyleBase> style) {
+		if (!new_runs.empty() && new_runs.back().second == style) { new_runs.back().first += length; return; }
+		new_runs.emplace_back(length, std::move(style));
+	};
+	uint pos = range.begin;
+	ref_ptr<const TextStyleBase> last_style = nullptr; shared_ptr<const TextStyleBase> last_interned_style;
+	for (auto& run : runs) {
+		uint begin = max(run.range.left(), pos), end = min(run.range.right(), range.right());
+		if (begin >= end) { continue; }
+		if (run.style != last_style) { last_style = run.style; last_interned_style = Intern(*run.style); }
+		if (begin > pos) { append(begin - pos, nullptr); }
+		append(end - begin, last_interned_style);
+		pos = end;
 	}
-	if (it != styles.begin()) {
-		it_prev--;
-		if (it_prev->range.right() == it->range.left() && it_prev->style->Equals(*it->style)) {
-			it_prev->range.length += it->range.length;
-			styles.erase(it);
+	if (pos < range.right()) { append(range.right() - pos, nullptr); }
+
+	// Compare with the old runs in range, the text after the last run has no style.
+	vector<std::pair<uint, ref_ptr<const TextStyleBase>>> old_runs;
+	auto collect = [&](uint begin, uint end, ref_ptr<const TextStyleBase> style) { old_runs.emplace_back(end - begin, style); };
+	ForEachRun(_root, 0, range, collect);
+	if (Length(_root) < range.right()) { old_runs.emplace_back(range.right() - max(Length(_root), range.left()), nullptr); }
+	bool is_changed = false;
+	pos = range.begin;
+	for (uint i = 0, j = 0, old_length = old_runs[0].first, new_length = new_runs[0].first; pos < range.right();) {
+		uint length = min(old_length, new_length);
+		if (old_runs[i].second != new_runs[j].second.get()) {
+			if (is_changed && changed_ranges.back().right() == pos) {
+				changed_ranges.back().length += length;
+			} else {
+				changed_ranges.push_back(TextRange{ pos, length });
+			}
+			is_changed = true;
 		}
+		pos += length; old_length -= length; new_length -= length;
+		if (old_length == 0 && ++i < old_runs.size()) { old_length = old_runs[i].first; }
+		if (new_length == 0 && ++j < new_runs.size()) { new_length = new_runs[j].first; }
 	}
+	if (!is_changed) { return; }
+
+	// Replace the old runs in range.
+	auto [left, rest] = Split(_root, range.begin);
+	if (range.begin > Length(left)) { left = Merge(left, MakeRun(range.begin - Length(left), nullptr)); }
+	auto [middle, right] = Split(rest, range.length);
+	Destroy(middle);
+	_root = Join(Join(left, MakeRuns(new_runs)), right);
+	TrimEnd();
+}
+
+void TextStyleRangeList::ExtendStyle(TextRange range) {
+	if (range.IsEmpty() || range.begin > Length(_root) || _root == nullptr) { return; }
+	ExtendRun(*_root, range.begin == 0 ? 0 : range.begin - 1, range.length);
 }
 
-void TextStyleRangeList::ApplyTo(TextLayout& layout) const {
-	for (auto& style : styles) { style.style->ApplyTo(layout, style.range); }
+void TextStyleRangeList::ShrinkStyle(TextRange range) {
+	if (range.IsEmpty() || range.begin >= Length(_root)) { return; }
+	auto [left, rest] = Split(_root, range.begin);
+	auto [middle, right] = Split(rest, range.length);
+	Destroy(middle);
+	_root = Join(left, right);
+	TrimEnd();
 }
 
 
@@ -155,7 +283,7 @@ void TextStyleUnderline::ApplyTo(TextLayout& layout, TextRange range) const {
 }
 
 void TextStyleColor::ApplyTo(TextLayout& layout, TextRange range) const {
-	hr << layout.SetDrawingEffect(&GetSolidColorBrush(value), TextRange2TextRange(range));
+	hr << layout.SetDrawingEffect(&GetSharedSolidColorBrush(value), TextRange2TextRange(range));
 }
 
 
@@ -6,14 +6,15 @@
 
 #include <memory>
 #include <string>
-#include <list>
+#include <vector>
 
 
 BEGIN_NAMESPACE(WndDesign)
 
 using std::unique_ptr;
+using std::shared_ptr;
 using std::wstring;
-using std::list;
+using std::vector;
 
 struct TextLayout;  // An alias for IDWriteTextLayout.
 
@@ -38,21 +39,73 @@ struct ABSTRACT_BASE TextStyleBase {
 };
 
 
+// A run of style for setting styles in bulk, the style is only referenced during the call.
+struct TextStyleRun {
+	TextRange range;
+	ref_ptr<const TextStyleBase> style;
+};
+
+
+// Styled runs of a text stored in an implicit treap in text order, where the position of a run is the sum of the 
+//   lengths of the runs before it, so that finding runs by position, setting or clearing the style of a range, and
+//   shifting the runs after inserted or deleted text all take O(log n). The text not styled between the styled runs 
+//   is stored as runs without style. Equal style values are interned, and adjacent runs of equal styles are merged.
 class TextStyleRangeList : Uncopyable {
 private:
-	struct TextStyleRange {
-		TextRange range;
-		unique_ptr<TextStyleBase> style;
+	struct Run : Uncopyable {
+		uint length = 0;
+		shared_ptr<const TextStyleBase> style = nullptr;  // nullptr for the text not styled
+		alloc_ptr<Run> left = nullptr;
+		alloc_ptr<Run> right = nullptr;
+		uint priority = 0;
+		uint count = 1;
+		uint length_sum = 0;
 	};
-	list<TextStyleRange> styles;
 public:
 	TextStyleRangeList() {}
-	~TextStyleRangeList() {}
-	list<TextStyleRange>::iterator ClearStyle(TextRange range);
-	void SetStyle(TextRange range, const TextStyleBase& style);
+	~TextStyleRangeList() { Destroy(_root); }
+private:
+	alloc_ptr<Run> _root = nullptr;
+	uint _random_seed = 0x9E3779B9;
+	vector<shared_ptr<const TextStyleBase>> _interned_styles;
+private:
+	uint NextPriority();
+	static uint Count(ref_ptr<const Run> run) { return run == nullptr ? 0 : run->count; }
+	static uint Length(ref_ptr<const Run> run) { return run == nullptr ? 0 : run->length_sum; }
+	static void Pull(Run& run);
+	static alloc_ptr<Run> Merge(alloc_ptr<Run> left, alloc_ptr<Run> right);
+	static std::pair<alloc_ptr<Run>, alloc_ptr<Run>> Split(alloc_ptr<Run> run, uint pos);
+	static void Destroy(alloc_ptr<Run> run);
+	static void ExtendRun(Run& run, uint pos, uint length);
+	// Calls func(begin, end, style) for the runs intersecting range in order, with the range of each run clipped.
+	template<class Func>
+	static void ForEachRun(ref_ptr<const Run> run, uint offset, TextRange range, Func& func);
+	static void ApplyTo(ref_ptr<const Run> run, uint offset, TextLayout& layout, TextRange range);
+private:
+	shared_ptr<const TextStyleBase> Intern(const TextStyleBase& style);
+	alloc_ptr<Run> MakeRun(uint length, shared_ptr<const TextStyleBase> style);
+	// Build the runs of lengths and styles in linear time.
+	alloc_ptr<Run> MakeRuns(const vector<std::pair<uint, shared_ptr<const TextStyleBase>>>& runs);
+	// Merge the runs, and the last run of left with the first run of right if they have the same style.
+	alloc_ptr<Run> Join(alloc_ptr<Run> left, alloc_ptr<Run> right);
+	void ReplaceStyle(TextRange range, shared_ptr<const TextStyleBase> style);
+	void TrimEnd();
+public:
+	uint GetRunNumber() const { return Count(_root); }
+	void ClearStyle(TextRange range) { ReplaceStyle(range, nullptr); }
+	void SetStyle(TextRange range, const TextStyleBase& style) { ReplaceStyle(range, Intern(style)); }
+	// Replace the styles in range with the runs sorted by position, in one pass of the runs. The ranges where the
+	//   style has changed are appended to changed_ranges in order.
+	void ReplaceStyles(TextRange range, const vector<TextStyleRun>& runs, vector<TextRange>& changed_ranges);
+	// Text inserted at range.begin extends the run before it, or the first run if inserted at the beginning.
 	void ExtendStyle(TextRange range);
+	// Text in range deleted.
 	void ShrinkStyle(TextRange range);
-	void ApplyTo(TextLayout& layout) const;
+	// Returns true if any text in range has a style.
+	bool HasStyle(TextRange range) const;
+	void ApplyTo(TextLayout& layout) const { ApplyTo(_root, 0, layout, TextRange{ 0, Length(_root) }); }
+	// Apply the styles intersecting range to the layout of the text in range.
+	void ApplyTo(TextLayout& layout, TextRange range) const { ApplyTo(_root, 0, layout, range); }
 };
 
 
@@ -33,6 +33,10 @@ public:
 
 	constexpr ValueTag operator-() const { return ValueTag(-value(), tag()); }
 
+	constexpr bool operator==(const ValueTag& other) const { return value_tag == other.value_tag; }
+	constexpr bool operator!=(const ValueTag& other) const { return value_tag != other.value_tag; }
+	constexpr size_t Hash() const { return value_tag; }
+
 	constexpr ValueTag& ConvertToPixel(uint entire_length) {
 		if (tag() == Tag::Percent) { 
 			*this = ValueTag(value() * static_cast<int>(entire_length) / 100, Tag::Pixel);
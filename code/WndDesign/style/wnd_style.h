@@ -7,6 +7,8 @@
 #include "../figure/background_types.h"
 #include "../system/cursor.h"
 
+#include <functional>
+
 
 BEGIN_NAMESPACE(WndDesign)
 
@@ -28,6 +30,8 @@ struct WndStyle {
 		constexpr LengthStyle& min(ValueTag min) { _min = min; return *this; }
 		constexpr LengthStyle& max(ValueTag max) { _max = max; return *this; }
 		constexpr void setFixed(ValueTag length) { _normal = _min = _max = length; }
+		constexpr bool operator==(const LengthStyle& other) const { return _normal == other._normal && _min == other._min && _max == other._max; }
+		constexpr size_t Hash() const { return (_normal.Hash() * 31 + _min.Hash()) * 31 + _max.Hash(); }
 	};
 	LengthStyle width;
 	LengthStyle height;
@@ -50,6 +54,10 @@ struct WndStyle {
 		constexpr void setAll(ValueTag all) { _left = _top = _right = _bottom = all; }
 		constexpr PositionStyle& setHorizontalCenter() { _left = _right = position_center; return *this; }
 		constexpr PositionStyle& setVerticalCenter() { _top = _bottom = position_center; return *this; }
+		constexpr bool operator==(const PositionStyle& other) const { 
+			return _left == other._left && _top == other._top && _right == other._right && _bottom == other._bottom; 
+		}
+		constexpr size_t Hash() const { return ((_left.Hash() * 31 + _top.Hash()) * 31 + _right.Hash()) * 31 + _bottom.Hash(); }
 	}position;
 
 
@@ -60,6 +68,9 @@ struct WndStyle {
 		constexpr CompositeStyle& blur_radius(uchar blur_radius) { _blur_radius = blur_radius; return *this; }
 		constexpr CompositeStyle& z_index(char z_index) { _z_index = z_index; return *this; }
 		constexpr CompositeStyle& mouse_penetrate(bool mouse_penetrate) { _mouse_penetrate = mouse_penetrate; return *this; }
+		constexpr bool operator==(const CompositeStyle& other) const {
+			return _opacity == other._opacity && _blur_radius == other._blur_radius && _z_index == other._z_index && _mouse_penetrate == other._mouse_penetrate;
+		}
 	}composite;
 
 
@@ -74,22 +85,25 @@ struct WndStyle {
 		uint _width = 0;
 		Color _color = ColorSet::Black;
 		uint _radius = 0;
-		uint _saved_width = (uint)-1;  // for internal use
-		unique_ptr<BorderResizer> _resizer = CreateEmptyBorderResizer();
+		shared_ptr<const BorderResizer> _resizer = GetEmptyBorderResizer();  // the prototype each window clones
 	public:
 		constexpr BorderStyle& width(uint width) { _width = width; return *this; }
 		constexpr BorderStyle& color(Color color) { _color = color; return *this; }
 		constexpr BorderStyle& radius(uint radius) { _radius = radius; return *this; }
-		BorderStyle& setResizer(unique_ptr<BorderResizer> resizer) { _resizer = std::move(resizer); return *this; }
+		BorderStyle& setResizer(shared_ptr<const BorderResizer> resizer) { _resizer = std::move(resizer); return *this; }
+		bool operator==(const BorderStyle& other) const {
+			return _width == other._width && _color == other._color && _radius == other._radius && _resizer == other._resizer;  // same resizer
+		}
 	}border;
 
 
 	// The scrollbar resource.
 	struct ScrollbarStyle {
 	public:
-		unique_ptr<Scrollbar> _resource = CreateEmptyScrollbar();
+		shared_ptr<const Scrollbar> _resource = GetEmptyScrollbar();  // the prototype each window clones
 	public:
-		void set(unique_ptr<Scrollbar> scrollbar_resource) { _resource = std::move(scrollbar_resource); }
+		void set(shared_ptr<const Scrollbar> scrollbar_resource) { _resource = std::move(scrollbar_resource); }
+		bool operator==(const ScrollbarStyle& other) const { return _resource == other._resource; }  // same resource
 	}scrollbar;
 
 
@@ -108,6 +122,9 @@ struct WndStyle {
 		constexpr PaddingStyle& bottom(ValueTag bottom) { _bottom = bottom; return *this; }
 		constexpr void set(ValueTag left, ValueTag top, ValueTag right, ValueTag bottom) { _left = left; _top = top; _right = right; _bottom = bottom; }
 		constexpr void setAll(ValueTag all) { _left = _top = _right = _bottom = all; }
+		constexpr bool operator==(const PaddingStyle& other) const {
+			return _left == other._left && _top == other._top && _right == other._right && _bottom == other._bottom;
+		}
 	}padding;
 
 
@@ -131,6 +148,9 @@ struct WndStyle {
 		constexpr ClientStyle& top(ValueTag top) { _top = top; return *this; }
 	public:
 		ClientStyle() { width.setFixed(100pct); height.setFixed(100pct); }
+		bool operator==(const ClientStyle& other) const {
+			return _left == other._left && _top == other._top && width == other.width && height == other.height;
+		}
 	}client;
 
 
@@ -152,6 +172,7 @@ struct WndStyle {
 			_resource.reset(new ImageRepeatBackground(image, opacity, offset_on_image));
 		}
 		void set(shared_ptr<Background> resource) { _resource = resource; }
+		bool operator==(const BackgroundStyle& other) const { return _resource == other._resource; }  // same resource
 	}background;
 
 
@@ -161,10 +182,35 @@ struct WndStyle {
 		Cursor _cursor = Cursor::Default;
 	public:
 		void set(Cursor cursor) { _cursor = cursor; }
+		constexpr bool operator==(const CursorStyle& other) const { return _cursor == other._cursor; }
 	}cursor;
 
 
+	// Styles are shared by windows and copied on write, see style_ptr.
+	WndStyle() = default;
+	WndStyle(const WndStyle&) = default;
 	virtual ~WndStyle() {}  // style may contain allocated resources like background or title.
+
+	// Styles are interned by value with Hash() and operator==, see GetSharedStyle().
+	// A derived style that adds fields must define its own operator== to compare them.
+	bool operator==(const WndStyle& other) const {
+		return width == other.width && height == other.height && position == other.position && composite == other.composite &&
+			border == other.border && scrollbar == other.scrollbar && padding == other.padding && client == other.client &&
+			background == other.background && cursor == other.cursor;
+	}
+	size_t Hash() const {
+		size_t hash = width.Hash();
+		hash = hash * 31 + height.Hash();
+		hash = hash * 31 + position.Hash();
+		hash = hash * 31 + client.width.Hash();
+		hash = hash * 31 + client.height.Hash();
+		hash = hash * 31 + border._width;
+		hash = hash * 31 + border._color.AsUnsigned();
+		hash = hash * 31 + std::hash<ref_ptr<const BorderResizer>>()(border._resizer.get());
+		hash = hash * 31 + std::hash<ref_ptr<const Scrollbar>>()(scrollbar._resource.get());
+		hash = hash * 31 + std::hash<ref_ptr<Background>>()(background._resource.get());
+		return hash;
+	}
 };
 
 
@@ -1,6 +1,9 @@
 #include "d2d_api.h"
 #include "directx_helper.h"
 
+#include <mutex>
+#include <unordered_map>
+
 
 BEGIN_NAMESPACE(WndDesign)
 
@@ -12,4 +15,27 @@ ID2D1SolidColorBrush& GetSolidColorBrush(Color color) {
 }
 
 
+BEGIN_NAMESPACE(Anonymous)
+
+struct SolidColorBrushCache {
+public:
+    std::mutex mutex;
+    std::unordered_map<uint, ID2D1SolidColorBrush*> brushes;
+public:
+    SolidColorBrushCache() { GetD2DDeviceContext(); }  // The device context is destroyed after the cache.
+    ~SolidColorBrushCache() { for (auto& [color, brush] : brushes) { SafeRelease(&brush); } }
+};
+
+END_NAMESPACE(Anonymous)
+
+
+ID2D1SolidColorBrush& GetSharedSolidColorBrush(Color color) {
+    static SolidColorBrushCache cache;
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    auto [it, inserted] = cache.brushes.emplace(color.AsUnsigned(), nullptr);
+    if (inserted) { hr << GetD2DDeviceContext().CreateSolidColorBrush(Color2COLOR(color), &it->second); }
+    return *it->second;
+}
+
+
 END_NAMESPACE(WndDesign)
\ No newline at end of file
@@ -10,7 +10,11 @@ struct ID2D1SolidColorBrush;
 BEGIN_NAMESPACE(WndDesign)
 
 
+// Returns the brush of the device context with the color set, which is changed by the next call.
 ID2D1SolidColorBrush& GetSolidColorBrush(Color color);
 
+// Returns a brush of the color kept for the process, for drawing effects of text layouts that outlive the call.
+ID2D1SolidColorBrush& GetSharedSolidColorBrush(Color color);
+
 
 END_NAMESPACE(WndDesign)
\ No newline at end of file
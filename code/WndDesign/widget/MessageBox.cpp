@@ -28,7 +28,7 @@ struct MessageBoxStyle : public TextBox::Style {
 static constexpr uint expire_time = 5000;
 
 
-MessageBox::MessageBox() : TextBox(std::make_unique<MessageBoxStyle>(), L"") {}
+MessageBox::MessageBox() : TextBox(make_style<MessageBoxStyle>(), L"") {}
 
 MessageBox::~MessageBox() {}
 
@@ -44,7 +44,7 @@ MouseEnter 	        start_fade_in (show)									       hide
 
 
 ToolTip::ToolTip() :
-	TextBox(std::make_unique<ToolTipStyle>(), L""), 
+	TextBox(make_style<ToolTipStyle>(), L""), 
 	timer([]() {}), fade_animation(*this, []() {}) {
 }
 
@@ -53,8 +53,8 @@ ToolTip::~ToolTip() {}
 void ToolTip::FadeInBegin() {
 	timer.Stop();
 	Point position = GetCursorPosition();
-	GetStyle().position.left(px(position.x - 10)).top(px(position.y + 10));
-	GetStyle().composite._opacity = 0;
+	ModifyStyle().position.left(px(position.x - 10)).top(px(position.y + 10));
+	ModifyStyle().composite._opacity = 0;
 	fade_animation.callback = std::bind(&ToolTip::FadeInEnd, this);
 	fade_animation.Set(fade_in_time, 0xFF);
 	desktop.AddChild(*this, [](HANDLE hWnd) { HideWndFromTaskbar(hWnd); });
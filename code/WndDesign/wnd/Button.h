@@ -13,19 +13,22 @@ public:
 		BackgroundStyle background_hover;
 		BackgroundStyle background_press;
 		Style() {
-			scrollbar.set(CreateEmptyScrollbar());
+			scrollbar.set(GetEmptyScrollbar());
 			background_press = background_hover = background;
 		}
+		bool operator==(const Style& other) const {
+			return TextBox::Style::operator==(other) && background_hover == other.background_hover && background_press == other.background_press;
+		}
 	};
 
 public:
-	Button(unique_ptr<Style> style, const wstring& text = L"") : TextBox(std::move(style), text) {}
+	Button(style_ptr<Style> style, const wstring& text = L"") : TextBox(std::move(style), text) {}
 	~Button() {}
 
 
 	//// style ////
 protected:
-	Style& GetStyle() { return static_cast<Style&>(TextBox::GetStyle()); }
+	Style& ModifyStyle() { return static_cast<Style&>(TextBox::ModifyStyle()); }
 	const Style& GetStyle() const { return static_cast<const Style&>(TextBox::GetStyle()); }
 
 
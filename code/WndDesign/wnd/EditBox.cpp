@@ -8,29 +8,38 @@
 BEGIN_NAMESPACE(WndDesign)
 
 
-EditBox::EditBox(unique_ptr<Style> style, const wstring& text) :
-	TextBox(std::move(style), text), _mouse_tracker(*this) {
-	OnTextChange();
+EditBox::EditBox(style_ptr<Style> style, wstring text) :
+	TextBox(std::move(style), std::move(text)), _mouse_tracker(*this) {
 }
 
 EditBox::~EditBox() {}
 
-void EditBox::OnTextChange() {
-	TextBox::OnTextChange();
-	const wstring& text = GetText();
-	_word_break_iterator.SetText(text.c_str(), (uint)text.length());
+const TextRange EditBox::GetWordRange(uint text_position) {
+	// Words never cross a line break, so the boundaries are found from the beginning of the paragraph, and are 
+	//   reused for moving by words in the same paragraph until the text is edited.
+	const TextBlock& text_block = GetTextBlock();
+	TextRange paragraph = text_block.GetParagraphRange(text_block.GetParagraphIndex(text_position));
+	if (paragraph.begin != _word_break_paragraph_begin || GetTextRevision() != _word_break_text_revision) {
+		_word_break_paragraph = GetText().GetSubString(paragraph.begin, paragraph.length);
+		_word_break_iterator.SetText(_word_break_paragraph.c_str(), (uint)_word_break_paragraph.length());
+		_word_break_paragraph_begin = paragraph.begin;
+		_word_break_text_revision = GetTextRevision();
+	}
+	TextRange word_range = _word_break_iterator.Seek(text_position - paragraph.begin);
+	return TextRange{ paragraph.begin + word_range.begin, word_range.length };
 }
 
 const Rect EditBox::UpdateContentLayout(Size client_size) {
-	const TextBlock& text_block = GetTextBlock();
-	Size old_size = text_block.GetSize();
-	text_block.AutoResize(client_size);
-	if (text_block.GetSize() != old_size) { 
+	if (UpdateTextBlockLayout(client_size)) { 
 		Invalidate(region_infinite); 
-		UpdateCaretRegion(GetTextBlock().HitTestTextPosition(_caret_text_position));
+		// The caret and selection move with the text, but the caret is not scrolled into view, for the display region
+		//   may be kept still at another paragraph.
+		HitTestInfo info = GetTextBlock().HitTestTextPosition(_caret_text_position);
+		_caret_region.point = info.geometry_region.point;
+		_caret_region.size.height = info.geometry_region.size.height;
 		UpdateSelectionRegion();
 	}
-	return Rect(point_zero, text_block.GetSize());
+	return Rect(point_zero, GetTextBlock().GetSize());
 }
 
 void EditBox::OnComposite(FigureQueue& figure_queue, Size display_size, Rect invalid_display_region) const {
@@ -105,6 +114,10 @@ void EditBox::SetCaret(Point mouse_down_position) {
 void EditBox::SetCaret(uint text_position, bool is_trailing_hit) {
 	HitTestInfo info = GetTextBlock().HitTestTextPosition(text_position);
 	info.is_trailing_hit = is_trailing_hit;
+	// The trailing side of a line break is the beginning of the next line.
+	if (is_trailing_hit && info.text_length > 0 && info.geometry_region.size.width == 0) {
+		info = GetTextBlock().HitTestTextPosition(info.text_position + info.text_length);
+	}
 	UpdateCaretRegion(info); _caret_state = CaretState::Show;
 	ClearSelection();
 }
@@ -139,9 +152,29 @@ void EditBox::MoveCaret(CaretMoveDirection direction) {
 	case CaretMoveDirection::End:
 		SetCaret(Point(position_max, _caret_region.Center().y));
 		break;
+	case CaretMoveDirection::WordLeft:
+		// Move to the beginning of the word before the caret, skipping the spaces.
+		if (_caret_text_position > 0) {
+			TextRange word_range = GetWordRange(_caret_text_position - 1);
+			if (IsSpace(word_range) && word_range.begin > 0) { word_range = GetWordRange(word_range.begin - 1); }
+			SetCaret(word_range.begin, false);
+		}
+		break;
+	case CaretMoveDirection::WordRight:
+		// Move to the beginning of the next word, skipping the spaces.
+		if (_caret_text_position < GetText().GetLength()) {
+			uint text_position = GetWordRange(_caret_text_position).right();
+			if (text_position < GetText().GetLength() && IsSpace(GetWordRange(text_position))) { text_position = GetWordRange(text_position).right(); }
+			SetCaret(text_position, false);
+		}
+		break;
 	}
 }
 
+void EditBox::GoToParagraph(uint index) {
+	SetCaret(GetTextBlock().GetParagraphRange(index).begin, false);
+}
+
 void EditBox::UpdateSelectionRegion() {
 	GetTextBlock().HitTestTextRange(_selection_begin, _selection_end - _selection_begin, _selection_info);
 	InvalidateSelectionRegion();
@@ -163,24 +196,23 @@ void EditBox::DoSelection(Point mouse_move_position) {
 }
 
 void EditBox::SelectWord() {
-	if (_caret_text_position >= GetText().length()) { return; }
-	TextRange word_range = _word_break_iterator.Seek(_caret_text_position);
+	if (_caret_text_position >= GetText().GetLength()) { return; }
+	TextRange word_range = GetWordRange(_caret_text_position);
 	_selection_begin = word_range.left(); _selection_end = word_range.right();
 	UpdateSelectionRegion(); HideCaret();
 }
 
 void EditBox::SelectParagraph() {
-	const wstring& text = GetText(); uint length = (uint)text.length();
-	_selection_begin = _caret_text_position - 1; _selection_end = _caret_text_position;
-	while (_selection_begin < length && text[_selection_begin] != L'\n') { _selection_begin--; } 
-	while (_selection_end < length && text[_selection_end] != L'\n') { _selection_end++; }
-	_selection_begin++; _selection_end++;
+	const TextBlock& text_block = GetTextBlock();
+	TextRange range = text_block.GetParagraphRange(text_block.GetParagraphIndex(_caret_text_position));
+	_selection_begin = range.begin;
+	_selection_end = range.right();
 	UpdateSelectionRegion(); HideCaret();
 }
 
 void EditBox::SelectAll() {
 	_selection_begin = 0;
-	_selection_end = (uint)GetText().size();
+	_selection_end = GetText().GetLength();
 	UpdateSelectionRegion(); HideCaret();
 }
 
@@ -226,7 +258,7 @@ void EditBox::Delete(bool is_backspace) {
 			uint character_length = previous_caret_position - _caret_text_position;
 			DeleteText(_caret_text_position, character_length);
 		} else {
-			if (_caret_text_position >= GetText().length()) { return; }
+			if (_caret_text_position >= GetText().GetLength()) { return; }
 			uint character_length = GetCharacterLength(_caret_text_position);
 			if (character_length == 0) { return; }
 			DeleteText(_caret_text_position, character_length);
@@ -266,7 +298,7 @@ void EditBox::Cut() {
 
 void EditBox::Copy() {
 	if (HasSelection()) {
-		SetClipboardData(GetText().substr(_selection_begin, _selection_end - _selection_begin));
+		SetClipboardData(GetText().GetSubString(_selection_begin, _selection_end - _selection_begin));
 	}
 }
 
@@ -294,8 +326,8 @@ void EditBox::Handler(Msg msg, Para para) {
 	switch (msg) {
 	case Msg::KeyDown:
 		switch (GetKeyMsg(para).key) {
-		case Key::Left: MoveCaret(CaretMoveDirection::Left); break;
-		case Key::Right: MoveCaret(CaretMoveDirection::Right); break;
+		case Key::Left: MoveCaret(_is_ctrl_down ? CaretMoveDirection::WordLeft : CaretMoveDirection::Left); break;
+		case Key::Right: MoveCaret(_is_ctrl_down ? CaretMoveDirection::WordRight : CaretMoveDirection::Right); break;
 		case Key::Up: MoveCaret(CaretMoveDirection::Up); break;
 		case Key::Down: MoveCaret(CaretMoveDirection::Down); break;
 		case Key::Home: MoveCaret(CaretMoveDirection::Home); break;
@@ -21,21 +21,25 @@ public:
 			constexpr EditStyle& selection_color(Color selection_color) { _selection_color = selection_color; return *this; }
 			constexpr EditStyle& caret_color(Color caret_color) { _caret_color = caret_color; return *this; }
 			constexpr EditStyle& disable_edit() { _disable_edit = true; return *this; }
+			bool operator==(const EditStyle& other) const {
+				return _selection_color == other._selection_color && _caret_color == other._caret_color && _disable_edit == other._disable_edit;
+			}
 		}edit;
 
 		Style() { 
 			cursor.set(Cursor::Text); 
 		}
+		bool operator==(const Style& other) const { return TextBox::Style::operator==(other) && edit == other.edit; }
 	};
 
 public:
-	EditBox(unique_ptr<Style> style, const wstring& text = L"");
+	EditBox(style_ptr<Style> style, wstring text = L"");
 	~EditBox();
 
 
 	//// style ////
 protected:
-	Style& GetStyle() { return static_cast<Style&>(TextBox::GetStyle()); }
+	Style& ModifyStyle() { return static_cast<Style&>(TextBox::ModifyStyle()); }
 	const Style& GetStyle() const { return static_cast<const Style&>(TextBox::GetStyle()); }
 private:
 	const Style::EditStyle& GetEditStyle() const { return GetStyle().edit; }
@@ -47,14 +51,24 @@ public:
 	using HitTestInfo = TextBlockHitTestInfo;
 private:
 	WordBreakIterator _word_break_iterator;
+	wstring _word_break_paragraph;  // the text that the word break iterator refers to
+	uint _word_break_paragraph_begin = (uint)-1;
+	uint _word_break_text_revision = 0;
 private:
 	uint GetCharacterLength(uint text_position) {
-		const wstring& text = GetText();
-		assert(text_position < text.length());
-		return GetUTF16CharLength(text[text_position]);
+		const TextBuffer& text = GetText();
+		assert(text_position < text.GetLength());
+		wchar ch = text.GetChar(text_position);
+		if (ch == L'\r' && text_position + 1 < text.GetLength() && text.GetChar(text_position + 1) == L'\n') { return 2; }
+		return GetUTF16CharLength(ch);
+	}
+	// Returns the word at the text position, only the paragraph around it is given to the word break iterator, 
+	//   and is kept until another paragraph is queried or the text is modified.
+	const TextRange GetWordRange(uint text_position);
+	bool IsSpace(TextRange word_range) const {
+		wchar ch = GetText().GetChar(word_range.begin);
+		return ch == L' ' || ch == L'\t';
 	}
-public:
-	virtual void OnTextChange();
 
 
 	//// layout update and composition ////
@@ -83,7 +97,7 @@ private:
 	// caret position
 private:
 	static const uint caret_width = 1;
-	enum class CaretMoveDirection { Left, Right, Up, Down, Home, End };
+	enum class CaretMoveDirection { Left, Right, Up, Down, Home, End, WordLeft, WordRight };
 private:
 	uint _caret_text_position = 0;
 	Rect _caret_region = region_empty;
@@ -93,6 +107,9 @@ private:
 	void SetCaret(Point mouse_down_position);
 	void SetCaret(uint text_position, bool is_trailing_hit);
 	void MoveCaret(CaretMoveDirection direction);
+public:
+	// Move the caret to the beginning of the paragraph at index and scroll it into view, as for going to a line.
+	void GoToParagraph(uint index);
 
 
 	//// selection ////
@@ -6,6 +6,13 @@
 BEGIN_NAMESPACE(WndDesign)
 
 
+uint FlowLayout::HitTestRow(uint y) const {
+	auto cmp_row = [](uint y, const RowContainer& row) { return y < row.y; };
+	auto it_row = std::upper_bound(_rows.begin(), _rows.end(), y, cmp_row);
+	if (it_row == _rows.begin()) { return pos_end; }
+	return (uint)(it_row - _rows.begin() - 1);
+}
+
 uint FlowLayout::HitTestChild(uint x, uint y) const {
 	// hit test row
 	if (_rows.empty()) { return pos_end; }
@@ -21,49 +28,203 @@ uint FlowLayout::HitTestChild(uint x, uint y) const {
 	return (uint)(it_child - _child_wnds.begin());
 }
 
+uint FlowLayout::GetChildRow(uint pos) const {
+	auto cmp_row = [](uint pos, const RowContainer& row) { return pos < row.child_begin; };
+	auto it_row = std::upper_bound(_rows.begin(), _rows.end(), pos, cmp_row);
+	if (it_row == _rows.begin() || pos >= (it_row - 1)->child_end) { return (uint)_rows.size(); }
+	return (uint)(it_row - _rows.begin() - 1);
+}
+
 void FlowLayout::SetChild(WndObject& child, uint pos) {
-	if (pos >= _child_wnds.size()) { throw std::invalid_argument("invalid row number"); }
-	//RemoveChild(pos);
-	//RegisterChild(child);
-	//_rows[row].wnd = &child;
-	//_rows[row].Invalidate();
-	//SetChildData(child, row);
+	if (pos >= _child_wnds.size()) { throw std::invalid_argument("invalid child position"); }
+	EraseChild(pos);
+	InsertChild(child, pos);
 }
 
 void FlowLayout::InsertChild(WndObject& child, uint pos) {
+	uint child_number = (uint)_child_wnds.size();
+	if (pos > child_number) { pos = child_number; }
+	RegisterChild(child);
+	_child_wnds.insert(_child_wnds.begin() + pos, ChildContainer{ &child });
+	for (uint i = pos; i <= child_number; ++i) { SetChildData(*_child_wnds[i].wnd, i); }
+	ContentLayoutChanged(pos);
+}
+
+void FlowLayout::InsertChildren(const vector<ref_ptr<WndObject>>& children, uint pos) {
+	if (children.empty()) { return; }
+	uint child_number = (uint)_child_wnds.size();
+	if (pos > child_number) { pos = child_number; }
+	vector<ChildContainer> child_containers; child_containers.reserve(children.size());
+	for (auto child : children) { RegisterChild(*child); child_containers.push_back(ChildContainer{ child }); }
+	_child_wnds.insert(_child_wnds.begin() + pos, child_containers.begin(), child_containers.end());
+	for (uint i = pos; i < _child_wnds.size(); ++i) { SetChildData(*_child_wnds[i].wnd, i); }
+	ContentLayoutChanged(pos);
 }
 
 void FlowLayout::RemoveChild(uint pos_begin, uint child_count) {
+	uint child_number = (uint)_child_wnds.size();
+	if (pos_begin >= child_number || child_count == 0) { return; }
+	if (child_count > child_number - pos_begin) { child_count = child_number - pos_begin; }
+	uint pos_last = pos_begin + child_count;
+	// Detach all the child windows first, and erase their positions at once.
+	for (uint pos = pos_begin; pos < pos_last; ++pos) {
+		ref_ptr<WndObject> child = _child_wnds[pos].wnd;
+		_child_wnds[pos].wnd = nullptr;
+		WndObject::RemoveChild(*child);
+	}
+	_child_wnds.erase(_child_wnds.begin() + pos_begin, _child_wnds.begin() + pos_last);
+	for (uint i = pos_begin; i < child_number - child_count; ++i) { SetChildData(*_child_wnds[i].wnd, i); }
+	ContentLayoutChanged(pos_begin);
 }
 
 void FlowLayout::EraseChild(uint pos_begin, uint child_count) {
+	RemoveChild(pos_begin, child_count);
 }
 
 void FlowLayout::OnChildDetach(WndObject& child) {
+	Wnd::OnChildDetach(child);
+	uint pos = GetChildData(child);
+	assert(pos < _child_wnds.size());
+	if (_child_wnds[pos].wnd == nullptr) { return; }  // removed by RemoveChild()
+	assert(_child_wnds[pos].wnd == &child);
+	_child_wnds.erase(_child_wnds.begin() + pos);
+	for (uint i = pos; i < _child_wnds.size(); ++i) { SetChildData(*_child_wnds[i].wnd, i); }
+	ContentLayoutChanged(pos);
 }
 
-void FlowLayout::ContentLayoutChanged(uint row_begin) {
-
+void FlowLayout::ContentLayoutChanged(uint pos) {
+	// Lines are broken again from the row of the previous child, which may have room for the child at pos now.
+	uint row = pos == 0 ? 0 : GetChildRow(pos - 1);
+	uint y = row < _rows.size() ? _rows[row].y : _content_size.height;
+	_rows.resize(row);
+	if (_invalid_top == -1) { Wnd::ContentLayoutChanged(); }
+	if (y < _invalid_top) { _invalid_top = y; }
 }
 
 void FlowLayout::ChildRegionMayChange(WndObject& child) {
+	uint pos = GetChildData(child);
+	_child_wnds[pos].invalid = true;
+	ContentLayoutChanged(pos);
+}
 
+void FlowLayout::ClientWidthChanged(Size client_size) {
+	// Only the children whose size depends on client width are measured again, 
+	//   the others are clamped to the new width and rows are broken again with the cached sizes.
+	for (auto& child_container : _child_wnds) {
+		if (child_container.invalid) { continue; }
+		if (GetChildParentSizeDependency(*child_container.wnd, client_size).width != child_container.width_dependency) {
+			child_container.invalid = true;
+		} else {
+			child_container.size.width = std::min(child_container.measured_width, client_size.width);
+		}
+	}
+	_rows.clear();
+	_invalid_top = 0;
 }
 
 const Rect FlowLayout::UpdateContentLayout(Size client_size) {
-	return region_empty;
+	if (client_size.width != GetClientSize().width) { ClientWidthChanged(client_size); }
+	if (_invalid_top == -1) {
+		return Rect(point_zero, _content_size);
+	}
+
+	// Break lines from the end of the remaining rows.
+	uint item_spacing = GetStyle().spacing._item, line_spacing = GetStyle().spacing._line;
+	uint child_number = (uint)_child_wnds.size();
+	uint pos = _rows.empty() ? 0 : _rows.back().child_end;
+	uint y = _rows.empty() ? 0 : _rows.back().y + _rows.back().height + line_spacing;
+	while (pos < child_number) {
+		RowContainer row{ y, 0, 0, pos, pos };
+		uint x = 0;
+		for (; pos < child_number; ++pos) {
+			ChildContainer& child_container = _child_wnds[pos];
+			if (child_container.invalid) {
+				child_container.size = UpdateChildRegion(*child_container.wnd, client_size).size;
+				child_container.measured_width = child_container.size.width;
+				child_container.width_dependency = GetChildParentSizeDependency(*child_container.wnd, client_size).width;
+				child_container.size.width = std::min(child_container.size.width, client_size.width);
+				child_container.invalid = false;
+			}
+			if (pos > row.child_begin && x + child_container.size.width > client_size.width) { break; }
+			child_container.x = x;
+			SetChildRegion(*child_container.wnd, Rect(Point((int)x, (int)y), child_container.size));
+			row.width = x + child_container.size.width;
+			row.height = std::max(row.height, child_container.size.height);
+			x = row.width + item_spacing;
+		}
+		row.child_end = pos;
+		_rows.push_back(row);
+		y += row.height + line_spacing;
+	}
+
+	uint max_width = 0;
+	for (auto& row : _rows) { max_width = std::max(max_width, row.width); }
+	Size content_size(max_width, _rows.empty() ? 0 : _rows.back().y + _rows.back().height);
+	uint invalid_bottom = std::max(_content_size.height, content_size.height);
+	if (_invalid_top < invalid_bottom) {
+		Invalidate(Rect(0, (int)_invalid_top, std::max(_content_size.width, content_size.width), invalid_bottom - _invalid_top));
+	}
+	_content_size = content_size;
+	_invalid_top = -1;
+	return Rect(point_zero, _content_size);
 }
 
 void FlowLayout::OnChildRegionUpdate(WndObject& child) {
+	uint pos = GetChildData(child);
+	ChildContainer& child_container = _child_wnds[pos];
+	uint row = GetChildRow(pos);
+	Size client_size = GetClientSize();
+	Size size = UpdateChildRegion(child, client_size).size;
+	child_container.measured_width = size.width;
+	child_container.width_dependency = GetChildParentSizeDependency(child, client_size).width;
+	size.width = std::min(size.width, client_size.width);
+	if (!child_container.invalid && row < _rows.size() && size == child_container.size) {
+		SetChildRegion(child, Rect(Point((int)child_container.x, (int)_rows[row].y), size));
+	} else {
+		child_container.invalid = true;
+		ContentLayoutChanged(pos);
+	}
+}
 
+bool FlowLayout::QueryClientChildren(Rect client_region, vector<ref_ptr<WndObject>>& children) const {
+	uint row_begin = HitTestRow((uint)std::max(client_region.top(), 0));
+	if (row_begin == pos_end) { row_begin = 0; }
+	for (uint row = row_begin; row < _rows.size() && (int)_rows[row].y < client_region.bottom(); ++row) {
+		for (uint pos = _rows[row].child_begin; pos < _rows[row].child_end; ++pos) { children.push_back(_child_wnds[pos].wnd); }
+	}
+	// Children not broken into rows yet are positioned at next layout update.
+	uint pos = _rows.empty() ? 0 : _rows.back().child_end;
+	for (; pos < _child_wnds.size(); ++pos) { children.push_back(_child_wnds[pos].wnd); }
+	return true;
 }
 
 void FlowLayout::OnClientPaint(FigureQueue& figure_queue, Rect client_region, Rect invalid_client_region) const {
-
+	uint row_begin = HitTestRow((uint)std::max(invalid_client_region.top(), 0));
+	if (row_begin == pos_end) { return; }
+	auto cmp_pos = [](const ChildContainer& child, uint x) { return child.x + child.size.width <= x; };
+	for (uint row = row_begin; row < _rows.size() && (int)_rows[row].y < invalid_client_region.bottom(); ++row) {
+		const RowContainer& row_container = _rows[row];
+		// Skip the children on the left of the invalid region.
+		auto it_child = std::lower_bound(_child_wnds.begin() + row_container.child_begin, _child_wnds.begin() + row_container.child_end,
+										 (uint)std::max(invalid_client_region.left(), 0), cmp_pos);
+		for (; it_child != _child_wnds.begin() + row_container.child_end && (int)it_child->x < invalid_client_region.right(); ++it_child) {
+			Rect child_region = Rect(Point((int)it_child->x, (int)row_container.y), it_child->size);
+			Rect child_invalid_region = child_region.Intersect(invalid_client_region);
+			if (!child_invalid_region.IsEmpty()) {
+				CompositeChild(*it_child->wnd, figure_queue, child_invalid_region);
+			}
+		}
+	}
 }
 
 const Wnd::HitTestInfo FlowLayout::ClientHitTest(Size client_size, Point point) const {
-	return {};
+	if (point.x < 0 || point.y < 0) { return {}; }
+	uint pos = HitTestChild((uint)point.x, (uint)point.y);
+	if (pos == pos_end) { return {}; }
+	const ChildContainer& child_container = _child_wnds[pos];
+	Point point_on_child = point - Vector((int)child_container.x, (int)_rows[HitTestRow((uint)point.y)].y);
+	if ((uint)point_on_child.y >= child_container.size.height) { return {}; }
+	return { child_container.wnd, point_on_child };
 }
 
 
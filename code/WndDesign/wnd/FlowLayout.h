@@ -21,23 +21,25 @@ public:
 		public:
 			constexpr SpacingStyle& item(uint item) { _item = item; return *this; }
 			constexpr SpacingStyle& line(uint line) { _line = line; return *this; }
+			constexpr bool operator==(const SpacingStyle& other) const { return _item == other._item && _line == other._line; }
 		}spacing;
 
 		Style() {
-			scrollbar.set(CreateDefaultScrollbar());
+			scrollbar.set(GetDefaultScrollbar());
 			client.height.min(0px).normal(length_auto).max(length_max_tag);
 			client.width.min(0px).normal(length_auto).max(100pct);
 		}
+		bool operator==(const Style& other) const { return Wnd::Style::operator==(other) && spacing == other.spacing; }
 	};
 
 public:
-	FlowLayout(unique_ptr<Style> style) : Wnd(std::move(style)) {}
+	FlowLayout(style_ptr<Style> style) : Wnd(std::move(style)) {}
 	~FlowLayout() {}
 
 
 	//// style ////
 protected:
-	Style& GetStyle() { return static_cast<Style&>(Wnd::GetStyle()); }
+	Style& ModifyStyle() { return static_cast<Style&>(Wnd::ModifyStyle()); }
 	const Style& GetStyle() const { return static_cast<const Style&>(Wnd::GetStyle()); }
 
 
@@ -48,9 +50,11 @@ public:
 private:
 	struct ChildContainer {
 		ref_ptr<WndObject> wnd = nullptr;
-		Size size = size_empty;
-		uint row = -1;
+		Size size = size_empty;  // width clamped to client width
+		uint measured_width = 0;
+		uint width_dependency = 0;  // the part of client width the measured size depends on
 		uint x = -1;
+		bool invalid = true;  // size is to be measured
 	};
 
 	struct RowContainer {
@@ -63,18 +67,24 @@ private:
 
 private:
 	vector<ChildContainer> _child_wnds;
-	vector<RowContainer> _rows;
+	vector<RowContainer> _rows;  // rows are broken again from the end of _rows at layout update
+	Size _content_size;
 
 private:
+	uint HitTestRow(uint y) const;
 	uint HitTestChild(uint x, uint y) const;
+	uint GetChildRow(uint pos) const;
 
 private:
-	static void SetChildData(WndObject& child, uint row) { WndObject::SetChildData<uint>(child, row); }
+	static void SetChildData(WndObject& child, uint pos) { WndObject::SetChildData<uint>(child, pos); }
 	static uint GetChildData(WndObject& child) { return WndObject::GetChildData<uint>(child); }
 public:
 	void SetChild(WndObject& child, uint pos);
 	void InsertChild(WndObject& child, uint pos);
 	void AppendChild(WndObject& child) { InsertChild(child, pos_end); }
+	// Insert all the children at once, with the positions after them updated only once.
+	void InsertChildren(const vector<ref_ptr<WndObject>>& children, uint pos);
+	void AppendChildren(const vector<ref_ptr<WndObject>>& children) { InsertChildren(children, pos_end); }
 	void RemoveChild(uint pos_begin, uint child_count = 1);
 	void EraseChild(uint pos_begin, uint child_count = 1);
 private:
@@ -83,13 +93,15 @@ private:
 
 	//// layout update ////
 private:
-	uint _invalid_layout_child_begin = 0;
+	uint _invalid_top = -1;  // the top of the region to redraw after layout
 private:
-	void ContentLayoutChanged(uint row_begin);
+	void ContentLayoutChanged(uint pos);
+	void ClientWidthChanged(Size client_size);
 private:
 	virtual void ChildRegionMayChange(WndObject& child) override;
 	virtual const Rect UpdateContentLayout(Size client_size);
 	virtual void OnChildRegionUpdate(WndObject& child) override;
+	virtual bool QueryClientChildren(Rect client_region, vector<ref_ptr<WndObject>>& children) const override;
 
 
 	//// painting and composition ////
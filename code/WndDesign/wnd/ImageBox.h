@@ -12,7 +12,7 @@ public:
 	using Style = Wnd::Style;
 
 public:
-	ImageBox(unique_ptr<Style> style, unique_ptr<Image> image) :
+	ImageBox(style_ptr<Style> style, unique_ptr<Image> image) :
 		Wnd(std::move(style)), _image(std::move(image)) {
 	}
 	~ImageBox() {}
@@ -2,6 +2,7 @@
 #include "../style/style_helper.h"
 
 #include <algorithm>
+#include <chrono>
 
 
 BEGIN_NAMESPACE(WndDesign)
@@ -17,11 +18,9 @@ public:
 	bool IsGridWidthAuto() const { return client.width._normal.IsAuto(); }
 	bool IsGridSizeAuto() const { return IsGridHeightAuto() || IsGridWidthAuto(); }
 	uint CalculateGridHeight(uint client_height) const {
-		auto& style = GetStyleCalculator(static_cast<const WndStyle&>(*this));
-		LengthStyle height = grid_height;
-		height = style.ConvertLengthToPixel(height, client_height);
+		LengthStyle height = StyleCalculator::ConvertLengthToPixel(grid_height, client_height);
 		if (height._normal.IsAuto()) { return height._max.AsUnsigned(); }
-		height._normal = style.Clamp(height._normal, height._min, height._max);
+		height._normal = StyleCalculator::Clamp(height._normal, height._min, height._max);
 		return height._normal.AsUnsigned();
 	}
 	const std::pair<uint, uint> CalculateMinMaxGridHeight(uint client_height) const {
@@ -32,7 +31,7 @@ public:
 	}
 };
 
-const ListLayoutStyleCalculator& GetStyleCalculator(ListLayout::Style& style) {
+const ListLayoutStyleCalculator& GetStyleCalculator(const ListLayout::Style& style) {
 	return static_cast<const ListLayoutStyleCalculator&>(style);
 }
 
@@ -40,12 +39,9 @@ const ListLayoutStyleCalculator& GetStyleCalculator(ListLayout::Style& style) {
 END_NAMESPACE(Anonymous)
 
 
-uint ListLayout::HitTestRow(uint y) const {
-	auto cmp = [](const RowContainer& row, uint y) { return row.y > y; };
-	auto it_row = std::lower_bound(_rows.rbegin(), _rows.rend(), y, cmp);
-	assert(it_row != _rows.rend());  // underflow (never happens because y >= 0)
-	if (it_row == _rows.rbegin() && y - it_row->y >= it_row->height) { return row_end; }  // overflow
-	return (uint)(_rows.rend() - it_row - 1);
+ListLayout::~ListLayout() {
+	// Detach item windows, which may be destroyed with the item source.
+	for (auto item : vector<ref_ptr<WndObject>>(_realized_items)) { WndObject::RemoveChild(*item); }
 }
 
 void ListLayout::SetRowNumber(uint row_number) {
@@ -62,22 +58,30 @@ void ListLayout::InsertRow(uint row_begin, uint row_count) {
 	if (row_count == 0) { return; }
 	uint row_number = GetRowNumber();
 	if (row_begin > row_number) { row_begin = row_number; }
-	_rows.insert(_rows.begin() + row_begin, row_count, RowContainer());
-	for (uint row = row_begin + row_count; row < row_number + row_count; ++row) {
-		if (_rows[row].wnd != nullptr) { SetChildData(*_rows[row].wnd, row); }
+	SaveAnchor();
+	uint y = row_begin < row_number ? GetRowY(*_rows.GetRow(row_begin)) : _content_size.height;
+	if (_is_uniform) {
+		_rows.Insert(row_begin, row_count, _uniform_row_height);
+	} else if (IsVirtual()) {
+		_rows.Insert(row_begin, row_count, [&](uint i) { return EstimateRowHeight(row_begin + i); });
+	} else {
+		_rows.Insert(row_begin, row_count, std::max(_estimated_row_height, _min_max_grid_height.first));
 	}
-	ContentLayoutChanged(row_begin);
+	ContentLayoutChanged(y);
 }
 
 void ListLayout::EraseEmptyRow(uint row_begin, uint row_count) {
 	uint row_number = GetRowNumber();
 	if (row_begin >= row_number || row_count == 0) { return; }
 	if (row_count > row_number - row_begin) { row_count = row_number - row_begin; }
-	_rows.erase(_rows.begin() + row_begin, _rows.begin() + row_begin + row_count);
-	for (uint row = row_begin; row < row_number - row_count; ++row) {
-		if (_rows[row].wnd != nullptr) { SetChildData(*_rows[row].wnd, row); }
+	SaveAnchor();
+	if (_anchor_row != nullptr) {
+		uint anchor_index = _rows.GetIndex(*_anchor_row);
+		if (anchor_index >= row_begin && anchor_index - row_begin < row_count) { _anchor_row = nullptr; }
 	}
-	ContentLayoutChanged(row_begin);
+	uint y = GetRowY(*_rows.GetRow(row_begin));
+	_rows.Erase(row_begin, row_count);
+	ContentLayoutChanged(y);
 }
 
 void ListLayout::EraseRow(uint row_begin, uint row_count) {
@@ -88,11 +92,16 @@ void ListLayout::EraseRow(uint row_begin, uint row_count) {
 
 void ListLayout::SetChild(WndObject& child, uint row) {
 	if (row >= GetRowNumber()) { throw std::invalid_argument("invalid row number"); }
+	if (IsVirtual()) { throw std::invalid_argument("child windows of a virtual list are created by the item source"); }
 	RemoveChild(row);
 	RegisterChild(child);
-	_rows[row].wnd = &child;
-	_rows[row].Invalidate();
-	SetChildData(child, row);
+	Row& row_container = *_rows.GetRow(row);
+	SaveAnchor();
+	row_container.wnd = &child;
+	row_container.estimated = true;
+	_rows.Update(row_container);
+	SetChildData(child, row_container);
+	RowLayoutChanged(row_container);
 }
 
 void ListLayout::InsertChild(WndObject& child, uint row) {
@@ -102,129 +111,380 @@ void ListLayout::InsertChild(WndObject& child, uint row) {
 	SetChild(child, row);
 }
 
+void ListLayout::InsertChildren(const vector<ref_ptr<WndObject>>& children, uint row_begin) {
+	if (IsVirtual()) { throw std::invalid_argument("child windows of a virtual list are created by the item source"); }
+	if (children.empty()) { return; }
+	uint row_number = GetRowNumber();
+	if (row_begin > row_number) { row_begin = row_number; }
+	InsertRow(row_begin, (uint)children.size());
+	// The new rows are already estimated, so they are only bound to the children.
+	ref_ptr<Row> row = _rows.GetRow(row_begin);
+	for (auto child : children) {
+		RegisterChild(*child);
+		row->wnd = child;
+		SetChildData(*child, *row);
+		row = RowIndex::GetNext(*row);
+	}
+}
+
 void ListLayout::RemoveChild(uint row_begin, uint row_count) {
 	uint row_number = GetRowNumber();
 	if (row_begin >= row_number || row_count == 0) { return; }
 	if (row_count > row_number - row_begin) { row_count = row_number - row_begin; }
-	for (uint row = row_begin; row < row_begin + row_count; ++row) {
-		if (_rows[row].wnd != nullptr) {
-			WndObject::RemoveChild(*_rows[row].wnd);
+	ref_ptr<Row> row = _rows.GetRow(row_begin);
+	for (uint i = 0; i < row_count; ++i, row = RowIndex::GetNext(*row)) {
+		if (row->wnd != nullptr) {
+			if (IsVirtual()) { _item_source->UnbindItem(*row->wnd, row_begin + i); }
+			WndObject::RemoveChild(*row->wnd);
 		}
 	}
 }
 
 void ListLayout::OnChildDetach(WndObject& child) {
 	Wnd::OnChildDetach(child);
-	uint row = GetChildData(child);
-	assert(row < GetRowNumber() && _rows[row].wnd == &child);
-	_rows[row].wnd = nullptr;
-	_rows[row].Invalidate();
-	ContentLayoutChanged(row);
+	Row& row = GetChildData(child);
+	assert(row.wnd == &child);
+	auto it = std::find(_positioned_children.begin(), _positioned_children.end(), &child);
+	if (it != _positioned_children.end()) { _positioned_children.erase(it); }
+	if (IsVirtual()) {
+		// The row keeps its measured height, and the item window goes back to the recycle pool.
+		row.wnd = nullptr;
+		auto it = std::lower_bound(_realized_items.begin(), _realized_items.end(), &child);
+		if (it != _realized_items.end() && *it == &child) { _realized_items.erase(it); }
+		_recycled_items.push_back(&child);
+		return;
+	}
+	SaveAnchor();
+	row.wnd = nullptr;
+	row.estimated = true;
+	_rows.Update(row);
+	RowLayoutChanged(row);
+}
+
+void ListLayout::SetItemSource(ItemSource& item_source, uint row_number) {
+	EraseRow(0, GetRowNumber());
+	_recycled_items.clear();
+	_item_source = &item_source;
+	InsertRow(0, row_number);
+}
+
+void ListLayout::RebindItem(uint row_begin, uint row_count) {
+	if (!IsVirtual()) { return; }
+	uint row_number = GetRowNumber();
+	if (row_begin >= row_number || row_count == 0) { return; }
+	if (row_count > row_number - row_begin) { row_count = row_number - row_begin; }
+	ref_ptr<Row> row = _rows.GetRow(row_begin);
+	for (uint i = 0; i < row_count; ++i, row = RowIndex::GetNext(*row)) {
+		if (row->wnd != nullptr) {
+			_item_source->BindItem(*row->wnd, row_begin + i);
+			SaveAnchor();
+			row->estimated = true;
+			_rows.Update(*row);
+			RowLayoutChanged(*row);
+		} else if (!row->estimated && !_is_uniform) {
+			// The measured height is no longer valid.
+			row->height = EstimateRowHeight(row_begin + i);
+			row->estimated = true;
+			_rows.Update(*row);
+			ContentLayoutChanged(GetRowY(*row));
+		}
+	}
+}
+
+uint ListLayout::EstimateRowHeight(uint row) {
+	uint height = _item_source->EstimateHeight(row);
+	if (height == 0) { height = _estimated_row_height; }
+	return std::max(height, _min_max_grid_height.first);
+}
+
+void ListLayout::RealizeItem(Row& row) {
+	ref_ptr<WndObject> item;
+	if (_recycled_items.empty()) {
+		item = &_item_source->CreateItem();
+	} else {
+		item = _recycled_items.back();
+		_recycled_items.pop_back();
+	}
+	_item_source->BindItem(*item, _rows.GetIndex(row));
+	RegisterChild(*item);
+	row.wnd = item;
+	row.estimated = true;
+	_rows.Update(row);
+	SetChildData(*item, row);
+}
+
+void ListLayout::RealizeItems(Size client_size, std::function<void(Row&)> measure_row) {
+	// Realize and measure rows in the cached region, at their actual positions after measuring the rows above.
+	vector<ref_ptr<WndObject>> realized_items;
+	if (!_cached_client_region.IsEmpty()) {
+		ref_ptr<Row> row = HitTestRow((uint)std::max(_cached_client_region.top(), 0));
+		uint y = row == nullptr ? 0 : GetRowY(*row);
+		for (; row != nullptr && (int)y < _cached_client_region.bottom(); row = RowIndex::GetNext(*row)) {
+			if (row->wnd == nullptr) { RealizeItem(*row); }
+			if (!IsRowMeasured(*row)) { measure_row(*row); }
+			realized_items.push_back(row->wnd);
+			y += row->height + _rows.GetGridlineWidth();
+		}
+	}
+	std::sort(realized_items.begin(), realized_items.end());
+
+	// Recycle the items leaving the cached region.
+	vector<ref_ptr<WndObject>> old_realized_items = std::move(_realized_items);
+	_realized_items = std::move(realized_items);
+	for (auto item : old_realized_items) {
+		if (!std::binary_search(_realized_items.begin(), _realized_items.end(), item)) {
+			_item_source->UnbindItem(*item, _rows.GetIndex(GetChildData(*item)));
+			WndObject::RemoveChild(*item);
+		}
+	}
+}
+
+bool ListLayout::IsCachedRegionMeasured() const {
+	if (!IsVirtual() && !_is_uniform) { return true; }
+	if (_cached_client_region.IsEmpty()) { return _realized_items.empty(); }
+	uint realized_item_number = 0;
+	ref_ptr<const Row> row = HitTestRow((uint)std::max(_cached_client_region.top(), 0));
+	uint y = row == nullptr ? 0 : GetRowY(*row);
+	for (; row != nullptr && (int)y < _cached_client_region.bottom(); row = RowIndex::GetNext(*row)) {
+		if (IsVirtual() && row->wnd == nullptr) { return false; }
+		if (row->wnd != nullptr && !IsRowMeasured(*row)) { return false; }
+		realized_item_number++;
+		y += row->height + _rows.GetGridlineWidth();
+	}
+	return !IsVirtual() || realized_item_number == _realized_items.size();
+}
+
+void ListLayout::MeasureCachedRows(Size client_size, std::function<void(Row&)> measure_row) {
+	if (_cached_client_region.IsEmpty()) { return; }
+	ref_ptr<Row> row = HitTestRow((uint)std::max(_cached_client_region.top(), 0));
+	uint y = row == nullptr ? 0 : GetRowY(*row);
+	for (; row != nullptr && (int)y < _cached_client_region.bottom(); row = RowIndex::GetNext(*row)) {
+		if (row->wnd != nullptr && !IsRowMeasured(*row)) { measure_row(*row); }
+		y += row->height + _rows.GetGridlineWidth();
+	}
+}
+
+ref_ptr<ListLayout::Row> ListLayout::HitTestRow(uint y) const {
+	uint row_pitch = _uniform_row_height + _rows.GetGridlineWidth();
+	if (!_is_uniform || row_pitch == 0) { return _rows.HitTest(y); }
+	uint row = y / row_pitch;
+	if (row + 1 == GetRowNumber() && y % row_pitch >= _uniform_row_height) { return nullptr; }  // gridline below the last row
+	return _rows.GetRow(row);
 }
 
-void ListLayout::ContentLayoutChanged(uint row_begin) {
-	if (_invalid_layout_row_begin == -1) { Wnd::ContentLayoutChanged(); }
-	if (row_begin < _invalid_layout_row_begin) { _invalid_layout_row_begin = row_begin; }
+uint ListLayout::GetRowY(const Row& row) const {
+	if (!_is_uniform) { return _rows.GetY(row); }
+	return _rows.GetIndex(row) * (_uniform_row_height + _rows.GetGridlineWidth());
+}
+
+void ListLayout::ContentLayoutChanged(uint y) {
+	if (_invalid_top == -1) { Wnd::ContentLayoutChanged(); }
+	if (y < _invalid_top) { _invalid_top = y; }
+}
+
+void ListLayout::RowLayoutChanged(Row& row) {
+	if (_is_uniform) {
+		// Rows below are not affected.
+		Invalidate(Rect(0, (int)GetRowY(row), GetClientSize().width, row.height));
+		ContentLayoutChanged(_content_size.height);
+	} else {
+		ContentLayoutChanged(GetRowY(row));
+	}
+}
+
+void ListLayout::SaveAnchor() {
+	if ((_layout_time_budget == 0 && !IsVirtual()) || _anchor_row != nullptr) { return; }
+	Rect display_region = GetDisplayRegion() - GetClientOffset();
+	_anchor_row = HitTestRow((uint)std::max(display_region.top(), 0));
+	if (_anchor_row != nullptr) { _anchor_y = GetRowY(*_anchor_row); }
 }
 
 void ListLayout::ChildRegionMayChange(WndObject& child) {
 	if (GetStyleCalculator(GetStyle()).IsGridSizeAuto()) {
-		uint row = GetChildData(child);
-		_rows[row].Invalidate();
-		ContentLayoutChanged(row);
+		Row& row = GetChildData(child);
+		SaveAnchor();
+		row.estimated = true;
+		_rows.Update(row);
+		RowLayoutChanged(row);
+	}
+}
+
+void ListLayout::MeasureRow(Row& row, Size client_size) {
+	uint min_grid_height = _min_max_grid_height.first, max_grid_height = _min_max_grid_height.second;
+	uint width = 0, height = min_grid_height;
+	if (row.wnd != nullptr) {
+		Size size = UpdateChildRegion(*row.wnd, _default_grid_size).size;
+		width = std::min(size.width, client_size.width);
+		height = StyleCalculator::Clamp(size.height, min_grid_height, max_grid_height);
 	}
+	bool changed = row.width != width || row.height != height;
+	row.width = width; row.height = height; row.estimated = false; row.measure_revision = _uniform_revision;
+	_rows.Update(row);
+	if (changed) { RowLayoutChanged(row); }
 }
 
 const Rect ListLayout::UpdateContentLayout(Size client_size) {
 	auto& style = GetStyleCalculator(GetStyle());
-	bool all_invalid = false;
 	if (client_size != GetClientSize()) {
 		bool default_grid_size_changed = UpdateDefaultGridSize(Size(client_size.width, style.CalculateGridHeight(client_size.height)));
 		bool min_max_grid_height_changed = UpdateMinMaxGridHeight(style.CalculateMinMaxGridHeight(client_size.height));
 		if (default_grid_size_changed || min_max_grid_height_changed) {
-			_invalid_layout_row_begin = 0;
-			all_invalid = true;
+			bool is_uniform = !style.IsGridHeightAuto() && _min_max_grid_height.first == _min_max_grid_height.second;
+			if (is_uniform && _is_uniform && _uniform_row_height == _min_max_grid_height.first) {
+				// Row heights don't change, and rows will be measured again when they are in the cached region.
+				_uniform_revision++;
+			} else if (is_uniform) {
+				_is_uniform = true;
+				_uniform_row_height = _min_max_grid_height.first;
+				_rows.SetAllEstimated(_uniform_row_height);
+			} else {
+				// Rows already measured keep their old heights as the estimated heights.
+				_is_uniform = false;
+				SaveAnchor();
+				_rows.SetAllEstimated();
+			}
+			_invalid_top = 0;
 		}
 	}
-	if (_invalid_layout_row_begin >= GetRowNumber()) {
+	if (_invalid_top == -1) {
 		return Rect(point_zero, _content_size);
 	}
-	uint min_grid_height = _min_max_grid_height.first, max_grid_height = _min_max_grid_height.second;
-	uint y0 = _rows[_invalid_layout_row_begin].y;
-	uint y = y0;
 	uint gridline_width = style.GetGridLineWidth();
-	uint max_child_width = 0;
-	for (uint row = 0; row < _invalid_layout_row_begin; ++row) {
-		max_child_width = std::max(max_child_width, _rows[row].width);
-	}
-	for (uint row = _invalid_layout_row_begin; row < GetRowNumber(); ++row) {
-		RowContainer& row_container = _rows[row];
-		uint height = row_container.height;
-		uint width = row_container.width;
-		if (all_invalid || row_container.IsInvalid()) {
-			if (row_container.wnd == nullptr) {
-				height = min_grid_height;
-				width = 0;
-			} else {
-				Size size = UpdateChildRegion(*row_container.wnd, _default_grid_size).size;
-				height = StyleCalculator::Clamp(size.height, min_grid_height, max_grid_height);
-				width = std::min(size.width, client_size.width);
+
+	// Rows in the display region are always measured, rows near the display region and the others are measured 
+	//   as long as the time budget allows, and the remaining rows keep their old heights or use estimated heights.
+	bool time_sliced = _layout_time_budget > 0;
+	using clock = std::chrono::steady_clock;
+	clock::time_point deadline = clock::now() + std::chrono::milliseconds(_layout_time_budget);
+	uint measured_height_sum = 0, measured_row_number = 0;
+	auto measure_row = [&](Row& row) {
+		MeasureRow(row, client_size);
+		if (row.wnd != nullptr) { measured_height_sum += row.height; measured_row_number++; }
+	};
+
+	if (IsVirtual()) {
+		// Only rows in the cached region are realized and measured.
+		SaveAnchor();
+		RealizeItems(client_size, measure_row);
+	} else if (_is_uniform) {
+		// Row positions don't depend on measurement, so only rows in the cached region are measured.
+		MeasureCachedRows(client_size, measure_row);
+	} else if (time_sliced) {
+		// Measure rows near the display region first, at their old or estimated positions.
+		Rect display_region = GetDisplayRegion() - GetClientOffset();
+		int near_top = display_region.top() - (int)display_region.size.height;
+		int near_bottom = display_region.bottom() + (int)display_region.size.height;
+		ref_ptr<Row> row = HitTestRow((uint)std::max(near_top, 0));
+		uint y = row == nullptr ? 0 : GetRowY(*row);
+		for (; row != nullptr && (int)y < near_bottom; row = RowIndex::GetNext(*row)) {
+			if (row->estimated) {
+				bool is_visible = (int)y < display_region.bottom() && (int)(y + row->height) > display_region.top();
+				if (is_visible || clock::now() < deadline) { measure_row(*row); }
 			}
+			y += row->height + gridline_width;
 		}
-		max_child_width = std::max(max_child_width, width);
-		assert(max_child_width <= client_size.width);
-		row_container.y = y;
-		row_container.height = height;
-		row_container.width = width;
-		if (row_container.wnd != nullptr) {
-			SetChildRegion(*row_container.wnd, Rect(0, (int)y, width, height));
-		}
-		y += height + gridline_width;
 	}
-	Invalidate(Rect(0, (int)y0, std::max(_content_size.width, max_child_width), std::max(_content_size.height, y) - y0));
-	_content_size.width = max_child_width;
-	_content_size.height = y > gridline_width ? y - gridline_width : 0;
-	_invalid_layout_row_begin = -1;
+
+	// Measure the other rows in order.
+	for (ref_ptr<Row> row = IsVirtual() || _is_uniform ? nullptr : _rows.FindEstimated(); row != nullptr; row = _rows.FindEstimated(_rows.GetIndex(*row))) {
+		if (time_sliced && row->wnd != nullptr && clock::now() >= deadline) { break; }
+		measure_row(*row);
+	}
+	if (measured_row_number > 0) { _estimated_row_height = measured_height_sum / measured_row_number; }
+
+	// Keep the anchor row still.
+	if (_anchor_row != nullptr) {
+		uint y = GetRowY(*_anchor_row);
+		if (y != _anchor_y) { ScrollAfterContentLayout(Vector(0, (int)y - (int)_anchor_y)); }
+		_anchor_row = nullptr;
+	}
+
+	Size content_size(std::min(_rows.GetMaxWidth(), client_size.width), _rows.GetTotalHeight());
+	uint invalid_bottom = std::max(_content_size.height, content_size.height);
+	if (_invalid_top < invalid_bottom) {
+		Invalidate(Rect(0, (int)_invalid_top, std::max(_content_size.width, content_size.width), invalid_bottom - _invalid_top));
+	}
+	_content_size = content_size;
+	_invalid_top = -1;
+	UpdateChildPositions();
+
+	// Continue measuring the remaining rows on the next frame.
+	if (IsLayoutPending()) { _layout_timer.Set(1); }
 	return Rect(point_zero, _content_size);
 }
 
 void ListLayout::OnChildRegionUpdate(WndObject& child) {
-	uint row = GetChildData(child);
-	assert(row < GetRowNumber());
+	Row& row = GetChildData(child);
 	assert(!GetStyleCalculator(GetStyle()).IsGridSizeAuto());
 	Size size = UpdateChildRegion(child, _default_grid_size).size;
-	_rows[row].width = std::min(size.width, _default_grid_size.width);
-	SetChildRegion(child, Rect(0, _rows[row].y, _rows[row].width, std::min(size.height, _rows[row].height)));
+	row.width = std::min(size.width, _default_grid_size.width);
+	_rows.Update(row);
+	SetChildRegion(child, Rect(0, (int)GetRowY(row), row.width, std::min(size.height, row.height)));
+}
+
+void ListLayout::UpdateChildPositions() {
+	// Position the children leaving the cached region for the last time.
+	for (auto child : _positioned_children) {
+		Row& row = GetChildData(*child);
+		SetChildRegion(*child, Rect(0, (int)GetRowY(row), row.width, row.height));
+	}
+	_positioned_children.clear();
+	if (_cached_client_region.IsEmpty()) { return; }
+	ref_ptr<Row> row = HitTestRow((uint)std::max(_cached_client_region.top(), 0));
+	uint y = row == nullptr ? 0 : GetRowY(*row);
+	for (; row != nullptr && (int)y < _cached_client_region.bottom(); row = RowIndex::GetNext(*row)) {
+		if (row->wnd != nullptr && IsRowMeasured(*row)) {
+			SetChildRegion(*row->wnd, Rect(0, (int)y, row->width, row->height));
+			_positioned_children.push_back(row->wnd);
+		}
+		y += row->height + _rows.GetGridlineWidth();
+	}
+}
+
+void ListLayout::OnCachedRegionChange(Rect accessible_region, Rect cached_region) {
+	_cached_client_region = cached_region - GetClientOffset();
+	if (!IsCachedRegionMeasured()) { ContentLayoutChanged(_content_size.height); }
+	UpdateChildPositions();
+}
+
+bool ListLayout::QueryClientChildren(Rect client_region, vector<ref_ptr<WndObject>>& children) const {
+	// Children of the rows outside the region are either positioned outside it or not positioned since they left the cached region.
+	ref_ptr<const Row> row = HitTestRow((uint)std::max(client_region.top(), 0));
+	uint y = row == nullptr ? 0 : GetRowY(*row);
+	for (; row != nullptr && (int)y < client_region.bottom(); row = RowIndex::GetNext(*row)) {
+		if (row->wnd != nullptr) { children.push_back(row->wnd); }
+		y += row->height + _rows.GetGridlineWidth();
+	}
+	return true;
 }
 
 void ListLayout::OnClientPaint(FigureQueue& figure_queue, Rect client_region, Rect invalid_client_region) const {
-	uint y1 = (uint)invalid_client_region.top(), y2 = (uint)invalid_client_region.bottom() - 1;
-	uint row1 = HitTestRow(y1), row2 = HitTestRow(y2);
-	if (row1 == row_end) { return; } 
-	if (row2 == row_end) { row2 = GetRowNumber() - 1; }
-	assert(row1 != row_end && row2 != row_end && row2 >= row1);
-	for (uint row = row1; row <= row2; ++row) {
-		const RowContainer& row_container = _rows[row];
+	ref_ptr<const Row> row = HitTestRow((uint)invalid_client_region.top());
+	uint y = row == nullptr ? 0 : GetRowY(*row);
+	for (; row != nullptr && (int)y < invalid_client_region.bottom(); row = RowIndex::GetNext(*row)) {
 		// Composite child window.
-		if (row_container.wnd != nullptr) {
-			Rect child_region = Rect(0, (int)row_container.y, row_container.width, row_container.height);
+		if (row->wnd != nullptr && IsRowMeasured(*row)) {
+			Rect child_region = Rect(0, (int)y, row->width, row->height);
 			Rect child_invalid_region = child_region.Intersect(invalid_client_region);
 			if (!child_invalid_region.IsEmpty()) {
-				CompositeChild(*row_container.wnd, figure_queue, child_invalid_region);
+				CompositeChild(*row->wnd, figure_queue, child_invalid_region);
 			}
 		}
 		// Draw grid line as rectangle.
 		figure_queue.Append(
-			Point(0, row_container.y + row_container.height),
+			Point(0, (int)(y + row->height)),
 			new Rectangle(Size(client_region.size.width, GetStyle().gridline._width), GetStyle().gridline._color)
 		);
+		y += row->height + _rows.GetGridlineWidth();
 	}
 }
 
 const Wnd::HitTestInfo ListLayout::ClientHitTest(Size client_size, Point point) const {
-	uint y = (uint)point.y;	uint row = HitTestRow(y);
-	if (row == row_end || _rows[row].wnd == nullptr || y - _rows[row].y >= _rows[row].height) { return {}; }
-	return { _rows[row].wnd, Point(point.x, y - _rows[row].y) };
+	uint y = (uint)point.y; ref_ptr<const Row> row = HitTestRow(y);
+	if (row == nullptr || row->wnd == nullptr) { return {}; }
+	uint row_y = GetRowY(*row);
+	if (y - row_y >= row->height) { return {}; }
+	return { row->wnd, Point(point.x, (int)(y - row_y)) };
 }
 
 
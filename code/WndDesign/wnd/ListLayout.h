@@ -1,6 +1,8 @@
 #pragma once
 
 #include "Wnd.h"
+#include "../message/timer.h"
+#include "../common/row_index.h"
 
 #include <vector>
 
@@ -19,25 +21,29 @@ public:
 		public:
 			constexpr GridlineStyle& width(uint width) { _width = width; return *this; }
 			constexpr GridlineStyle& color(Color color) { _color = color; return *this; }
+			bool operator==(const GridlineStyle& other) const { return _width == other._width && _color == other._color; }
 		}gridline;
 
 		LengthStyle grid_height;
 
 		Style() {
-			scrollbar.set(CreateDefaultScrollbar());
+			scrollbar.set(GetDefaultScrollbar());
 			client.height.min(0px).normal(length_auto).max(length_max_tag);
 			client.width.min(0px).normal(length_auto).max(100pct);
 		}
+		bool operator==(const Style& other) const { 
+			return Wnd::Style::operator==(other) && gridline == other.gridline && grid_height == other.grid_height; 
+		}
 	};
 
 public:
-	ListLayout(unique_ptr<Style> style) : Wnd(std::move(style)) {}
-	~ListLayout() {}
+	ListLayout(style_ptr<Style> style) : Wnd(std::move(style)) { _rows.SetGridlineWidth(GetStyle().gridline._width); }
+	~ListLayout();
 
 
 	//// style ////
 protected:
-	Style& GetStyle() { return static_cast<Style&>(Wnd::GetStyle()); }
+	Style& ModifyStyle() { return static_cast<Style&>(Wnd::ModifyStyle()); }
 	const Style& GetStyle() const { return static_cast<const Style&>(Wnd::GetStyle()); }
 
 private:
@@ -56,21 +62,14 @@ private:
 public:
 	static constexpr uint row_end = -1;
 private:
-	struct RowContainer {
-		uint y = 0;
-		uint height = -1;
-		uint width = 0;
-		ref_ptr<WndObject> wnd = nullptr;
-	public:
-		void Invalidate() { height = -1; }
-		bool IsInvalid() const { return height == -1; }
-	};
-	vector<RowContainer> _rows;
+	using Row = RowIndex::Row;
+	RowIndex _rows;
 	Size _content_size;
 private:
-	uint HitTestRow(uint y) const;
+	ref_ptr<Row> HitTestRow(uint y) const;
+	uint GetRowY(const Row& row) const;
 public:
-	uint GetRowNumber() const { return (uint)_rows.size(); }
+	uint GetRowNumber() const { return _rows.GetRowNumber(); }
 	void SetRowNumber(uint row_number);
 	void InsertRow(uint row_begin, uint row_count = 1);
 private:
@@ -81,28 +80,97 @@ public:
 
 	//// child windows ////
 private:
-	static void SetChildData(WndObject& child, uint row) { WndObject::SetChildData<uint>(child, row); }
-	static uint GetChildData(WndObject& child) { return WndObject::GetChildData<uint>(child); }
+	static void SetChildData(WndObject& child, Row& row) { WndObject::SetChildData<ref_ptr<Row>>(child, &row); }
+	static Row& GetChildData(WndObject& child) { return *WndObject::GetChildData<ref_ptr<Row>>(child); }
 public:
 	void SetChild(WndObject& child, uint row);
 	void InsertChild(WndObject& child, uint row);
 	void AppendChild(WndObject& child) { InsertChild(child, row_end); }
+	// Insert rows for all the children at once, which is linear in the number of children.
+	void InsertChildren(const vector<ref_ptr<WndObject>>& children, uint row_begin);
+	void AppendChildren(const vector<ref_ptr<WndObject>>& children) { InsertChildren(children, row_end); }
 	void RemoveChild(uint row_begin, uint row_count = 1);
 	void EraseChild(uint row_begin, uint row_count = 1) { EraseRow(row_begin, row_count); }
 private:
 	virtual void OnChildDetach(WndObject& child) override;
 
 
+	//// virtual list ////
+public:
+	// Provides item windows for a virtual list. Rows of a virtual list have no windows by default, and item windows 
+	//   are created or reused and bound to rows only when the rows are in the cached region.
+	// Item windows are owned by the item source.
+	class ItemSource {
+	public:
+		virtual ~ItemSource() {}
+		virtual uint EstimateHeight(uint row) { return 0; }  // 0 for the average height of measured rows
+		virtual WndObject& CreateItem() pure;
+		virtual void BindItem(WndObject& item, uint row) pure;
+		virtual void UnbindItem(WndObject& item, uint row) {}
+	};
+private:
+	ref_ptr<ItemSource> _item_source = nullptr;
+	vector<ref_ptr<WndObject>> _recycled_items;
+	vector<ref_ptr<WndObject>> _realized_items;  // sorted
+public:
+	bool IsVirtual() const { return _item_source != nullptr; }
+	// Remove all rows and switch to virtual list with the item source and row number.
+	void SetItemSource(ItemSource& item_source, uint row_number);
+	// Bind the realized items again after the data of the rows changed.
+	void RebindItem(uint row_begin, uint row_count = 1);
+private:
+	uint EstimateRowHeight(uint row);
+	void RealizeItem(Row& row);
+	void RealizeItems(Size client_size, std::function<void(Row&)> measure_row);
+	bool IsCachedRegionMeasured() const;
+
+
 	//// layout update ////
 private:
-	uint _invalid_layout_row_begin = 0;
+	uint _invalid_top = -1;  // the top of the region to redraw after layout
 private:
-	void ContentLayoutChanged(uint row_begin);
+	void ContentLayoutChanged(uint y);
+	void RowLayoutChanged(Row& row);
+	void MeasureRow(Row& row, Size client_size);
+	bool IsRowMeasured(const Row& row) const { return !row.estimated && (!_is_uniform || row.measure_revision == _uniform_revision); }
+
+	// Uniform row height: when the grid height is fixed, all rows have the same height, so the y of a row is 
+	//   calculated from its index, and only the rows in the cached region are measured for their widths.
+private:
+	bool _is_uniform = false;
+	uint _uniform_row_height = 0;
+	uint _uniform_revision = 0;  // increased when all rows are to be measured again
+private:
+	void MeasureCachedRows(Size client_size, std::function<void(Row&)> measure_row);
+
+	// Time-sliced layout: when the time budget is set, rows in and near the display region are measured first, 
+	//   and the other rows are measured on later frames within the budget, with their heights estimated meanwhile.
+private:
+	uint _layout_time_budget = 0;  // in milliseconds, 0 for measuring all rows at once
+	uint _estimated_row_height = 0;  // average height of measured rows
+	ref_ptr<Row> _anchor_row = nullptr;  // the row at the top of display region, which is kept still
+	uint _anchor_y = 0;
+	Timer _layout_timer = Timer([&]() { _layout_timer.Stop(); ContentLayoutChanged(_content_size.height); });
+private:
+	void SaveAnchor();
+public:
+	void SetLayoutTimeBudget(uint milliseconds) { _layout_time_budget = milliseconds; }
+	bool IsLayoutPending() const { return !IsVirtual() && !_is_uniform && _rows.HasEstimatedRow(); }
 private:
 	virtual void ChildRegionMayChange(WndObject& child) override;
 	virtual const Rect UpdateContentLayout(Size client_size);
 	virtual void OnChildRegionUpdate(WndObject& child) override;
 
+	// Child windows are positioned only when they are in the cached region, so that inserting or resizing a row
+	//   doesn't move all the rows below it. Rows leaving the cached region are positioned for the last time.
+private:
+	Rect _cached_client_region = region_empty;
+	vector<ref_ptr<WndObject>> _positioned_children;
+private:
+	void UpdateChildPositions();
+	virtual void OnCachedRegionChange(Rect accessible_region, Rect cached_region) override;
+	virtual bool QueryClientChildren(Rect client_region, vector<ref_ptr<WndObject>>& children) const override;
+
 
 	//// painting and composition ////
 private:
@@ -1,25 +1,23 @@
 #include "OverlapLayout.h"
-#include "../common/reversion_wrapper.h"
 
 
 BEGIN_NAMESPACE(WndDesign)
 
 
 void OverlapLayout::InsertChild(WndObject& child, Rect region) {
+	// The child is put in front of the children with the same z-index.
 	CompositeEffect composite = child.GetCompositeEffect();
-	auto next_iter_pos = std::find_if(
-		_child_wnds.begin(), _child_wnds.end(),
-		[=](const ChildWndContainer& child_container) { return child_container.composite._z_index <= composite._z_index; }
-	);
-	auto iter_pos = _child_wnds.emplace(next_iter_pos, ChildWndContainer{ child, region, composite });
-	iter_pos->list_index = iter_pos;
-	SetChildData(child, *iter_pos);
+	uint64 order = ((uint64)(uchar)(composite._z_index + 0x80) << 56) | ++_child_sequence;
+	auto [iter_pos, inserted] = _child_wnds.emplace(order, ChildWndContainer{ child, region, composite, order });
+	_child_grid.Insert(iter_pos->second, region);
+	SetChildData(child, iter_pos->second);
 }
 
 const Rect OverlapLayout::EraseChild(WndObject& child) {
 	ChildWndContainer& child_container = GetChildData(child);
 	Rect region = child_container.region;
-	_child_wnds.erase(child_container.list_index);
+	_child_grid.Erase(child_container, region);
+	_child_wnds.erase(child_container.order);
 	return region;
 }
 
@@ -28,9 +26,19 @@ void OverlapLayout::AddChild(WndObject& child) {
 	InsertChild(child, region_empty);
 }
 
+void OverlapLayout::RemoveChildren(const vector<ref_ptr<WndObject>>& children) {
+	// The regions of the children are invalidated once as a whole.
+	_removed_region = region_empty;
+	_is_removing_children = true;
+	for (auto child : children) { WndObject::RemoveChild(*child); }
+	_is_removing_children = false;
+	Invalidate(_removed_region);
+}
+
 void OverlapLayout::OnChildDetach(WndObject& child) {
 	Wnd::OnChildDetach(child);
 	Rect region = EraseChild(child);
+	if (_is_removing_children) { _removed_region = _removed_region.Union(region); return; }
 	Invalidate(region);
 }
 
@@ -45,6 +53,8 @@ void OverlapLayout::UpdateChildRegion(ChildWndContainer& child_container, Size c
 	if (child_container.region != child_region) {
 		Invalidate(child_container.region);
 		Invalidate(child_region);
+		_child_grid.Erase(child_container, child_container.region);
+		_child_grid.Insert(child_container, child_region);
 		child_container.region = child_region;
 		SetChildRegion(child_container.wnd, child_region);
 	}
@@ -57,24 +67,37 @@ void OverlapLayout::OnChildRegionUpdate(WndObject& child) {
 
 const Rect OverlapLayout::UpdateContentLayout(Size client_size) {
 	if (client_size != GetClientSize()) {
-		for (auto& child_container : _child_wnds) {
+		for (auto& [order, child_container] : _child_wnds) {
 			UpdateChildRegion(child_container, client_size);
 		}
 	}
 	return Rect(point_zero, client_size);
 }
 
+bool OverlapLayout::QueryClientChildren(Rect client_region, vector<ref_ptr<WndObject>>& children) const {
+	_child_grid.Query(client_region, _query_result);
+	for (auto child_container : _query_result) { children.push_back(&child_container->wnd); }
+	return true;
+}
+
 void OverlapLayout::OnClientPaint(FigureQueue& figure_queue, Rect client_region, Rect invalid_client_region) const {
-	for (auto& child_container : reverse(_child_wnds)) {
-		Rect invalid_child_region = child_container.region.Intersect(invalid_client_region);
+	// Composite from back to front.
+	_child_grid.Query(invalid_client_region, _query_result);
+	std::sort(_query_result.begin(), _query_result.end(), [](auto a, auto b) { return a->order < b->order; });
+	for (auto child_container : _query_result) {
+		Rect invalid_child_region = child_container->region.Intersect(invalid_client_region);
 		if (!invalid_child_region.IsEmpty()) {
-			CompositeChild(child_container.wnd, figure_queue, invalid_child_region);
+			CompositeChild(child_container->wnd, figure_queue, invalid_child_region);
 		}
 	}
 }
 
 const Wnd::HitTestInfo OverlapLayout::ClientHitTest(Size client_size, Point point) const { 
-	for (auto& container : _child_wnds) {
+	// Hit test from front to back.
+	_child_grid.Query(point, _query_result);
+	std::sort(_query_result.begin(), _query_result.end(), [](auto a, auto b) { return a->order > b->order; });
+	for (auto child_container : _query_result) {
+		const ChildWndContainer& container = *child_container;
 		if (!container.composite._mouse_penetrate && container.region.Contains(point)){
 			Point point_on_child = point - (container.region.point - point_zero);
 			if (container.wnd.NonClientHitTest(container.region.size, point_on_child)) {
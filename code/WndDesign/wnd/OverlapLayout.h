@@ -1,21 +1,20 @@
 #pragma once
 
 #include "Wnd.h"
+#include "../common/spatial_grid.h"
 
-#include <list>
+#include <map>
 
 
 BEGIN_NAMESPACE(WndDesign)
 
-using std::list;
-
 
 class OverlapLayout : public Wnd {
 public:
 	using Style = Wnd::Style;
 
 public:
-	OverlapLayout(unique_ptr<Style> style) : Wnd(std::move(style)) {}
+	OverlapLayout(style_ptr<Style> style) : Wnd(std::move(style)) {}
 	~OverlapLayout() {}
 
 
@@ -25,11 +24,20 @@ private:
 		WndObject& wnd;
 		Rect region;
 		CompositeEffect composite;
-		list<ChildWndContainer>::iterator list_index;
+		uint64 order;  // z-index in the high bits and insertion sequence in the low bits, larger is in front
 	};
 
 	// frontmost(begin) ---> endmost(end)
-	list<ChildWndContainer> _child_wnds;  // or use spatial index instead
+	std::map<uint64, ChildWndContainer, std::greater<uint64>> _child_wnds;
+	uint64 _child_sequence = 0;
+
+	// Child regions indexed for hit testing and painting.
+	SpatialGrid<ChildWndContainer> _child_grid;
+	mutable vector<ref_ptr<ChildWndContainer>> _query_result;
+
+	// Bounding region of the children removed by RemoveChildren(), invalidated at the end.
+	bool _is_removing_children = false;
+	Rect _removed_region = region_empty;
 
 private:
 	static void SetChildData(WndObject& child, ChildWndContainer& child_container) {
@@ -45,6 +53,8 @@ private:
 
 public:
 	void AddChild(WndObject& child);
+	void AddChildren(const vector<ref_ptr<WndObject>>& children) { for (auto child : children) { AddChild(*child); } }
+	void RemoveChildren(const vector<ref_ptr<WndObject>>& children);
 
 protected:
 	virtual void OnChildDetach(WndObject& child) override;
@@ -57,6 +67,7 @@ private:
 private:
 	virtual void OnChildRegionUpdate(WndObject& child) override;
 	virtual const Rect UpdateContentLayout(Size client_size) override;
+	virtual bool QueryClientChildren(Rect client_region, vector<ref_ptr<WndObject>>& children) const override;
 
 
 	//// painting and composition ////
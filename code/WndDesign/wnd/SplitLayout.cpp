@@ -47,20 +47,20 @@ void SplitLayout::OnChildRegionUpdate(WndObject& child) {
 
 const Rect SplitLayout::UpdateContentLayout(Size client_size) {
 	if (_is_layout_invalid || client_size != GetClientSize()) {
-		Style::SplitLineStyle& split_line = GetStyle().split_line;
+		const Style::SplitLineStyle& split_line = GetStyle().split_line;
 		if (client_size.width <= split_line._width) {
 			_region_left = _region_right = region_empty;
 			_region_split_line = Rect(point_zero, client_size);
 		} else {
-			uint line_position_center = ValueTag(split_line._position).ConvertToPixel(client_size.width).AsUnsigned();
+			uint line_position_center = ValueTag(_split_line_position).ConvertToPixel(client_size.width).AsUnsigned();
 			uint line_position_left = line_position_center - split_line._width / 2;
 			line_position_left = std::clamp(line_position_center, (uint)0, client_size.width - split_line._width);
 			uint new_line_position_center = line_position_left + split_line._width / 2;
 			if (new_line_position_center != line_position_center) {
-				if (split_line._position.IsPixel()) {
-					split_line._position = px(new_line_position_center);
-				} else if (split_line._position.IsPercent()) {
-					split_line._position = pct(new_line_position_center * 100 / client_size.width);
+				if (_split_line_position.IsPixel()) {
+					_split_line_position = px(new_line_position_center);
+				} else if (_split_line_position.IsPercent()) {
+					_split_line_position = pct(new_line_position_center * 100 / client_size.width);
 				}
 			}
 			uint line_position_right = line_position_left + split_line._width;
@@ -107,7 +107,7 @@ void SplitLayout::Handler(Msg msg, Para para) {
 			SetCapture();
 			_is_mouse_dragging = true;
 			_mouse_down_position = GetMouseMsg(para).point.x;
-			_mouse_down_split_line_position = GetStyle().split_line._position.AsSigned();
+			_mouse_down_split_line_position = _split_line_position.AsSigned();
 		}
 		break;
 	case Msg::LeftUp:
@@ -118,7 +118,7 @@ void SplitLayout::Handler(Msg msg, Para para) {
 		break;
 	case Msg::MouseMove:
 		if (_is_mouse_dragging) {
-			ValueTag& split_line_position = GetStyle().split_line._position;
+			ValueTag& split_line_position = _split_line_position;
 			if (split_line_position.IsPixel()) {
 				split_line_position = px(_mouse_down_split_line_position + GetMouseMsg(para).point.x - _mouse_down_position);
 				_is_layout_invalid = true; ContentLayoutChanged();
@@ -19,17 +19,21 @@ public:
 			constexpr SplitLineStyle& width(uint width) { _width = width; return *this; }
 			constexpr SplitLineStyle& color(Color color) { _color = color; return *this; }
 			constexpr SplitLineStyle& position(ValueTag position) { _position = position; return *this; }
+			bool operator==(const SplitLineStyle& other) const {
+				return _width == other._width && _color == other._color && _position == other._position;
+			}
 		}split_line;
+		bool operator==(const Style& other) const { return Wnd::Style::operator==(other) && split_line == other.split_line; }
 	};
 
 public:
-	SplitLayout(unique_ptr<Style> style) : Wnd(std::move(style)) {}
+	SplitLayout(style_ptr<Style> style) : Wnd(std::move(style)), _split_line_position(GetStyle().split_line._position) {}
 	~SplitLayout() {}
 
 
 	//// style ////
 protected:
-	Style& GetStyle() { return static_cast<Style&>(Wnd::GetStyle()); }
+	Style& ModifyStyle() { return static_cast<Style&>(Wnd::ModifyStyle()); }
 	const Style& GetStyle() const { return static_cast<const Style&>(Wnd::GetStyle()); }
 
 
@@ -52,6 +56,7 @@ private:
 
 	//// layout update ////
 private:
+	ValueTag _split_line_position;  // initialized from the style and moved by dragging, without copying the shared style
 	Rect _region_left;
 	Rect _region_right;
 	Rect _region_split_line;
@@ -11,31 +11,36 @@ class TextBox : public Wnd {
 public:
 	struct Style : Wnd::Style, TextBlockStyle {
 		Style() {
-			scrollbar.set(CreateDefaultScrollbar());
+			scrollbar.set(GetDefaultScrollbar());
 			client.height.min(0px).normal(length_auto).max(length_max_tag);
 			client.width.min(0px).normal(length_auto).max(100pct);
 		}
+		bool operator==(const Style& other) const { return Wnd::Style::operator==(other) && TextBlockStyle::operator==(other); }
+		size_t Hash() const { return Wnd::Style::Hash() * 31 + TextBlockStyle::Hash(); }
 	};
 	
 public:
-	TextBox(unique_ptr<Style> style, const wstring& text) :
-		Wnd(std::move(style)), _text(text), _text_block(_text, GetStyle()) {
+	TextBox(style_ptr<Style> style, wstring text) :
+		Wnd(std::move(style)), _text(std::move(text)), _text_block(_text, GetStyle()), _text_block_size() {
 	}
 	~TextBox() {}
 
 
 	//// style ////
 protected:
-	Style& GetStyle() { return static_cast<Style&>(Wnd::GetStyle()); }
+	Style& ModifyStyle() { return static_cast<Style&>(Wnd::ModifyStyle()); }
 	const Style& GetStyle() const { return static_cast<const Style&>(Wnd::GetStyle()); }
+private:
+	virtual void OnStyleCopy() override { _text_block.SetDefaultStyle(GetStyle()); }
 
 
 	//// text layout ////
 private:
-	wstring _text;
+	TextBuffer _text;
 	TextBlock _text_block;
+	Size _text_block_size;  // the size last laid out, as the size of the text block is invalidated by changes
 public:
-	const wstring& GetText() const { return _text; }
+	const TextBuffer& GetText() const { return _text; }
 	const TextBlock& GetTextBlock() const { return _text_block; }
 private:
 	void TextLayoutChanged() { 
@@ -44,58 +49,95 @@ private:
 	}
 protected:
 	virtual void OnTextChange() { TextLayoutChanged(); }
+private:
+	uint _text_revision = 0;
+	void TextChanged() { _text_revision++; OnTextChange(); }
+public:
+	// Changes whenever the text is modified, as for caching results computed from the text.
+	uint GetTextRevision() const { return _text_revision; }
+public:
+	// In virtual layout only the paragraphs in the cached region are laid out, for showing large texts.
+	void SetVirtualLayout(bool is_virtual) { _text_block.SetVirtual(is_virtual); TextLayoutChanged(); }
+	// In monospace layout single-line paragraphs of plain or color-only text are measured and hit tested with the
+	//   cell metrics of the font, for editing code and logs. It has no effect if the font is not monospace.
+	void SetMonospaceLayout(bool is_monospace) { _text_block.SetMonospace(is_monospace); TextLayoutChanged(); }
 
 
-	// std::wstring wrapper functions
+	// TextBuffer wrapper functions
 public:
-	void SetText(wstring&& text) {
-		uint old_length = (uint)_text.length(), new_length = (uint)text.length();
-		_text.assign(std::move(text));
+	void SetText(wstring text) {
+		uint old_length = _text.GetLength(), new_length = (uint)text.length();
+		_text.Assign(std::move(text));
 		_text_block.TextReplacedWithoutStyle(0, old_length, new_length);
-		OnTextChange();
-	}
-	void SetText(const wstring& text) {
-		uint old_length = (uint)_text.length(), new_length = (uint)text.length();
-		_text.assign(text);
-		_text_block.TextReplacedWithoutStyle(0, old_length, new_length);
-		OnTextChange();
+		TextChanged();
 	}
 	void InsertText(uint pos, wchar ch) {
-		_text.insert(pos, 1, ch);
+		_text.Insert(pos, ch);
 		_text_block.TextInsertedWithoutStyle(pos, 1);
-		OnTextChange();
+		TextChanged();
 	}
 	void InsertText(uint pos, const wstring& str) {
-		_text.insert(pos, str);
+		_text.Insert(pos, str);
 		_text_block.TextInsertedWithoutStyle(pos, (uint)str.length());
-		OnTextChange();
+		TextChanged();
 	}
 	void ReplaceText(uint begin, uint length, wchar ch) {
-		_text.replace(begin, length, 1, ch);
+		_text.Replace(begin, length, ch);
 		_text_block.TextReplacedWithoutStyle(begin, length, 1);  // length may be out of range, but it doesn't matter
-		OnTextChange();
+		TextChanged();
 	}
 	void ReplaceText(uint begin, uint length, const wstring& str) {
-		_text.replace(begin, length, str);
+		_text.Replace(begin, length, str);
 		_text_block.TextReplacedWithoutStyle(begin, length, (uint)str.length());
-		OnTextChange();
+		TextChanged();
 	}
 	void DeleteText(uint begin, uint length) {
-		_text.erase(begin, length);
+		_text.Erase(begin, length);
 		_text_block.TextDeleted(begin, length);
-		OnTextChange();
+		TextChanged();
+	}
+
+
+	// text style
+public:
+	// Replace the styles of a text range with the runs sorted by position, as for syntax highlighting.
+	void SetTextStyles(uint begin, uint length, const vector<TextStyleRun>& runs) {
+		_text_block.SetStyles(begin, length, runs);
+		TextLayoutChanged();
 	}
 
 
 protected:
-	virtual const Rect UpdateContentLayout(Size client_size) {
-		Size old_size = _text_block.GetSize();
+	virtual void PrepareLayout() override { _text_block.PrepareLayout(); }
+	// Returns true if the text block is resized or its paragraphs are moved. In virtual layout, the paragraph at the 
+	//   top of display region is kept still when the estimated heights of the paragraphs above it are refined.
+	bool UpdateTextBlockLayout(Size client_size) {
+		uint anchor = 0; int anchor_y = 0; bool is_anchor_moved = false;
+		if (_text_block.IsVirtual()) {
+			anchor = _text_block.HitTestParagraph((GetDisplayRegion() - GetClientOffset()).top());
+			anchor_y = _text_block.GetParagraphY(anchor);
+		}
 		_text_block.AutoResize(client_size);
-		if (_text_block.GetSize() != old_size) { Invalidate(region_infinite); }
+		if (_text_block.IsVirtual()) {
+			int y = _text_block.GetParagraphY(anchor);
+			if (y != anchor_y) { ScrollAfterContentLayout(Vector(0, y - anchor_y)); is_anchor_moved = true; }
+		}
+		Size old_size = _text_block_size; _text_block_size = _text_block.GetSize();
+		return _text_block_size != old_size || is_anchor_moved;
+	}
+	virtual const Rect UpdateContentLayout(Size client_size) {
+		if (UpdateTextBlockLayout(client_size)) { Invalidate(region_infinite); }
 		return Rect(point_zero, _text_block.GetSize());
 	}
+	virtual void OnCachedRegionChange(Rect accessible_region, Rect cached_region) override {
+		if (!_text_block.SetLayoutRegion(cached_region - GetClientOffset())) { TextLayoutChanged(); }
+	}
 	virtual void OnClientPaint(FigureQueue& figure_queue, Rect client_region, Rect invalid_client_region) const override {
-		figure_queue.Append(point_zero, new TextBlockFigure(_text_block));
+		// Only the lines in the invalid region are drawn, each paragraph as a figure bounded by its lines.
+		Color color = GetStyle().font._color;
+		_text_block.ForEachLayout(invalid_client_region, [&](TextLayout& layout, Point point, Rect line_region) {
+			figure_queue.Append(point, new TextLayoutFigure(layout, line_region, color));
+		});
 	}
 };
 
@@ -6,44 +6,52 @@
 BEGIN_NAMESPACE(WndDesign)
 
 
-Wnd::Wnd(unique_ptr<Style> style) :
+Wnd::Wnd(style_ptr<Style> style) :
 	_style(std::move(style)),
+	_border_resizer(_style.IsNull() ? nullptr : GetStyle().border._resizer->Clone()),
+	_scrollbar(_style.IsNull() ? nullptr : GetStyle().scrollbar._resource->Clone()),
 	_margin_without_padding(),
 	_margin(),
 	_client_region(),
 	_client_to_display_offset(),
 	_invalid_layout({ true, true, true, true }),
+	_layout_revision(0),
+	_measure_cache({ (uint)-1, size_empty, region_empty }),
+	_scroll_offset_after_layout(vector_zero),
 	_mouse_capture_info({ ElementType::None }),
 	_mouse_track_info({ ElementType::None, nullptr }) {
-	if (_style == nullptr) { throw std::invalid_argument("style can't be null"); }
+	if (_style.IsNull()) { throw std::invalid_argument("style can't be null"); }
 }
 
 Wnd::~Wnd() {}
 
+RegionStyle& Wnd::ModifyRegionStyle() {
+	if (_region_style == nullptr) { _region_style = std::make_unique<RegionStyle>(GetStyle()); }
+	return *_region_style;
+}
+
+const StyleCalculator Wnd::GetEffectiveStyle() const {
+	return StyleCalculator(GetStyle(), _region_style.get());
+}
+
 const pair<Size, Size> Wnd::CalculateMinMaxSize(Size parent_size) {
-	const StyleCalculator& style = GetStyleCalculator(GetStyle());
+	const StyleCalculator style = GetEffectiveStyle();
 	auto pair = style.CalculateMinMaxDisplaySize(parent_size);
 	std::tie(_size_min, _size_max) = pair;
 	return pair;
 }
 
 void Wnd::SetRegionStyle(Rect parent_specified_region, Size parent_size) {
-	StyleCalculator& style = const_cast<StyleCalculator&>(GetStyleCalculator(GetStyle()));
-	style.ResetRegionOnParent(parent_specified_region, parent_size);
-	if (parent_specified_region == Rect(point_zero, parent_size)) {
-		style.border._saved_width = style.border._width;
-		style.border._width = 0; MarginChanged();
-	} else {
-		if (style.border._saved_width != -1) {
-			style.border._width = style.border._saved_width; MarginChanged();
-			style.border._saved_width = (uint)-1;
-		}
-	}
+	RegionStyle& region_style = ModifyRegionStyle();
+	region_style.ResetRegionOnParent(parent_specified_region, parent_size);
+	// Border is hidden when the window fills its parent.
+	uint border_width = parent_specified_region == Rect(point_zero, parent_size) ? 0 : GetStyle().border._width;
+	if (region_style.border_width != border_width) { region_style.border_width = border_width; MarginChanged(); }
 	RegionOnParentChanged();
 }
 
 void Wnd::ResetRegionOnParent(Rect old_window_region, Margin margin_to_extend) {
-	const_cast<StyleCalculator&>(GetStyleCalculator(GetStyle())).ResetRegionOnParent(old_window_region, margin_to_extend, _size_min, _size_max);
+	ModifyRegionStyle().ResetRegionOnParent(old_window_region, margin_to_extend, _size_min, _size_max);
 	RegionOnParentChanged();
 }
 
@@ -64,15 +72,15 @@ void Wnd::ScrollIntoView(Rect region_on_client) {
 }
 
 bool Wnd::MayRegionOnParentChange() {
-	const StyleCalculator& style = GetStyleCalculator(GetStyle());
+	const StyleCalculator style = GetEffectiveStyle();
 	if (_invalid_layout.content_layout && style.IsClientRegionAuto()) { _invalid_layout.client_region = true; }
-	if (_invalid_layout.client_region && style.IsMarginAuto()) { _invalid_layout.margin = true; }
+	if (_invalid_layout.client_region && GetScrollbar().IsMarginAuto()) { _invalid_layout.margin = true; }
 	if ((_invalid_layout.client_region || _invalid_layout.margin) && style.IsRegionOnParentAuto()) { _invalid_layout.region_on_parent = true; }
 	return _invalid_layout.region_on_parent ? true : false;
 }
 
 void Wnd::UpdateLayout() {
-	const StyleCalculator& style = GetStyleCalculator(GetStyle());
+	const StyleCalculator style = GetEffectiveStyle();
 	if (_invalid_layout.region_on_parent) {
 		WndObject::UpdateRegionOnParent();
 	}
@@ -86,19 +94,23 @@ void Wnd::UpdateLayout() {
 		}
 	}
 	if (_invalid_layout.client_region) {
-		assert(!style.IsMarginAuto() && !style.IsRegionOnParentAuto());
+		assert(!GetScrollbar().IsMarginAuto() && !style.IsRegionOnParentAuto());
 		UpdateClientRegion(ShrinkSizeByMargin(GetDisplaySize(), _margin));
 	}
 	if (_invalid_layout.content_layout) {
 		assert(!style.IsClientRegionAuto());
 		UpdateContentLayout(GetClientSize());
 		_invalid_layout.content_layout = false;
+		ApplyScrollAfterContentLayout();
 	}
 }
 
 const Rect Wnd::UpdateRegionOnParent(Size parent_size) {
+	Size parent_size_dependency = GetParentSizeDependency(parent_size);
+	if (_measure_cache.IsValid(_layout_revision, parent_size_dependency)) { return _measure_cache.region_on_parent; }
+	uint layout_revision = _layout_revision;  // layout may be invalidated again when updating
 	CalculateMinMaxSize(parent_size); // update min max size.
-	const StyleCalculator& style = GetStyleCalculator(GetStyle());
+	const StyleCalculator style = GetEffectiveStyle();
 	Rect region_on_parent = style.CalculateRegionOnParent(parent_size);
 	bool is_region_on_parent_auto = style.IsRegionOnParentAuto();
 	if (_invalid_layout.margin || is_region_on_parent_auto || region_on_parent.size != GetDisplaySize()) {
@@ -117,14 +129,19 @@ const Rect Wnd::UpdateRegionOnParent(Size parent_size) {
 		region_on_parent = assumed_region_on_parent;
 	}
 	_invalid_layout.region_on_parent = false;
+	_measure_cache = { layout_revision, parent_size_dependency, region_on_parent };
 	return region_on_parent;
 }
 
+const Size Wnd::GetParentSizeDependency(Size parent_size) const {
+	return GetEffectiveStyle().GetParentSizeDependency(parent_size);
+}
+
 void Wnd::UpdateScrollbar(Rect accessible_region, Rect display_region) {
 	Rect client_region_with_padding = ShrinkRegionByMargin(accessible_region, _margin_without_padding);
 	Rect displayed_client_region_with_padding = ShrinkRegionByMargin(display_region, _margin_without_padding);
 	GetScrollbar().Update(
-		*this, GetStyleCalculator(GetStyle()).GetDisplayRegionWithoutBorder(display_region.size),
+		*this, GetEffectiveStyle().GetDisplayRegionWithoutBorder(display_region.size),
 		client_region_with_padding.size,
 		displayed_client_region_with_padding - (client_region_with_padding.point - point_zero)
 	);
@@ -132,8 +149,8 @@ void Wnd::UpdateScrollbar(Rect accessible_region, Rect display_region) {
 }
 
 const Size Wnd::UpdateMarginAndClientRegion(Size display_size) {
-	const StyleCalculator& style = GetStyleCalculator(GetStyle());
-	_margin_without_padding = style.CalculateBorderMargin() + style.GetScrollbarMargin();
+	const StyleCalculator style = GetEffectiveStyle();
+	_margin_without_padding = style.CalculateBorderMargin() + GetScrollbar().GetMargin();
 	_margin = style.CalculatePaddingMargin(display_size) + _margin_without_padding;
 	_invalid_layout.margin = false;
 	UpdateClientRegion(ShrinkSizeByMargin(display_size, _margin));
@@ -142,7 +159,7 @@ const Size Wnd::UpdateMarginAndClientRegion(Size display_size) {
 }
 
 void Wnd::UpdateClientRegion(Size displayed_client_size) {
-	const StyleCalculator& style = GetStyleCalculator(GetStyle());
+	const StyleCalculator style = GetEffectiveStyle();
 	Rect client_region = style.CalculateClientRegion(displayed_client_size);
 	bool is_client_auto = style.IsClientRegionAuto();
 	if (_invalid_layout.content_layout == true || is_client_auto || client_region.size != GetClientRegion().size) {
@@ -155,9 +172,17 @@ void Wnd::UpdateClientRegion(Size displayed_client_size) {
 	_client_region = client_region; 
 	// offset client region so that accessible region's origin will be at (0,0)
 	SetAccessibleRegion(ExtendRegionByMargin(_client_region + GetClientOffset(), _margin));
+	ApplyScrollAfterContentLayout();
 	_invalid_layout.client_region = false;
 }
 
+void Wnd::ApplyScrollAfterContentLayout() {
+	if (_scroll_offset_after_layout != vector_zero) {
+		SetDisplayOffset(GetDisplayOffset() + _scroll_offset_after_layout);
+		_scroll_offset_after_layout = vector_zero;
+	}
+}
+
 void Wnd::OnDisplayRegionChange(Rect accessible_region, Rect display_region) {
 	UpdateScrollbar(accessible_region, display_region);
 }
@@ -173,10 +198,10 @@ void Wnd::OnPaint(FigureQueue& figure_queue, Rect accessible_region, Rect invali
 
 void Wnd::OnComposite(FigureQueue& figure_queue, Size display_size, Rect invalid_display_region) const {
 	// Draw border and scroll bar.
-	const StyleCalculator& style = GetStyleCalculator(GetStyle());
-	if (style.HasScrollbar()) {
+	const StyleCalculator style = GetEffectiveStyle();
+	if (GetScrollbar().IsVisible()) {
 		Vector offset = figure_queue.PushOffset(GetScrollbar().GetRegion().point - point_zero);
-		style.scrollbar._resource->OnPaint(figure_queue);
+		GetScrollbar().OnPaint(figure_queue);
 		figure_queue.PopOffset(offset);
 	}
 	if (style.HasBorder()) {
@@ -219,7 +244,7 @@ void Wnd::MouseTrackInfo::Update(Wnd& wnd, WndObject& child) {
 }
 
 bool Wnd::NonClientHitTest(Size display_size, Point point) const {
-	const StyleCalculator& style = GetStyleCalculator(GetStyle());
+	const StyleCalculator style = GetEffectiveStyle();
 	return style.IsPointInside(display_size, point);
 }
 
@@ -235,7 +260,7 @@ void Wnd::NonClientHandler(Msg msg, Para para) {
 				_mouse_track_info.Update(*this, _mouse_capture_info._type); break;
 			}
 			// Hit test border.
-			if (GetStyleCalculator(GetStyle()).HitTestBorder(display_size, mouse_msg.point)) {
+			if (GetEffectiveStyle().HitTestBorder(display_size, mouse_msg.point)) {
 				_mouse_track_info.Update(*this, ElementType::Border); break;
 			}
 			// Hit test scrollbar.
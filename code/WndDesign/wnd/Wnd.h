@@ -1,28 +1,40 @@
 #pragma once
 
 #include "WndObject.h"
-#include "../style/wnd_style.h"
+#include "../style/style_ptr.h"
 #include "../geometry/margin.h"
 
 
 BEGIN_NAMESPACE(WndDesign)
 
+struct RegionStyle;
+struct StyleCalculator;
+
 
 class Wnd : public WndObject {
 public:
 	using Style = WndStyle;
 
 public:
-	Wnd(unique_ptr<Style> style);
+	Wnd(style_ptr<Style> style);
 	~Wnd();
 
 
 	//// window style ////
 private:
-	unique_ptr<Style> _style;
+	style_ptr<Style> _style;
 protected:
-	Style& GetStyle() { return *_style; }
-	const Style& GetStyle() const { return *_style; }
+	const Style& GetStyle() const { return _style.Get(); }
+	// The style may be shared with other windows, and is copied before modified.
+	Style& ModifyStyle() { if (_style.CopyIfShared()) { OnStyleCopy(); } return _style.GetMutable(); }
+private:
+	/* called after the window has copied the shared style */
+	virtual void OnStyleCopy() {}
+private:
+	// Region styles set by parent window or border resizer, which override the shared style without copying it.
+	unique_ptr<RegionStyle> _region_style;
+	RegionStyle& ModifyRegionStyle();
+	const StyleCalculator GetEffectiveStyle() const;
 private:
 	Size _size_min, _size_max;
 protected:
@@ -34,9 +46,13 @@ private:
 private:
 	/* called by border resizer */
 	void ResetRegionOnParent(Rect old_window_region, Margin margin_to_extend);
+private:
+	// Border resizer and scrollbar keep the state of the window, and are created from the style for each window.
+	unique_ptr<BorderResizer> _border_resizer;
+	unique_ptr<Scrollbar> _scrollbar;
 protected:
-	BorderResizer& GetBorderResizer() const { return *GetStyle().border._resizer; }
-	Scrollbar& GetScrollbar() const { return *GetStyle().scrollbar._resource; }
+	BorderResizer& GetBorderResizer() const { return *_border_resizer; }
+	Scrollbar& GetScrollbar() const { return *_scrollbar; }
 
 
 	//// non-client and client region ////
@@ -67,12 +83,26 @@ private:
 		bool content_layout;
 	};
 	InvalidLayout _invalid_layout;
+	uint _layout_revision;  // increased whenever the layout is invalidated
 	WndObject::InvalidateLayout;
 protected:
-	void RegionOnParentChanged() { _invalid_layout.region_on_parent = true; InvalidateLayout(); }
-	void MarginChanged() { _invalid_layout.margin = true; InvalidateLayout(); }
-	void ClientRegionChanged() { _invalid_layout.client_region = true; InvalidateLayout(); }
-	void ContentLayoutChanged() { _invalid_layout.content_layout = true; InvalidateLayout(); }
+	void RegionOnParentChanged() { _invalid_layout.region_on_parent = true; _layout_revision++; InvalidateLayout(); }
+	void MarginChanged() { _invalid_layout.margin = true; _layout_revision++; InvalidateLayout(); }
+	void ClientRegionChanged() { _invalid_layout.client_region = true; _layout_revision++; InvalidateLayout(); }
+	void ContentLayoutChanged() { _invalid_layout.content_layout = true; _layout_revision++; InvalidateLayout(); }
+
+private:
+	// The region on parent calculated last time, reused if the parts of parent size the style depends on are the same
+	//   and layout is not invalidated since.
+	struct MeasureCache {
+		uint layout_revision;
+		Size parent_size_dependency;
+		Rect region_on_parent;
+		bool IsValid(uint layout_revision, Size parent_size_dependency) const { 
+			return this->layout_revision == layout_revision && this->parent_size_dependency == parent_size_dependency; 
+		}
+	};
+	MeasureCache _measure_cache;
 
 private:
 	virtual void OnAttachToParent() override { RegionOnParentChanged(); }
@@ -83,12 +113,21 @@ private:
 	virtual void UpdateLayout() override;
 	/* called by parent window when parent is updating */
 	virtual const Rect UpdateRegionOnParent(Size parent_size) override;
+	virtual const Size GetParentSizeDependency(Size parent_size) const override;
 
 	void UpdateScrollbar(Rect accessible_region, Rect display_region);
 	const Size UpdateMarginAndClientRegion(Size display_size);
 	void UpdateClientRegion(Size displayed_client_size);
 	virtual const Rect UpdateContentLayout(Size client_size) { return Rect(point_zero, client_size); }
 
+private:
+	Vector _scroll_offset_after_layout;
+	void ApplyScrollAfterContentLayout();
+protected:
+	/* called in UpdateContentLayout() to scroll the display region after accessible region is updated */
+	// Used to keep the content in the display region still when the content above it is resized.
+	void ScrollAfterContentLayout(Vector offset) { _scroll_offset_after_layout += offset; }
+
 	virtual void OnDisplayRegionChange(Rect accessible_region, Rect display_region);
 
 
@@ -100,6 +139,13 @@ protected:
 	const Rect GetChildRegion(WndObject& child) {
 		return WndObject::GetChildRegion(child) - GetClientOffset();
 	}
+private:
+	virtual bool QueryChildren(Rect region, vector<ref_ptr<WndObject>>& children) const override final {
+		return QueryClientChildren(region - GetClientOffset(), children);
+	}
+protected:
+	// Appends the child windows that may intersect the client region, or returns false if children are not indexed.
+	virtual bool QueryClientChildren(Rect client_region, vector<ref_ptr<WndObject>>& children) const { return false; }
 
 
 	//// painting and composition ////
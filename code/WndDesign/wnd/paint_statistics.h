@@ -0,0 +1,3 @@
+#pragma once
+
+#include "../../WndDesignCore/wnd/paint_statistics.h"
\ No newline at end of file
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "core.h"
+#include "uncopyable.h"
+
+
+BEGIN_NAMESPACE(WndDesign)
+
+
+// A link embedded in the item itself, so joining or leaving a list never allocates.
+// The node doesn't point back to its item, the list recovers the item from the node's offset in it.
+template<class T>
+struct intrusive_list_node : Uncopyable {
+	intrusive_list_node* prev = nullptr;
+	intrusive_list_node* next = nullptr;
+
+	bool valid() const { return next != nullptr; }
+};
+
+
+// A circular doubly-linked list of intrusive_list_node with a sentinel head.
+template<class T>
+class intrusive_list : Uncopyable {
+private:
+	using node = intrusive_list_node<T>;
+	node _head;
+	ptrdiff_t _node_offset = 0;  // the same for all items of a list
+
+public:
+	intrusive_list() { _head.prev = _head.next = &_head; }
+	~intrusive_list() { while (!empty()) { erase(*_head.next); } }
+
+	bool empty() const { return _head.next == &_head; }
+	T& front() const { assert(!empty()); return GetItem(*_head.next, _node_offset); }
+
+	void push_front(node& item_node, T& item) {
+		assert(!item_node.valid());
+		ptrdiff_t node_offset = reinterpret_cast<char*>(&item_node) - reinterpret_cast<char*>(&item);
+		assert(empty() || node_offset == _node_offset);
+		_node_offset = node_offset;
+		item_node.prev = &_head; item_node.next = _head.next;
+		_head.next->prev = &item_node; _head.next = &item_node;
+	}
+	static void erase(node& item_node) {
+		assert(item_node.valid());
+		item_node.prev->next = item_node.next; item_node.next->prev = item_node.prev;
+		item_node.prev = item_node.next = nullptr;
+	}
+
+private:
+	static T& GetItem(const node& item_node, ptrdiff_t node_offset) {
+		return *reinterpret_cast<T*>(const_cast<char*>(reinterpret_cast<const char*>(&item_node)) - node_offset);
+	}
+
+public:
+	class iterator {
+	private:
+		ref_ptr<const node> _node;
+		ptrdiff_t _node_offset;
+	public:
+		iterator(const node& item_node, ptrdiff_t node_offset) : _node(&item_node), _node_offset(node_offset) {}
+		T& operator*() const { return GetItem(*_node, _node_offset); }
+		iterator& operator++() { _node = _node->next; return *this; }
+		bool operator!=(const iterator& it) const { return _node != it._node; }
+	};
+	// An item may be erased during iteration except for the current one.
+	iterator begin() const { return iterator(*_head.next, _node_offset); }
+	iterator end() const { return iterator(_head, _node_offset); }
+};
+
+
+END_NAMESPACE(WndDesign)
\ No newline at end of file
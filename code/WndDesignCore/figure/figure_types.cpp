@@ -1,6 +1,7 @@
 #include "../layer/layer.h"
 #include "../geometry/rect_point_iterator.h"
 #include "../geometry/geometry_helper.h"
+#include "../wnd/paint_statistics.h"
 
 #include "../system/directx/directx_helper.h"
 #include "../system/directx/d2d_api.h"
@@ -55,21 +56,26 @@ inline bool IsCompositeEffectNontrivial(CompositeEffect composite_effect) {
     return composite_effect._opacity != 0xFF;
 }
 
-void Target::DrawFigureQueue(const FigureQueue& figure_queue, Vector offset, Rect clip_region) {
+uint64 Target::DrawFigureQueue(const FigureQueue& figure_queue, Vector offset, Rect clip_region, 
+							   ref_ptr<OverdrawMap> overdraw_map, Vector overdraw_offset, Rect overdraw_clip_region) {
     if (!figure_queue.CheckGroupOffsetStack()) { throw std::invalid_argument("figure queue groups mismatch"); }
     ID2D1DeviceContext& device_context = GetD2DDeviceContext(); device_context.SetTarget(&GetBitmap());
     auto& groups = figure_queue.GetFigureGroups();
     auto& figures = figure_queue.GetFigures();
     uint figure_index = 0;
+    uint64 pixel_count = 0;
     clip_region = clip_region.Intersect(Rect(point_zero, SIZE2Size(bitmap->GetSize())));
     for (uint group_index = 0; group_index < groups.size(); ++group_index) {
         auto& group = groups[group_index];
         for (; figure_index < group.figure_index; ++figure_index) {
             Vector figure_offset = figures[figure_index].offset + offset;
         #pragma message(Remark"The region of the figure could be cached in the figure queue when it is appended.")
-            Rect figure_region = figures[figure_index].figure->GetRegion() + figure_offset;
-            if (figure_region.Intersect(clip_region).IsEmpty()) { continue; }
+            Rect drawn_region = (figures[figure_index].figure->GetRegion() + figure_offset).Intersect(clip_region);
+            if (drawn_region.IsEmpty()) { continue; }
             figures[figure_index].figure->DrawOn(static_cast<RenderTarget&>(device_context), figure_offset);
+            pixel_count += drawn_region.Area();
+            if (auto statistics = figures[figure_index].statistics; statistics != nullptr) { statistics->pixel_count += drawn_region.Area(); }
+            if (overdraw_map != nullptr) { overdraw_map->Accumulate((drawn_region + overdraw_offset).Intersect(overdraw_clip_region)); }
         }
         if (group.IsBegin()) {
             auto& group_end = groups[group.group_end_index];
@@ -109,6 +115,7 @@ void Target::DrawFigureQueue(const FigureQueue& figure_queue, Vector offset, Rec
             }
         }
     }
+    return pixel_count;
 }
 
 
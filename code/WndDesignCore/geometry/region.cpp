@@ -19,40 +19,61 @@ Region& Region::Temp(Rect rect) {
     return region;
 }
 
-Region::Region(Rect region) {
-    rgn = CreateRectRgn(region.left(), region.top(), region.right(), region.bottom());
+Region::Region(Rect region) : rgn(nullptr) {
+    Set(region);
 }
 
 Region::~Region() {
-    DeleteObject(rgn);
+    Release();
+}
+
+void Region::Create() {
+    if (rgn == nullptr) { rgn = CreateRectRgn(0, 0, 0, 0); }
+}
+
+void Region::Release() {
+    if (rgn != nullptr) { DeleteObject(rgn); rgn = nullptr; }
 }
 
 bool Region::IsEmpty() const {
+    if (rgn == nullptr) { return true; }
     // return OffsetRgn(static_cast<HRGN>(rgn), 0, 0) == NULLREGION;
     return CombineRgn(static_cast<HRGN>(rgn), static_cast<HRGN>(rgn), NULL, RGN_COPY) == NULLREGION;
 }
 
 void Region::Set(Rect region) {
+    if (rgn == nullptr) {
+        if (region.IsEmpty()) { return; }
+        Create();
+    }
     SetRectRgn(static_cast<HRGN>(rgn), region.left(), region.top(), region.right(), region.bottom());
 }
 
 void Region::Translate(Vector vector) {
+    if (rgn == nullptr) { return; }
     OffsetRgn(static_cast<HRGN>(rgn), vector.x, vector.y);
 }
 
 void Region::Union(const Region& region) {
+    if (region.rgn == nullptr) { return; }
+    Create();
     CombineRgn(static_cast<HRGN>(rgn), static_cast<HRGN>(rgn), static_cast<HRGN>(region.rgn), RGN_OR);
 }
 
 void Region::Intersect(const Region& region) {
+    if (rgn == nullptr) { return; }
+    if (region.rgn == nullptr) { Release(); return; }
     CombineRgn(static_cast<HRGN>(rgn), static_cast<HRGN>(rgn), static_cast<HRGN>(region.rgn), RGN_AND);
 }
 
 void Region::Sub(const Region& region) {
+    if (rgn == nullptr || region.rgn == nullptr) { return; }
     CombineRgn(static_cast<HRGN>(rgn), static_cast<HRGN>(rgn), static_cast<HRGN>(region.rgn), RGN_DIFF);
 }
 
 void Region::Xor(const Region& region) {
+    if (region.rgn == nullptr) { return; }
+    Create();
     CombineRgn(static_cast<HRGN>(rgn), static_cast<HRGN>(rgn), static_cast<HRGN>(region.rgn), RGN_XOR);
 }
 
@@ -62,6 +83,7 @@ void Region::Sub(const Rect& region) { Sub(TempRegion(region)); }
 void Region::Xor(const Rect& region) { Xor(TempRegion(region)); }
 
 std::pair<Rect, vector<Rect>> Region::GetRect() const {
+    if (rgn == nullptr) { return { Rect(0, 0, 0, 0), {} }; }
     int size = GetRegionData(static_cast<HRGN>(rgn), 0, NULL);
     char* buffer = new char[size];
     GetRegionData(static_cast<HRGN>(rgn), size, (LPRGNDATA)buffer);
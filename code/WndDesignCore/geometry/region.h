@@ -12,10 +12,15 @@ using std::vector;
 
 
 // Using Win32 GDI APIs to calculate union regions.
+// The GDI region is created only when the region becomes non-empty, and released when cleared, 
+//   so that the many windows without invalid region hold no GDI object.
 class Region : Uncopyable {
 private:
 	using HANDLE = void*;
-	HANDLE rgn;
+	HANDLE rgn;  // nullptr for empty region
+private:
+	void Create();
+	void Release();
 
 public:
 	static Region& Temp(Rect rect);
@@ -26,7 +31,7 @@ public:
 
 	bool IsEmpty() const;
 	void Set(Rect region);
-	void Clear() { Set(Rect(0, 0, 0, 0)); }
+	void Clear() { Release(); }
 
 	void Translate(Vector vector);
 
@@ -13,6 +13,8 @@ BEGIN_NAMESPACE(WndDesign)
 using std::unique_ptr;
 using std::vector;
 
+struct PaintStatistics;
+
 
 class FigureQueue : public Uncopyable {
 private:
@@ -22,6 +24,7 @@ private:
 	void Clear() {
 		figures.clear();
 		offset = vector_zero;
+		statistics = nullptr;
 		assert(CheckGroupOffsetStack());
 		groups.clear();
 	}
@@ -31,6 +34,7 @@ public:
 	struct FigureContainer {
 		Vector offset;
 		unique_ptr<const Figure> figure;
+		ref_ptr<PaintStatistics> statistics;  // of the window that emitted the figure
 	};
 private:
 	vector<FigureContainer> figures;
@@ -38,13 +42,20 @@ public:
 	const vector<FigureContainer>& GetFigures() const { return figures; }
 
 	void Append(Point offset, unique_ptr<const Figure> figure) {
-		figures.emplace_back(FigureContainer{ offset - point_zero + this->offset, std::move(figure) });
+		figures.emplace_back(FigureContainer{ offset - point_zero + this->offset, std::move(figure), statistics });
 	}
 	void Append(Point offset, alloc_ptr<const Figure> figure) {
 		Append(offset, unique_ptr<const Figure>(figure));
 	}
 
 
+private:
+	ref_ptr<PaintStatistics> statistics = nullptr;
+public:
+	// Figures appended later are attributed to statistics when drawn, returns the previous one to be restored.
+	ref_ptr<PaintStatistics> SetPaintStatistics(ref_ptr<PaintStatistics> statistics) { std::swap(this->statistics, statistics); return statistics; }
+
+
 private:
 	Vector offset = vector_zero;
 	vector<Vector> group_offset_stack;
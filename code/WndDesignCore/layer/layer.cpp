@@ -85,14 +85,18 @@ Target& Layer::WriteTile(TileID tile_id) {
     return it->second;
 }
 
-void Layer::DrawFigureQueue(const FigureQueue& figure_queue, Rect bounding_region) {
+uint Layer::DrawFigureQueue(const FigureQueue& figure_queue, Rect bounding_region, 
+							ref_ptr<OverdrawMap> overdraw_map, Vector offset_to_frame, Rect visible_region) {
+	uint tile_count = 0;
 	RectPointIterator it(RegionToOverlappingTileRange(bounding_region, GetTileSize()));
-	for (; !it.Finished(); ++it) {
+	for (; !it.Finished(); ++it, ++tile_count) {
 		TileID tile_id = it.Item();
 		Vector offset_to_tile = point_zero - ScalePointBySize(tile_id, GetTileSize());
 		Target& target = WriteTile(tile_id);
-		target.DrawFigureQueue(figure_queue, offset_to_tile, bounding_region + offset_to_tile);
+		target.DrawFigureQueue(figure_queue, offset_to_tile, bounding_region + offset_to_tile, 
+							   overdraw_map, offset_to_frame - offset_to_tile, visible_region);
 	}
+	return tile_count;
 }
 
 
@@ -14,6 +14,7 @@ using std::unordered_map;
 using std::unique_ptr;
 
 class Target;
+class OverdrawMap;
 
 using TileID = Point;
 using TileRange = Rect;
@@ -64,7 +65,10 @@ public:
 	////                      Drawing                      ////
 	///////////////////////////////////////////////////////////
 public:
-	void DrawFigureQueue(const FigureQueue& figure_queue, Rect bounding_region);
+	// Returns the number of tiles written.
+	// If overdraw_map is not null, the drawn regions are accumulated to it at offset_to_frame, clipped by visible_region on the frame.
+	uint DrawFigureQueue(const FigureQueue& figure_queue, Rect bounding_region, 
+						 ref_ptr<OverdrawMap> overdraw_map, Vector offset_to_frame, Rect visible_region);
 };
 
 
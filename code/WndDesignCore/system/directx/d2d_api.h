@@ -12,6 +12,7 @@ struct ID2D1Bitmap1;
 BEGIN_NAMESPACE(WndDesign)
 
 class FigureQueue;
+class OverdrawMap;
 
 
 inline ID2D1Factory1& GetD2DFactory() { return *DirectXResources::Get().d2d_factory; }
@@ -36,7 +37,13 @@ public:
 	bool HasBitmap() const { return bitmap != nullptr; }  // Only read-only target doesn't have bitmap.
 	ID2D1Bitmap1& GetBitmap() const { assert(HasBitmap()); return *bitmap; }
 
-	void DrawFigureQueue(const FigureQueue& figure_queue, Vector offset, Rect clip_region); // defined in figure_types.cpp
+	// If overdraw_map is not null, the drawn region of each figure offset by overdraw_offset and clipped by
+	//   overdraw_clip_region will be accumulated to it.
+	// The pixels covered by each figure are added to the statistics of the window that emitted it.
+	// Returns the number of pixels covered by the figures drawn, overlapping figures are counted repeatedly.
+	uint64 DrawFigureQueue(const FigureQueue& figure_queue, Vector offset, Rect clip_region, 
+						 ref_ptr<OverdrawMap> overdraw_map = nullptr, Vector overdraw_offset = vector_zero, 
+						 Rect overdraw_clip_region = region_infinite); // defined in figure_types.cpp
 };
 
 
@@ -0,0 +1,75 @@
+#include "worker_pool.h"
+
+
+BEGIN_NAMESPACE(WndDesign)
+
+
+WorkerPool::WorkerPool(uint thread_number) {
+	if (thread_number == 0) { thread_number = max(std::thread::hardware_concurrency(), 2u) - 1; }
+	_threads.reserve(thread_number);
+	for (uint i = 0; i < thread_number; ++i) { _threads.emplace_back(&WorkerPool::WorkerMain, this); }
+}
+
+WorkerPool::~WorkerPool() {
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_exit = true;
+	}
+	_work_available.notify_all();
+	for (auto& thread : _threads) { thread.join(); }
+}
+
+void WorkerPool::RunTasks(std::unique_lock<std::mutex>& lock) {
+	_running_thread_number++;
+	while (_next_task < _task_number) {
+		uint task_index = _next_task++;
+		lock.unlock();
+		try {
+			_task(task_index);
+		} catch (...) {
+			lock.lock();
+			if (_exception == nullptr) { _exception = std::current_exception(); }
+			_next_task = _task_number;  // skip the remaining tasks
+			continue;
+		}
+		lock.lock();
+	}
+	if (--_running_thread_number == 0) { _work_finished.notify_all(); }
+}
+
+void WorkerPool::WorkerMain() {
+	uint generation = 0;
+	std::unique_lock<std::mutex> lock(_mutex);
+	while (true) {
+		_work_available.wait(lock, [&]() { return _exit || _generation != generation; });
+		if (_exit) { return; }
+		generation = _generation;
+		RunTasks(lock);
+	}
+}
+
+void WorkerPool::ParallelFor(uint task_number, std::function<void(uint)> task) {
+	if (task_number == 0) { return; }
+	if (task_number == 1 || _threads.empty()) {
+		for (uint i = 0; i < task_number; ++i) { task(i); }
+		return;
+	}
+
+	std::unique_lock<std::mutex> lock(_mutex);
+	_task = std::move(task);
+	_task_number = task_number;
+	_next_task = 0;
+	_exception = nullptr;
+	_generation++;
+	_work_available.notify_all();
+
+	RunTasks(lock);
+	_work_finished.wait(lock, [&]() { return _running_thread_number == 0; });
+
+	_task = nullptr;
+	_task_number = 0;
+	if (_exception != nullptr) { std::rethrow_exception(std::exchange(_exception, nullptr)); }
+}
+
+
+END_NAMESPACE(WndDesign)
\ No newline at end of file
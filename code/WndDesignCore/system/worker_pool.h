@@ -0,0 +1,51 @@
+#pragma once
+
+#include "../common/uncopyable.h"
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <exception>
+#include <utility>
+
+
+BEGIN_NAMESPACE(WndDesign)
+
+using std::vector;
+
+
+// A fixed number of worker threads that run indexed tasks together with the calling thread.
+class WorkerPool : public Uncopyable {
+public:
+	WorkerPool(uint thread_number = 0);  // 0 for (hardware concurrency - 1)
+	~WorkerPool();
+
+private:
+	vector<std::thread> _threads;
+	std::mutex _mutex;
+	std::condition_variable _work_available;
+	std::condition_variable _work_finished;
+
+	std::function<void(uint)> _task;
+	uint _task_number = 0;
+	uint _next_task = 0;
+	uint _running_thread_number = 0;
+	uint _generation = 0;
+	bool _exit = false;
+	std::exception_ptr _exception;
+
+private:
+	void WorkerMain();
+	void RunTasks(std::unique_lock<std::mutex>& lock);
+
+public:
+	uint GetThreadNumber() const { return (uint)_threads.size() + 1; }
+	// Call task(0), task(1), ..., task(task_number - 1) concurrently, and return when all are done.
+	// The first exception thrown by the tasks is rethrown on the calling thread.
+	void ParallelFor(uint task_number, std::function<void(uint)> task);
+};
+
+
+END_NAMESPACE(WndDesign)
\ No newline at end of file
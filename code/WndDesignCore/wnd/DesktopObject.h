@@ -24,6 +24,8 @@ public:
 public:
 	virtual void CommitReflowQueue() pure;
 	virtual void CommitRedrawQueue() pure;
+	// Prepare the layout of windows in reflow queue concurrently on worker threads when committing.
+	virtual void EnableParallelReflow(bool enable) pure;
 
 public:
 	virtual void MessageLoop() pure;
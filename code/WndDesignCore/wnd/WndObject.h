@@ -6,12 +6,14 @@
 #include "../message/message.h"
 
 #include <string>
+#include <vector>
 
 
 BEGIN_NAMESPACE(WndDesign)
 
 using std::pair;
 using std::wstring;
+using std::vector;
 
 
 class WndObject : Uncopyable {
@@ -86,6 +88,9 @@ protected:
 private:
 	virtual void OnDisplayRegionChange(Rect accessible_region, Rect display_region) {}  // for scrollbar update
 	virtual void OnCachedRegionChange(Rect accessible_region, Rect cached_region) {}  // for lazy-loading
+	// Appends the child windows that may intersect the region on accessible region, used to skip the other children 
+	//   when cached region changes. Returns false if children are not indexed, and all of them will be visited.
+	virtual bool QueryChildren(Rect region, vector<ref_ptr<WndObject>>& children) const { return false; }
 
 
 	//// layout update ////
@@ -94,17 +99,23 @@ protected:
 	void UpdateRegionOnParent() { if (HasParent()) { GetParent()->OnChildRegionUpdate(*this); } }
 protected:
 	static const Rect UpdateChildRegion(WndObject& child, Size parent_size) { return child.UpdateRegionOnParent(parent_size); }
+	static const Size GetChildParentSizeDependency(const WndObject& child, Size parent_size) { return child.GetParentSizeDependency(parent_size); }
 	static void SetChildRegionStyle(WndObject& child, Rect child_region, Size client_size) { child.SetRegionStyle(child_region, client_size); }
 	static void SetChildRegion(WndObject& child, Rect region_on_parent) { child.wnd->SetRegionOnParent(region_on_parent); }
 	static const Rect GetChildRegion(WndObject& child) { return child.GetRegionOnParent(); }
 private:
 	virtual bool MayRegionOnParentChange() { return false; }
 	virtual void ChildRegionMayChange(WndObject& child) {}
+	// Called on a worker thread before UpdateLayout() when parallel reflow is enabled, for heavy calculation 
+	//   like text layout. It must only touch the window's own data, and must not access other windows.
+	virtual void PrepareLayout() {}
 	virtual void UpdateLayout() { UpdateRegionOnParent(); }
 private:
 	virtual void SetRegionStyle(Rect parent_specified_region, Size parent_size) {}
 	virtual void OnChildRegionUpdate(WndObject& child) {}
 	virtual const Rect UpdateRegionOnParent(Size parent_size) { return region_empty; }
+	// Parent sizes with the same dependency must result in the same region on parent.
+	virtual const Size GetParentSizeDependency(Size parent_size) const { return parent_size; }
 
 
 	//// other window styles ////
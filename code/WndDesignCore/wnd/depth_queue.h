@@ -0,0 +1,72 @@
+#pragma once
+
+#include "wnd_base_interface.h"
+#include "../common/intrusive_list.h"
+
+#include <array>
+#include <intrin.h>
+
+
+BEGIN_NAMESPACE(WndDesign)
+
+
+// 64-bit bit scans, composed of two 32-bit scans on x86 where the 64-bit intrinsics are not available.
+inline bool BitScanReverse64(unsigned long& index, uint64 mask) {
+#ifdef _WIN64
+	return _BitScanReverse64(&index, mask);
+#else
+	if (_BitScanReverse(&index, static_cast<unsigned long>(mask >> 32))) { index += 32; return true; }
+	return _BitScanReverse(&index, static_cast<unsigned long>(mask));
+#endif
+}
+
+inline bool BitScanForward64(unsigned long& index, uint64 mask) {
+#ifdef _WIN64
+	return _BitScanForward64(&index, mask);
+#else
+	if (_BitScanForward(&index, static_cast<unsigned long>(mask))) { return true; }
+	if (_BitScanForward(&index, static_cast<unsigned long>(mask >> 32))) { index += 32; return true; }
+	return false;
+#endif
+}
+
+
+// Windows bucketed by depth, with an occupancy bitmap to find the next non-empty depth by bit scan.
+template<class T>
+class DepthQueue : Uncopyable {
+private:
+	static_assert(max_wnd_depth < 64, "depth bitmap has 64 bits");
+	std::array<intrusive_list<T>, max_wnd_depth + 1> _buckets;
+	uint64 _bitmap = 0;
+
+public:
+	bool IsEmpty() const { return _bitmap == 0; }
+	intrusive_list<T>& GetBucket(uint depth) { return _buckets[depth]; }
+
+	void Add(intrusive_list_node<T>& node, T& item, uint depth) {
+		assert(depth <= max_wnd_depth);
+		_buckets[depth].push_front(node, item);
+		_bitmap |= 1ull << depth;
+	}
+	void Remove(intrusive_list_node<T>& node, uint depth) {
+		assert(depth <= max_wnd_depth);
+		intrusive_list<T>::erase(node);
+		if (_buckets[depth].empty()) { _bitmap &= ~(1ull << depth); }
+	}
+
+	// Returns the deepest non-empty depth not deeper than max_depth, or -1 if none.
+	uint GetDeepest(uint max_depth = max_wnd_depth) const {
+		uint64 bitmap = _bitmap & (~0ull >> (63 - max_depth));
+		unsigned long depth;
+		return BitScanReverse64(depth, bitmap) ? depth : -1;
+	}
+	// Returns the shallowest non-empty depth not shallower than min_depth, or -1 if none.
+	uint GetShallowest(uint min_depth = 0) const {
+		uint64 bitmap = _bitmap & (~0ull << min_depth);
+		unsigned long depth;
+		return BitScanForward64(depth, bitmap) ? depth : -1;
+	}
+};
+
+
+END_NAMESPACE(WndDesign)
\ No newline at end of file
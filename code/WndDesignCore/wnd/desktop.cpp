@@ -5,6 +5,8 @@
 #include "../system/win32_api.h"
 #include "../system/metrics.h"
 
+#include <algorithm>
+
 
 BEGIN_NAMESPACE(WndDesign)
 
@@ -12,7 +14,7 @@ extern ref_ptr<DesktopWndFrame> mouse_tracked_frame;
 
 
 DesktopWndFrame::DesktopWndFrame(WndBase& wnd, WndObject& wnd_object, HANDLE hwnd, Size size) :
-	_wnd(wnd), _wnd_object(wnd_object), _hwnd(hwnd), _resource(_hwnd, size) {
+	_wnd(wnd), _wnd_object(wnd_object), _hwnd(hwnd), _resource(_hwnd, size), _overdraw_map() {
 	// Store the pointer of the attached frame as the user data.
 	Win32::SetWndUserData(_hwnd, this);
 }
@@ -75,9 +77,17 @@ void DesktopWndFrame::UpdateInvalidRegion(FigureQueue& figure_queue) {
 	_wnd.Composite(figure_queue, bounding_region - offset_from_desktop, CompositeEffect{});
 	figure_queue.EndGroup(group_begin);
 
+	if (IsOverdrawHeatmapEnabled()) {
+		if (_overdraw_map == nullptr) { _overdraw_map = std::make_unique<OverdrawMap>(); }
+		_overdraw_map->Resize(_wnd.GetRegionOnParent().size);
+		for (auto& region : regions) { _overdraw_map->Clear(region); }
+	} else {
+		_overdraw_map.reset();
+	}
+
 	Target& target = _resource.GetTarget();
 	for (auto& region : regions) {
-		target.DrawFigureQueue(figure_queue, vector_zero, region);
+		target.DrawFigureQueue(figure_queue, vector_zero, region, _overdraw_map.get());
 	}
 
 	// The invalid region will still be used at present time, and will be cleared after presentation, see below.
@@ -98,8 +108,13 @@ void DesktopWndFrame::RefreshLayer() {
 }
 
 void DesktopWndFrame::OnWndDetach(WndObject& wnd) {
-	if (_capture_wnd == &wnd) { LoseCapture(); }
-	if (_focus_wnd == &wnd) { LoseFocus(); }
+	// The capture or focus window may be the detached window or any of its descendants.
+	auto is_in_subtree = [&](ref_ptr<WndObject> descendant) {
+		for (; descendant != nullptr; descendant = descendant->GetParent()) { if (descendant == &wnd) { return true; } }
+		return false;
+	};
+	if (is_in_subtree(_capture_wnd)) { LoseCapture(); }
+	if (is_in_subtree(_focus_wnd)) { LoseFocus(); }
 }
 
 void DesktopWndFrame::SetCapture(WndObject& wnd, Vector offset) {
@@ -230,6 +245,10 @@ void DesktopObjectImpl::CommitRedrawQueue() {
 	redraw_queue.Commit();
 }
 
+void DesktopObjectImpl::EnableParallelReflow(bool enable) {
+	GetReflowQueue().EnableParallelReflow(enable);
+}
+
 void DesktopObjectImpl::RefreshLayer() {
 	for (DesktopWndFrame& frame : _child_wnds) {
 		frame.RefreshLayer();
@@ -237,10 +256,30 @@ void DesktopObjectImpl::RefreshLayer() {
 	}
 }
 
+const vector<PaintStatisticsEntry> DesktopObjectImpl::QueryPaintStatistics() const {
+	std::map<string, PaintStatisticsEntry> entries;
+	for (const DesktopWndFrame& frame : _child_wnds) { frame._wnd.CollectPaintStatistics(entries); }
+	vector<PaintStatisticsEntry> result; result.reserve(entries.size());
+	for (auto& [class_name, entry] : entries) { result.push_back(std::move(entry)); }
+	std::sort(result.begin(), result.end(), [](const PaintStatisticsEntry& a, const PaintStatisticsEntry& b) {
+		return a.statistics.pixel_count + a.statistics.invalid_area_drawn > b.statistics.pixel_count + b.statistics.invalid_area_drawn;
+	});
+	return result;
+}
+
+void DesktopObjectImpl::ResetPaintStatistics() {
+	for (DesktopWndFrame& frame : _child_wnds) { frame._wnd.ResetPaintStatistics(); }
+}
+
+ref_ptr<const OverdrawMap> DesktopObjectImpl::GetOverdrawHeatmap(WndObject& wnd) const {
+	if (auto frame = GetWndFrame(wnd); frame != nullptr) { return frame->GetOverdrawMap(); }
+	return nullptr;
+}
+
 void DesktopObjectImpl::OnWndDetach(WndObject& wnd) {
-	if (ref_ptr<DesktopWndFrame> frame = GetWndFrame(wnd); frame != nullptr) {
-		frame->OnWndDetach(wnd);
-	}
+	// Walk up from the capture and focus windows of each frame rather than from the detached window, 
+	//   which is cheap when there is no capture or focus window.
+	for (DesktopWndFrame& frame : _child_wnds) { frame.OnWndDetach(wnd); }
 }
 
 void DesktopObjectImpl::SetCapture(WndObject& wnd) {
@@ -313,5 +352,24 @@ void WndBase::ReleaseCapture() { GetDesktop().ReleaseCapture(); }
 void WndBase::SetFocus() { GetDesktop().SetFocus(_object); }
 void WndBase::NotifyDesktopWhenDetached() { GetDesktop().OnWndDetach(_object); }
 
+ref_ptr<OverdrawMap> WndBase::GetOverdrawMap(Vector& offset_to_frame, Rect& visible_region) const {
+	if (!IsOverdrawHeatmapEnabled() || _depth == -1) { return nullptr; }
+	// Walk up to the desktop window, clipping my display region with ancestors'. point_on_wnd = point_on_myself + offset
+	ref_ptr<const WndBase> wnd = this; Vector offset = vector_zero; Rect region = GetDisplayRegion();
+	for (; wnd->_depth > 1; wnd = wnd->_parent) {
+		offset -= wnd->OffsetFromParent();
+		region = region.Intersect(wnd->_parent->GetDisplayRegion() - offset);
+	}
+	// The frame is the non-client region of the desktop window.
+	offset_to_frame = offset - wnd->_display_offset;
+	visible_region = region + offset_to_frame;
+	return GetDesktop().GetChildFrame(wnd->_object).GetOverdrawMap();
+}
+
+
+WNDDESIGNCORE_API const vector<PaintStatisticsEntry> QueryPaintStatistics() { return GetDesktop().QueryPaintStatistics(); }
+WNDDESIGNCORE_API void ResetPaintStatistics() { GetDesktop().ResetPaintStatistics(); }
+WNDDESIGNCORE_API ref_ptr<const OverdrawMap> GetOverdrawHeatmap(WndObject& wnd) { return GetDesktop().GetOverdrawHeatmap(wnd); }
+
 
 END_NAMESPACE(WndDesign)
\ No newline at end of file
@@ -4,10 +4,13 @@
 #include "DesktopObject.h"
 #include "../system/directx/d2d_api_window.h"
 
+#include <list>
+
 
 BEGIN_NAMESPACE(WndDesign)
 
 using std::pair;
+using std::list;
 
 
 class DesktopWndFrame : public Uncopyable {
@@ -32,7 +35,7 @@ public:
 
 private:
 	friend class RedrawQueue;
-	list_iterator<ref_ptr<WndBase>> _redraw_queue_index;
+	intrusive_list_node<DesktopWndFrame> _redraw_queue_index;
 private:
 	void JoinRedrawQueue();
 	void LeaveRedrawQueue();
@@ -46,6 +49,12 @@ public:
 	void Present();
 	void RefreshLayer();
 
+private:
+	unique_ptr<OverdrawMap> _overdraw_map;
+public:
+	ref_ptr<const OverdrawMap> GetOverdrawMap() const { return _overdraw_map.get(); }
+	ref_ptr<OverdrawMap> GetOverdrawMap() { return _overdraw_map.get(); }
+
 private:
 	Point _capture_wnd_offset_from_desktop;
 	ref_ptr<WndObject> _capture_wnd = nullptr;
@@ -93,8 +102,14 @@ public:
 public:
 	virtual void CommitReflowQueue() override;
 	virtual void CommitRedrawQueue() override;
+	virtual void EnableParallelReflow(bool enable) override;
 	void RefreshLayer();
 
+public:
+	const vector<PaintStatisticsEntry> QueryPaintStatistics() const;
+	void ResetPaintStatistics();
+	ref_ptr<const OverdrawMap> GetOverdrawHeatmap(WndObject& wnd) const;
+
 public:
 	void OnWndDetach(WndObject& wnd);
 	void SetCapture(WndObject& wnd);
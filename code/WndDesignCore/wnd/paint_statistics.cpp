@@ -0,0 +1,121 @@
+#include "paint_statistics.h"
+
+#include <fstream>
+
+
+BEGIN_NAMESPACE(WndDesign)
+
+BEGIN_NAMESPACE(Anonymous)
+
+bool paint_statistics_enabled = false;
+bool overdraw_heatmap_enabled = false;
+uint current_frame = 0;
+
+END_NAMESPACE(Anonymous)
+
+
+void PaintStatistics::RecordFigures(uint count) {
+	if (_last_frame != current_frame) {
+		_last_frame = current_frame;
+		frame_count++;
+		figure_count_last_frame = 0;
+	}
+	figure_count += count;
+	figure_count_last_frame += count;
+}
+
+void PaintStatistics::Accumulate(const PaintStatistics& statistics) {
+	paint_count += statistics.paint_count;
+	composite_count += statistics.composite_count;
+	frame_count += statistics.frame_count;
+	figure_count += statistics.figure_count;
+	figure_count_last_frame += statistics.figure_count_last_frame;
+	tile_count += statistics.tile_count;
+	pixel_count += statistics.pixel_count;
+	invalid_area_requested += statistics.invalid_area_requested;
+	invalid_area_drawn += statistics.invalid_area_drawn;
+}
+
+
+WNDDESIGNCORE_API void EnablePaintStatistics(bool enable) { paint_statistics_enabled = enable; }
+WNDDESIGNCORE_API bool IsPaintStatisticsEnabled() { return paint_statistics_enabled; }
+
+void BeginPaintStatisticsFrame() { current_frame++; }
+
+
+void OverdrawMap::Resize(Size size) {
+	if (_size == size) { return; }
+	_size = size;
+	_counts.assign((size_t)size.width * size.height, 0);
+	_frames.assign((size_t)size.width * size.height, 0);
+}
+
+void OverdrawMap::Clear(Rect region) {
+	region = region.Intersect(Rect(point_zero, _size));
+	for (int y = region.top(); y < region.bottom(); ++y) {
+		size_t row = (size_t)y * _size.width;
+		for (size_t i = row + region.left(); i < row + region.right(); ++i) {
+			if (_frames[i] != current_frame) { _frames[i] = current_frame; _counts[i] = 0; }
+		}
+	}
+}
+
+void OverdrawMap::Accumulate(Rect region) {
+	region = region.Intersect(Rect(point_zero, _size));
+	for (int y = region.top(); y < region.bottom(); ++y) {
+		size_t row = (size_t)y * _size.width;
+		for (size_t i = row + region.left(); i < row + region.right(); ++i) {
+			if (_frames[i] != current_frame) { _frames[i] = current_frame; _counts[i] = 0; }
+			if (_counts[i] != (ushort)-1) { _counts[i]++; }
+		}
+	}
+}
+
+uint OverdrawMap::GetCount(Point point) const {
+	if (!Rect(point_zero, _size).Contains(point)) { return 0; }
+	return _counts[(size_t)point.y * _size.width + point.x];
+}
+
+uint OverdrawMap::GetMaxCount() const {
+	ushort max_count = 0;
+	for (auto count : _counts) { if (count > max_count) { max_count = count; } }
+	return max_count;
+}
+
+const vector<Color> OverdrawMap::Render() const {
+	static const Color palette[] = {
+		color_transparent,
+		Color(ColorSet::Blue, 0x7F),
+		Color(ColorSet::Green, 0x7F),
+		Color(ColorSet::Yellow, 0x9F),
+		Color(ColorSet::Red, 0xBF),
+	};
+	constexpr uint palette_size = sizeof(palette) / sizeof(Color);
+	vector<Color> pixels; pixels.reserve(_counts.size());
+	for (auto count : _counts) { pixels.push_back(palette[min<uint>(count, palette_size - 1)]); }
+	return pixels;
+}
+
+bool OverdrawMap::SaveAsBitmapFile(const wstring& file_name) const {
+	if (_size.IsEmpty()) { return false; }
+	std::ofstream file(file_name, std::ios::binary);
+	if (!file) { return false; }
+	auto write = [&](uint value, uint bytes) { file.write(reinterpret_cast<const char*>(&value), bytes); };
+	uint image_size = _size.Area() * sizeof(Color);
+	// BITMAPFILEHEADER
+	write(0x4D42, 2); write(14 + 40 + image_size, 4); write(0, 4); write(14 + 40, 4);
+	// BITMAPINFOHEADER, top-down 32bpp BGRA
+	write(40, 4); write(_size.width, 4); write((uint)-(int)_size.height, 4); write(1, 2); write(32, 2);
+	write(0, 4); write(image_size, 4); write(0, 4); write(0, 4); write(0, 4); write(0, 4);
+	static_assert(sizeof(Color) == 4);  // Color is stored as BGRA.
+	vector<Color> pixels = Render();
+	file.write(reinterpret_cast<const char*>(pixels.data()), image_size);
+	return file.good();
+}
+
+
+WNDDESIGNCORE_API void EnableOverdrawHeatmap(bool enable) { overdraw_heatmap_enabled = enable; }
+WNDDESIGNCORE_API bool IsOverdrawHeatmapEnabled() { return overdraw_heatmap_enabled; }
+
+
+END_NAMESPACE(WndDesign)
\ No newline at end of file
@@ -0,0 +1,93 @@
+#pragma once
+
+#include "../geometry/geometry.h"
+#include "../figure/color.h"
+
+#include <vector>
+#include <string>
+
+
+BEGIN_NAMESPACE(WndDesign)
+
+using std::vector;
+using std::string;
+using std::wstring;
+
+class WndObject;
+
+
+// Paint counters of a single window, only collected when paint statistics is enabled.
+struct PaintStatistics {
+	uint paint_count = 0;               // times OnPaint() is called
+	uint composite_count = 0;           // times the window is composited by its parent
+	uint frame_count = 0;               // frames in which the window has emitted figures
+	uint figure_count = 0;              // figures emitted in total
+	uint figure_count_last_frame = 0;   // figures emitted in the last painted frame
+	uint tile_count = 0;                // layer tiles written
+	uint64 pixel_count = 0;             // pixels covered by the window's figures replayed into layer tiles or parent's target
+	uint64 invalid_area_requested = 0;  // area passed to Invalidate() or invalidated by child windows
+	uint64 invalid_area_drawn = 0;      // area actually repainted
+
+	// for internal use
+	uint _last_frame = 0;
+
+	void RecordFigures(uint count);
+	void Accumulate(const PaintStatistics& statistics);
+};
+
+
+// Paint counters aggregated by window class.
+struct PaintStatisticsEntry {
+	string class_name;
+	uint wnd_count = 0;
+	PaintStatistics statistics;
+};
+
+
+WNDDESIGNCORE_API void EnablePaintStatistics(bool enable);
+WNDDESIGNCORE_API bool IsPaintStatisticsEnabled();
+
+// Called by redraw queue at the beginning of each frame, when paint statistics or overdraw heatmap is enabled.
+void BeginPaintStatisticsFrame();
+
+// Walk all windows attached to desktop and aggregate their counters by class, sorted by painted pixels.
+WNDDESIGNCORE_API const vector<PaintStatisticsEntry> QueryPaintStatistics();  // defined in desktop.cpp
+WNDDESIGNCORE_API void ResetPaintStatistics();                                // the same
+
+
+// Per-pixel write counts of a desktop window, accumulated when figures are replayed to the window target
+//   or to the layers of windows inside it.
+// Each repainted pixel holds the number of writes in the last frame it was repainted.
+class OverdrawMap {
+private:
+	Size _size;
+	vector<ushort> _counts;
+	vector<uint> _frames;  // the frame in which each count is written, counts of earlier frames are reset when written
+
+public:
+	OverdrawMap() : _size(size_empty), _counts(), _frames() {}
+
+public:
+	const Size GetSize() const { return _size; }
+	void Resize(Size size);
+	// Reset counts not yet written in this frame, layers are drawn before the desktop window clears its invalid region.
+	void Clear(Rect region);
+	void Accumulate(Rect region);
+	uint GetCount(Point point) const;
+	uint GetMaxCount() const;
+
+	// Map counts to colors: transparent for 0, blue for 1, green for 2, yellow for 3, red for 4 and above.
+	const vector<Color> Render() const;
+	// Save the rendered heatmap as a 32-bit bmp file.
+	bool SaveAsBitmapFile(const wstring& file_name) const;
+};
+
+
+WNDDESIGNCORE_API void EnableOverdrawHeatmap(bool enable);
+WNDDESIGNCORE_API bool IsOverdrawHeatmapEnabled();
+
+// Returns the overdraw map of the desktop window that contains wnd, or nullptr if none.
+WNDDESIGNCORE_API ref_ptr<const OverdrawMap> GetOverdrawHeatmap(WndObject& wnd);  // defined in desktop.cpp
+
+
+END_NAMESPACE(WndDesign)
\ No newline at end of file
@@ -7,54 +7,48 @@
 BEGIN_NAMESPACE(WndDesign)
 
 
-RedrawQueue::RedrawQueue() : _queue(max_wnd_depth + 1), _next_depth(0), _has_invalid_frame(false) {}
+RedrawQueue::RedrawQueue() : _queue(), _frame_queue(), _has_invalid_frame(false) {}
 
 void RedrawQueue::AddWnd(WndBase& wnd) {
 	uint depth = wnd.GetDepth(); 
 	assert(0 < depth && depth <= max_wnd_depth);
-	wnd._redraw_queue_index = _queue[depth].insert(_queue[depth].begin(), &wnd);
-	if (depth > _next_depth) { _next_depth = depth; }
+	_queue.Add(wnd._redraw_queue_index, wnd, depth);
 }
 
 void RedrawQueue::RemoveWnd(WndBase& wnd) {
 	uint depth = wnd.GetDepth();
 	assert(0 < depth && depth <= max_wnd_depth);
-	_queue[depth].erase(wnd._redraw_queue_index);
-	wnd._redraw_queue_index = {};
+	_queue.Remove(wnd._redraw_queue_index, depth);
 }
 
 void RedrawQueue::AddDesktopWnd(DesktopWndFrame& frame) {
-	frame._redraw_queue_index = _queue[0].insert(_queue[0].begin(), reinterpret_cast<ref_ptr<WndBase>>(&frame));
+	_frame_queue.push_front(frame._redraw_queue_index, frame);
 	_has_invalid_frame = true;
 }
 
 void RedrawQueue::RemoveDesktopWnd(DesktopWndFrame& frame) {
-	_queue[0].erase(frame._redraw_queue_index);
-	frame._redraw_queue_index = {};
+	_frame_queue.erase(frame._redraw_queue_index);
 }
 
 void RedrawQueue::Commit() {
-	if (_next_depth == 0 && !_has_invalid_frame) { return; }
+	if (_queue.IsEmpty() && !_has_invalid_frame) { return; }
 
 	BeginDraw();
+	if (IsPaintStatisticsEnabled() || IsOverdrawHeatmapEnabled()) { BeginPaintStatisticsFrame(); }
 
-	// Update all windows.
-	uint next_depth = _next_depth;
-	_next_depth = 0;
-	while (next_depth > 0) {
-		while (!_queue[next_depth].empty()) {
-			WndBase& wnd = *_queue[next_depth].front();
+	// Update all windows from back to front, parent windows invalidated are shallower and will be visited later.
+	for (uint depth = _queue.GetDeepest(); depth != -1 && depth > 0; depth = _queue.GetDeepest(depth - 1)) {
+		auto& bucket = _queue.GetBucket(depth);
+		while (!bucket.empty()) {
+			WndBase& wnd = bucket.front();
 			wnd.UpdateInvalidRegion(figure_queue); figure_queue.Clear();
 			wnd.LeaveRedrawQueue();
 		}
-		next_depth--;
 	}
 
 	// Update desktop windows, whose depth is 0.
-	assert(next_depth == 0);
 	_has_invalid_frame = false;
-	for (auto wnd : _queue[next_depth]) {
-		DesktopWndFrame& frame = *reinterpret_cast<DesktopWndFrame*>(wnd);
+	for (DesktopWndFrame& frame : _frame_queue) {
 		frame.UpdateInvalidRegion(figure_queue); figure_queue.Clear();
 	}
 
@@ -69,8 +63,8 @@ void RedrawQueue::Commit() {
 	}
 
 	// Present and remove desktop windows.
-	while (!_queue[next_depth].empty()) {
-		DesktopWndFrame& frame = *reinterpret_cast<DesktopWndFrame*>(_queue[next_depth].front());
+	while (!_frame_queue.empty()) {
+		DesktopWndFrame& frame = _frame_queue.front();
 		frame.Present();
 		RemoveDesktopWnd(frame);
 	}
@@ -1,25 +1,19 @@
 #pragma once
 
-#include "../common/core.h"
+#include "depth_queue.h"
 #include "../layer/figure_queue.h"
 
-#include <vector>
-#include <list>
-
 
 BEGIN_NAMESPACE(WndDesign)
 
-using std::vector;
-using std::list;
-
 class WndBase;
 class DesktopWndFrame;
 
 
 class RedrawQueue {
 private:
-	vector<list<ref_ptr<WndBase>>> _queue;
-	uint _next_depth;
+	DepthQueue<WndBase> _queue;
+	intrusive_list<DesktopWndFrame> _frame_queue;
 	bool _has_invalid_frame;
 
 private:
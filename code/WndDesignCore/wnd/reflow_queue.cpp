@@ -1,46 +1,70 @@
 #include "reflow_queue.h"
 #include "wnd_base.h"
+#include "../system/worker_pool.h"
 
 
 BEGIN_NAMESPACE(WndDesign)
 
 
-ReflowQueue::ReflowQueue() : _queue(max_wnd_depth + 1), _next_depth(0) {}
+ReflowQueue::ReflowQueue() : _queue(), _worker_pool() {}
+
+ReflowQueue::~ReflowQueue() {}
 
 void ReflowQueue::AddWnd(WndBase& wnd) {
 	uint depth = wnd.GetDepth();
 	assert(0 < depth && depth <= max_wnd_depth);
-	wnd._reflow_queue_index = _queue[depth].insert(_queue[depth].begin(), &wnd);
-	if (depth > _next_depth) { _next_depth = depth; }
+	_queue.Add(wnd._reflow_queue_index, wnd, depth);
 }
 
 void ReflowQueue::RemoveWnd(WndBase& wnd) {
 	uint depth = wnd.GetDepth();
 	assert(0 < depth && depth <= max_wnd_depth);
-	_queue[depth].erase(wnd._reflow_queue_index);
-	wnd._reflow_queue_index = {};
+	_queue.Remove(wnd._reflow_queue_index, depth);
 }
 
 void ReflowQueue::Commit() {
-	if (_next_depth == 0) { return; }
+	if (_queue.IsEmpty()) { return; }
 
 	// Traverse for the first time from back to front, notify parent window if region may change.
-	for (uint next_depth = _next_depth; next_depth > 0; next_depth--) {
-		for (auto wnd : _queue[next_depth]) {
-			wnd->MayRegionOnParentChange();
+	// Parent windows joining the queue are shallower, and will be visited later.
+	for (uint depth = _queue.GetDeepest(); depth != -1 && depth > 0; depth = _queue.GetDeepest(depth - 1)) {
+		for (WndBase& wnd : _queue.GetBucket(depth)) {
+			wnd.MayRegionOnParentChange();
 		}
 	}
 
+	// Each window only touches its own data when preparing layout, so windows can be measured concurrently 
+	//   before being updated one by one. If a window's size constraint is later changed by its parent, 
+	//   the prepared layout is simply recalculated.
+	if (_worker_pool != nullptr) { PrepareLayouts(); }
+
 	// Traverse and update for the second time.
-	for (uint next_depth = 1; next_depth <= _next_depth; next_depth++) {
-		while (!_queue[next_depth].empty()) {
-			WndBase& wnd = *_queue[next_depth].front();
+	// Windows joining the queue at a shallower depth are left for the next commit.
+	for (uint depth = _queue.GetShallowest(1); depth != -1; depth = _queue.GetShallowest(depth)) {
+		auto& bucket = _queue.GetBucket(depth);
+		while (!bucket.empty()) {
+			WndBase& wnd = bucket.front();
 			wnd.UpdateInvalidLayout();
 			wnd.LeaveReflowQueue();
 		}
 	}
+}
 
-	_next_depth = 0;
+void ReflowQueue::PrepareLayouts() {
+	vector<ref_ptr<WndBase>> wnds;
+	for (uint depth = _queue.GetShallowest(1); depth != -1; depth = depth < max_wnd_depth ? _queue.GetShallowest(depth + 1) : -1) {
+		for (WndBase& wnd : _queue.GetBucket(depth)) { wnds.push_back(&wnd); }
+	}
+	if (wnds.size() < 2) { return; }
+	_worker_pool->ParallelFor((uint)wnds.size(), [&](uint index) { wnds[index]->PrepareLayout(); });
+}
+
+void ReflowQueue::EnableParallelReflow(bool enable) {
+	if (enable) {
+		if (_worker_pool == nullptr) { _worker_pool = std::make_unique<WorkerPool>(); }
+	} else {
+		_worker_pool.reset();
+	}
 }
 
 ReflowQueue& ReflowQueue::Get() {
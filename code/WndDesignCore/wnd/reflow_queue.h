@@ -1,26 +1,32 @@
 #pragma once
 
-#include "../common/core.h"
+#include "depth_queue.h"
 
-#include <vector>
-#include <list>
+#include <memory>
 
 
 BEGIN_NAMESPACE(WndDesign)
 
-using std::vector;
-using std::list;
-
 class WndBase;
+class WorkerPool;
 
 
 class ReflowQueue {
 private:
-	vector<list<ref_ptr<WndBase>>> _queue;
-	uint _next_depth;
+	DepthQueue<WndBase> _queue;
 
 private:
 	ReflowQueue();
+	~ReflowQueue();
+
+	//// parallel reflow ////
+private:
+	std::unique_ptr<WorkerPool> _worker_pool;
+private:
+	/* prepare the layout of all windows in the queue on worker threads */
+	void PrepareLayouts();
+public:
+	void EnableParallelReflow(bool enable);
 
 public:
 	void AddWnd(WndBase& wnd);
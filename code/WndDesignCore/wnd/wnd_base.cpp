@@ -5,9 +5,19 @@
 #include "../layer/layer.h"
 #include "../geometry/geometry_helper.h"
 
+#include <typeinfo>
+#include <algorithm>
+#include <unordered_map>
+
 
 BEGIN_NAMESPACE(WndDesign)
 
+BEGIN_NAMESPACE(Anonymous)
+
+std::unordered_map<ref_ptr<const WndBase>, PaintStatistics> paint_statistics_table;
+
+END_NAMESPACE(Anonymous)
+
 
 WNDDESIGNCORE_API unique_ptr<IWndBase> IWndBase::Create(WndObject& object) {
 	return std::make_unique<WndBase>(object);
@@ -17,9 +27,11 @@ WNDDESIGNCORE_API unique_ptr<IWndBase> IWndBase::Create(WndObject& object) {
 WndBase::WndBase(WndObject& object) :
 	_object(object),
 	_parent(nullptr),
-	_index_on_parent(),
+	_prev_sibling(nullptr),
+	_next_sibling(nullptr),
 	_depth(-1),
-	_child_wnds(),
+	_is_layout_invalid(true),
+	_first_child(nullptr),
 
 	_accessible_region(region_empty),
 	_display_offset(vector_zero),
@@ -34,20 +46,22 @@ WndBase::WndBase(WndObject& object) :
 }
 
 WndBase::~WndBase() {
-	ClearChild();
 	LeaveReflowQueue();
 	LeaveRedrawQueue();
 	DetachFromParent();
+	ClearChild();
+	if (!paint_statistics_table.empty()) { paint_statistics_table.erase(this); }
 }
 
-void WndBase::SetParent(WndBase& parent, list<ref_ptr<WndBase>>::iterator index_on_parent) {
+void WndBase::SetParent(WndBase& parent) {
 	DetachFromParent();
-	_parent = &parent; _index_on_parent = index_on_parent;
+	_parent = &parent;
 	_region_on_parent = region_empty;
+	_is_layout_invalid = true;
 }
 
 void WndBase::ClearParent() {
-	_parent = nullptr; _index_on_parent = {};
+	_parent = nullptr; _prev_sibling = _next_sibling = nullptr;
 }
 
 void WndBase::DetachFromParent() {
@@ -69,33 +83,41 @@ void WndBase::SetDepth(uint depth) {
 		_depth = depth;
 
 		// Set depth for child windows.
-		for (auto child : _child_wnds) { child->SetDepth(GetChildDepth()); }
+		ForEachChild([&](WndBase& child) { child.SetDepth(GetChildDepth()); });
 	}
 
+	// Only windows with pending layout or invalid region join the queues, so that moving a subtree 
+	//   doesn't update the layout of all its windows.
 	if (IsDepthValid()) {
 		if (!_invalid_region.IsEmpty()) { JoinRedrawQueue(); }
-		JoinReflowQueue();
+		if (_is_layout_invalid) { JoinReflowQueue(); }
 	}
 }
 
 void WndBase::ClearChild() {
-	while (!_child_wnds.empty()) {
-		RemoveChild(*_child_wnds.front());
+	// Called after detached from parent window, when the desktop has been notified for the whole subtree.
+	while (_first_child != nullptr) {
+		ref_ptr<WndBase> child = _first_child;
+		_first_child = child->_next_sibling;
+		child->ClearParent();
 	}
 }
 
 void WndBase::AddChild(IWndBase& child_wnd) {
 	WndBase& child = static_cast<WndBase&>(child_wnd);
 	assert(child._parent != this);
-	_child_wnds.push_front(&child);
-	child.SetParent(*this, _child_wnds.begin());
+	child.SetParent(*this);
+	child._next_sibling = _first_child;
+	if (_first_child != nullptr) { _first_child->_prev_sibling = &child; }
+	_first_child = &child;
 	child.SetDepth(GetChildDepth());
 }
 
 void WndBase::RemoveChild(IWndBase& child_wnd) {
 	WndBase& child = static_cast<WndBase&>(child_wnd);
 	assert(child._parent == this);
-	_child_wnds.erase(child._index_on_parent);
+	if (child._prev_sibling != nullptr) { child._prev_sibling->_next_sibling = child._next_sibling; } else { _first_child = child._next_sibling; }
+	if (child._next_sibling != nullptr) { child._next_sibling->_prev_sibling = child._prev_sibling; }
 	child.ClearParent();
 	child.NotifyDesktopWhenDetached();
 	// Child's depth will be reset at UpdateInvalidRegion() or UpdateLayout().
@@ -133,8 +155,12 @@ const Vector WndBase::SetDisplayOffset(Vector display_offset) {
 }
 
 void WndBase::SetRegionOnParent(Rect region_on_parent) {
+	if (_region_on_parent.size == region_on_parent.size) {
+		// Visible region is updated here, because parent window may skip me when its cached region changes.
+		if (_region_on_parent.point != region_on_parent.point) { _region_on_parent.point = region_on_parent.point; ResetVisibleRegion(); }
+		return;
+	}
 	_region_on_parent.point = region_on_parent.point;
-	if (_region_on_parent.size == region_on_parent.size) { return; }
 	_region_on_parent.size = region_on_parent.size;
 	UpdateDisplayOffset(GetDisplayOffset());
 	SetAccessibleRegion(GetAccessibleRegion().Union(GetDisplayRegion()));
@@ -157,16 +183,34 @@ void WndBase::SetVisibleRegion(Rect parent_cached_region) {
 	_invalid_region.Union(invalid_region);
 	JoinRedrawQueue();
 
+	Rect old_cached_region = _cached_region;
 	_cached_region = cached_region;
 
 	// For object's lazy loading.
 	_object.OnCachedRegionChange(_accessible_region, _cached_region);
 
-	// If cached region changed, set visible region for child windows.
-	for (auto child : _child_wnds) { child->SetVisibleRegion(GetCachedRegion()); }
+	// If cached region changed, set visible region for child windows. Child windows that have no cached region 
+	//   and are outside the new cached region will still have empty visible region, so they are skipped. 
+	//   (A child window moved later will reset its visible region itself.)
+	auto set_child_visible_region = [&](WndBase& child) {
+		if (child._cached_region.IsEmpty() && child._region_on_parent.Intersect(_cached_region).IsEmpty()) { return; }
+		child.SetVisibleRegion(GetCachedRegion());
+	};
+	// If the children are indexed, only the ones intersecting the old or new cached region are visited, 
+	//   the visible region of the others is empty before and after.
+	vector<ref_ptr<WndObject>> children;
+	if (!old_cached_region.IsEmpty() && !_object.QueryChildren(old_cached_region, children) ||
+		!_cached_region.IsEmpty() && !_object.QueryChildren(_cached_region, children)) {
+		ForEachChild(set_child_visible_region);
+		return;
+	}
+	std::sort(children.begin(), children.end());
+	children.erase(std::unique(children.begin(), children.end()), children.end());
+	for (auto child : children) { set_child_visible_region(static_cast<WndBase&>(*child->wnd)); }
 }
 
 void WndBase::JoinReflowQueue() {
+	_is_layout_invalid = true;
 	if (IsDepthValid() && !_reflow_queue_index.valid()) {
 		GetReflowQueue().AddWnd(*this);
 	}
@@ -184,9 +228,15 @@ void WndBase::MayRegionOnParentChange() {
 	}
 }
 
+void WndBase::PrepareLayout() {
+	if (!HasParent()) { return; }
+	_object.PrepareLayout();
+}
+
 void WndBase::UpdateInvalidLayout() {
 	// If has no parent window, clear depth and skip.
 	if (!HasParent()) { SetDepth(-1); return; }
+	_is_layout_invalid = false;
 	_object.UpdateLayout();
 }
 
@@ -202,7 +252,7 @@ void WndBase::RefreshLayer() {
 		_layer.reset();
 		AllocateLayer();
 	}
-	for (auto child : _child_wnds) { child->RefreshLayer(); }
+	ForEachChild([](WndBase& child) { child.RefreshLayer(); });
 }
 
 void WndBase::JoinRedrawQueue() {
@@ -223,6 +273,9 @@ void WndBase::InvalidateChild(WndBase& child, Region& child_invalid_region) {
 	if (!child_invalid_region.IsEmpty()) {
 		_invalid_region.Union(child_invalid_region);
 		JoinRedrawQueue();
+		if (auto statistics = GetPaintStatistics(); statistics != nullptr) {
+			for (auto& region : child_invalid_region.GetRect().second) { statistics->invalid_area_requested += region.Area(); }
+		}
 	}
 }
 
@@ -235,6 +288,9 @@ void WndBase::Invalidate(Rect region) {
 	if (!region.IsEmpty()) {
 		_invalid_region.Union(region);
 		JoinRedrawQueue();
+		if (auto statistics = GetPaintStatistics(); statistics != nullptr) {
+			statistics->invalid_area_requested += region.Area();
+		}
 	}
 }
 
@@ -249,15 +305,32 @@ void WndBase::UpdateInvalidRegion(FigureQueue& figure_queue) {
 		_invalid_region.Intersect(_layer->GetCachedTileRegion());
 		if (_invalid_region.IsEmpty()) { return; }
 
+		ref_ptr<PaintStatistics> statistics = GetPaintStatistics();
 		auto [bounding_region, regions] = _invalid_region.GetRect();
 		uint group_index = figure_queue.BeginGroup(vector_zero, bounding_region);
 		figure_queue.Append(point_zero, new ClearCommand());
+		size_t figure_count = figure_queue.GetFigures().size();
+		figure_queue.SetPaintStatistics(statistics);
 		_object.OnPaint(figure_queue, _accessible_region, bounding_region);
+		figure_queue.SetPaintStatistics(nullptr);
+		figure_count = figure_queue.GetFigures().size() - figure_count;
 		figure_queue.EndGroup(group_index);
 
+		Vector offset_to_frame = vector_zero; Rect visible_region = region_empty;
+		ref_ptr<OverdrawMap> overdraw_map = GetOverdrawMap(offset_to_frame, visible_region);
+
 	#pragma message(Remark"Or just draw the bounding region once ?")
+		uint tile_count = 0;
 		for (auto& region : regions) {
-			_layer->DrawFigureQueue(figure_queue, region);
+			tile_count += _layer->DrawFigureQueue(figure_queue, region, overdraw_map, offset_to_frame, visible_region);
+		}
+
+		if (statistics != nullptr) {
+			statistics->paint_count++;
+			statistics->RecordFigures(static_cast<uint>(figure_count));
+			statistics->tile_count += tile_count;
+			uint64 area = 0; for (auto& region : regions) { area += region.Area(); }
+			statistics->invalid_area_drawn += area;
 		}
 	}
 
@@ -275,6 +348,9 @@ void WndBase::Composite(FigureQueue& figure_queue, Rect parent_invalid_region, C
 	Vector display_region_offset = _region_on_parent.point - point_zero;
 	Rect invalid_region = parent_invalid_region - display_region_offset;
 	uint group_begin = figure_queue.BeginGroup(display_region_offset, invalid_region, composite_effect);
+	ref_ptr<PaintStatistics> statistics = GetPaintStatistics();
+	// The layer figure is not attributed, the pixels of the layer have been counted when drawn to tiles.
+	ref_ptr<PaintStatistics> parent_statistics = figure_queue.SetPaintStatistics(HasLayer() ? nullptr : statistics);
 	{
 		// Composite client region.
 		Vector client_offset = vector_zero - _display_offset;
@@ -282,13 +358,41 @@ void WndBase::Composite(FigureQueue& figure_queue, Rect parent_invalid_region, C
 		if (HasLayer()) {
 			figure_queue.Append(invalid_region.point, new LayerFigure(*_layer, invalid_client_region));
 		} else {
+			size_t figure_count = figure_queue.GetFigures().size();
 			figure_queue.PushOffset(client_offset);
 			_object.OnPaint(figure_queue, _accessible_region, invalid_client_region);
 			figure_queue.PopOffset(client_offset);
+			if (statistics != nullptr) {
+				statistics->paint_count++;
+				statistics->RecordFigures(static_cast<uint>(figure_queue.GetFigures().size() - figure_count));
+				statistics->invalid_area_drawn += invalid_client_region.Intersect(_accessible_region).Area();
+			}
 		}
 	}
+	figure_queue.SetPaintStatistics(statistics);
 	_object.OnComposite(figure_queue, _region_on_parent.size, invalid_region);
+	figure_queue.SetPaintStatistics(parent_statistics);
 	figure_queue.EndGroup(group_begin);
+	if (statistics != nullptr) { statistics->composite_count++; }
+}
+
+ref_ptr<PaintStatistics> WndBase::GetPaintStatistics() const {
+	if (!IsPaintStatisticsEnabled()) { return nullptr; }
+	return &paint_statistics_table[this];
+}
+
+void WndBase::CollectPaintStatistics(std::map<string, PaintStatisticsEntry>& entries) const {
+	string class_name = typeid(_object).name();
+	PaintStatisticsEntry& entry = entries[class_name];
+	if (entry.class_name.empty()) { entry.class_name = class_name; }
+	entry.wnd_count++;
+	if (auto it = paint_statistics_table.find(this); it != paint_statistics_table.end()) { entry.statistics.Accumulate(it->second); }
+	ForEachChild([&](const WndBase& child) { child.CollectPaintStatistics(entries); });
+}
+
+void WndBase::ResetPaintStatistics() {
+	paint_statistics_table.erase(this);
+	ForEachChild([](WndBase& child) { child.ResetPaintStatistics(); });
 }
 
 
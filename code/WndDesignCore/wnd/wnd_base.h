@@ -1,19 +1,20 @@
 #pragma once
 
 #include "wnd_base_interface.h"
-#include "../common/list_iterator.h"
+#include "../common/intrusive_list.h"
 #include "../geometry/region.h"
+#include "paint_statistics.h"
 
-#include <list>
 #include <memory>
+#include <map>
 
 
 BEGIN_NAMESPACE(WndDesign)
 
-using std::list;
 using std::unique_ptr;
 
 class Layer;
+struct PaintStatistics;
 
 
 class WndBase : public IWndBase, public Uncopyable {
@@ -36,12 +37,13 @@ public:
 	///////////////////////////////////////////////////////////
 private:
 	ref_ptr<WndBase> _parent;
-	list<ref_ptr<WndBase>>::iterator _index_on_parent;
+	ref_ptr<WndBase> _prev_sibling;  // links in the child list of parent window
+	ref_ptr<WndBase> _next_sibling;
 public:
 	bool HasParent() const { return _parent != nullptr; }
 private:
 	/* called by new parent window */
-	void SetParent(WndBase& parent, list<ref_ptr<WndBase>>::iterator index_on_parent);
+	void SetParent(WndBase& parent);
 	/* called by old parent window */
 	void ClearParent();
 	/* called by myself */
@@ -54,6 +56,7 @@ private:
 	//   and for windows who are not descendant of Desktop, depth is -1.
 private:
 	uint _depth;
+	bool _is_layout_invalid;  // kept when leaving reflow queue for invalid depth, and joins the queue again when attached
 private:
 	bool IsDepthValid() const { return _depth != -1; }
 	uint GetChildDepth() const { return _depth == -1 ? -1 : _depth + 1; }
@@ -66,8 +69,12 @@ public:
 	////                   Child Windows                   ////
 	///////////////////////////////////////////////////////////
 private:
-	list<ref_ptr<WndBase>> _child_wnds;
+	ref_ptr<WndBase> _first_child;  // child windows are linked by their sibling pointers, without allocation
 private:
+	template<class Func>
+	void ForEachChild(Func func) const {
+		for (ref_ptr<WndBase> child = _first_child, next = nullptr; child != nullptr; child = next) { next = child->_next_sibling; func(*child); }
+	}
 	void ClearChild();
 public:
 	virtual void AddChild(IWndBase& child_wnd) override;
@@ -103,7 +110,7 @@ private:
 	//// reflow queue ////
 private:
 	friend class ReflowQueue;
-	list_iterator<ref_ptr<WndBase>> _reflow_queue_index;
+	intrusive_list_node<WndBase> _reflow_queue_index;
 private:
 	void JoinReflowQueue();
 	void LeaveReflowQueue();
@@ -113,6 +120,8 @@ private:
 	//// invalid layout ////
 public:
 	void MayRegionOnParentChange();
+	/* called by reflow queue on worker threads */
+	void PrepareLayout();
 	void UpdateInvalidLayout();
 
 
@@ -133,7 +142,7 @@ public:
 	//// redraw queue ////
 private:
 	friend class RedrawQueue;
-	list_iterator<ref_ptr<WndBase>> _redraw_queue_index;
+	intrusive_list_node<WndBase> _redraw_queue_index;
 private:
 	void JoinRedrawQueue();
 	void LeaveRedrawQueue();
@@ -154,6 +163,19 @@ public:
 	virtual void Composite(FigureQueue& figure_queue, Rect parent_invalid_region, CompositeEffect composite_effect) const override;
 
 
+	//// paint statistics ////
+	// Paint statistics are kept in a table outside of the window, which is only filled when enabled.
+private:
+	/* returns nullptr if paint statistics is disabled */
+	ref_ptr<PaintStatistics> GetPaintStatistics() const;
+	/* returns the overdraw map of the desktop window, with the offset and visible region of my client region on it,
+	     or nullptr if overdraw heatmap is disabled */
+	ref_ptr<OverdrawMap> GetOverdrawMap(Vector& offset_to_frame, Rect& visible_region) const;  // defined in desktop.cpp
+public:
+	void CollectPaintStatistics(std::map<string, PaintStatisticsEntry>& entries) const;
+	void ResetPaintStatistics();
+
+
 	////////////////////////////////////////////////////////////
 	////                  Message Handling                  ////
 	////////////////////////////////////////////////////////////